@@ -0,0 +1,572 @@
+// <copyright file="PipelineBenchmark.cpp" company="Delft University of Technology">
+// Copyright (c) Delft University of Technology. All rights reserved.
+// </copyright>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <functional>
+#include <numeric>
+#include <thread>
+#include <vector>
+#include <benchmark/benchmark.h>
+#include "FrameRecorder.h"
+#include "FrameReplay.h"
+#include "LatencyGovernor.h"
+#include "LevelBoard.h"
+#include "LevelHistory.h"
+#include "SyntheticPole.h"
+#include "SegmentKernels.h"
+#include "StreamEngine.h"
+#include "TrackerStages.h"
+#include "WaterLevelTracker.h"
+
+namespace waterleveltracking {
+	/// <summary>
+	/// The frame sizes the benchmarks run at, selected by the first argument
+	/// </summary>
+	static const Size Resolutions[] = { Size(640, 480), Size(1280, 720), Size(1920, 1080) };
+
+	/// <summary>
+	/// Records the latency of every iteration and reports the frames per second and the p50, p99 and maximum latency
+	/// </summary>
+	class LatencyRecorder {
+	public:
+		/// <summary>
+		/// Initializes a new instance of the <see cref="LatencyRecorder"/> class.
+		/// </summary>
+		/// <param name="state">The state of the running benchmark</param>
+		explicit LatencyRecorder(benchmark::State &state) : state(state) {
+			this->latencies.reserve(1 << 16);
+		}
+
+		/// <summary>
+		/// Start timing an iteration
+		/// </summary>
+		void Start() {
+			this->start = std::chrono::steady_clock::now();
+		}
+
+		/// <summary>
+		/// Stop timing an iteration
+		/// </summary>
+		void Stop() {
+			this->latencies.push_back(std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - this->start).count());
+		}
+
+		/// <summary>
+		/// Add the frames per second and the latency percentiles to the counters of the benchmark
+		/// </summary>
+		void Report() {
+			if (this->latencies.empty()) {
+				return;
+			}
+
+			std::sort(this->latencies.begin(), this->latencies.end());
+			size_t last = this->latencies.size() - 1;
+			this->state.counters["frames/s"] = benchmark::Counter((double)this->state.iterations(), benchmark::Counter::kIsRate);
+			this->state.counters["p50_us"] = this->latencies[last / 2];
+			this->state.counters["p99_us"] = this->latencies[(last * 99) / 100];
+			this->state.counters["max_us"] = this->latencies[last];
+		}
+
+	private:
+		/// <summary>
+		/// The state of the running benchmark
+		/// </summary>
+		benchmark::State &state;
+
+		/// <summary>
+		/// The start of the current iteration
+		/// </summary>
+		std::chrono::steady_clock::time_point start;
+
+		/// <summary>
+		/// The latency in microseconds of every iteration
+		/// </summary>
+		std::vector<double> latencies;
+	};
+
+	/// <summary>
+	/// Generate the pole of the benchmark, the arguments are the resolution, the rotation in degrees and the stripes above the water
+	/// </summary>
+	/// <param name="state">The state of the running benchmark</param>
+	/// <returns>The generated pole</returns>
+	static SyntheticPole CreatePole(const benchmark::State &state) {
+		return SyntheticPole(Resolutions[state.range(0)], (double)state.range(1), (int)state.range(2));
+	}
+
+	/// <summary>
+	/// Time the rotation of the grayscale frame
+	/// </summary>
+	static void BM_Rotate(benchmark::State &state) {
+		SyntheticPole pole = CreatePole(state);
+		WaterLevelTracker tracker;
+		Mat gray = TrackerStages::ConvertToGray(tracker, pole.GetFrame()).clone();
+		MarkerProperties source = pole.CreateMarker();
+		Mat rotated;
+		LatencyRecorder recorder(state);
+		for (auto _ : state) {
+			MarkerProperties marker = source;
+			recorder.Start();
+			benchmark::DoNotOptimize(TrackerStages::Rotate(tracker, gray, 360 - pole.GetRotation(), marker, rotated));
+			recorder.Stop();
+		}
+
+		recorder.Report();
+	}
+
+	/// <summary>
+	/// Time cropping the stripe region out of the rotated frame
+	/// </summary>
+	static void BM_Crop(benchmark::State &state) {
+		SyntheticPole pole = CreatePole(state);
+		WaterLevelTracker tracker;
+		MarkerProperties marker = pole.CreateMarker();
+		Mat rotated;
+		int bottom = TrackerStages::Rotate(tracker, TrackerStages::ConvertToGray(tracker, pole.GetFrame()), 360 - pole.GetRotation(), marker, rotated);
+		int stripePixelStart = marker.GetCenter().y + (int)(marker.GetDistanceToStripes() * marker.GetMeterToPixelFactor());
+		LatencyRecorder recorder(state);
+		for (auto _ : state) {
+			recorder.Start();
+			Mat region = rotated;
+			TrackerStages::Crop(region, marker.GetCorners().bottomLeft.x, marker.GetCorners().bottomRight.x, stripePixelStart, bottom);
+			benchmark::DoNotOptimize(region.data);
+			recorder.Stop();
+		}
+
+		recorder.Report();
+	}
+
+	/// <summary>
+	/// Extract the stripe region of the pole the way the full frame pipeline does
+	/// </summary>
+	/// <param name="pole">The generated pole</param>
+	/// <returns>A copy of the grayscale stripe region</returns>
+	static Mat CreateRegion(SyntheticPole &pole) {
+		WaterLevelTracker tracker;
+		MarkerProperties marker = pole.CreateMarker();
+		StripeProperties stripes = pole.CreateStripes();
+		return TrackerStages::ExtractRegion(tracker, pole.GetFrame(), 360 - pole.GetRotation(), marker, stripes).clone();
+	}
+
+	/// <summary>
+	/// Time the smoothing of the stripe region
+	/// </summary>
+	static void BM_Blur(benchmark::State &state) {
+		SyntheticPole pole = CreatePole(state);
+		Mat region = CreateRegion(pole);
+		WaterLevelTracker tracker;
+		LatencyRecorder recorder(state);
+		for (auto _ : state) {
+			recorder.Start();
+			benchmark::DoNotOptimize(TrackerStages::Blur(tracker, region).data);
+			recorder.Stop();
+		}
+
+		recorder.Report();
+	}
+
+	/// <summary>
+	/// Time the segmentation of the smoothed stripe region into a row profile
+	/// </summary>
+	static void BM_Segment(benchmark::State &state) {
+		SyntheticPole pole = CreatePole(state);
+		WaterLevelTracker tracker;
+		Mat blurred = TrackerStages::Blur(tracker, CreateRegion(pole)).clone();
+		std::vector<uchar> profile;
+		LatencyRecorder recorder(state);
+		for (auto _ : state) {
+			recorder.Start();
+			TrackerStages::Segment(blurred, profile);
+			benchmark::DoNotOptimize(profile.data());
+			recorder.Stop();
+		}
+
+		recorder.Report();
+	}
+
+	/// <summary>
+	/// Time counting the stripes in the row profile
+	/// </summary>
+	static void BM_StripeCount(benchmark::State &state) {
+		SyntheticPole pole = CreatePole(state);
+		WaterLevelTracker tracker;
+		StripeProperties stripes = pole.CreateStripes();
+		std::vector<uchar> profile;
+		TrackerStages::Segment(TrackerStages::Blur(tracker, CreateRegion(pole)), profile);
+		LatencyRecorder recorder(state);
+		for (auto _ : state) {
+			recorder.Start();
+			benchmark::DoNotOptimize(TrackerStages::StripeCount(profile, stripes));
+			recorder.Stop();
+		}
+
+		recorder.Report();
+	}
+
+	/// <summary>
+	/// Time the whole pipeline, the fourth and fifth argument select the region mode and the profile mode, the sixth the minimum stripe height
+	/// and the seventh the motion threshold. The frame never changes, so with a motion threshold it is a quiet scene.
+	/// Reports how far the measured level is from the level in the frame and the fraction of skipped frames. The RowMean and
+	/// RowTrimmedMean profile modes also track every frame with the Region profile mode, untimed, and report the mean difference
+	/// of the levels and the share of frames whose stripe counts match.
+	/// </summary>
+	static void BM_EndToEnd(benchmark::State &state) {
+		SyntheticPole pole = CreatePole(state);
+		TrackerOptions options;
+		options.regionMode = (RegionMode)state.range(3);
+		options.profileMode = (ProfileMode)state.range(4);
+		options.minStripePixelHeight = (int)state.range(5);
+		options.motionThreshold = (double)state.range(6);
+		WaterLevelTracker tracker(options);
+		TrackerOptions referenceOptions = options;
+		referenceOptions.profileMode = ProfileMode::Region;
+		WaterLevelTracker reference(referenceOptions);
+		bool compare = options.profileMode == ProfileMode::RowMean || options.profileMode == ProfileMode::RowTrimmedMean;
+		MarkerProperties sourceMarker = pole.CreateMarker();
+		StripeProperties sourceStripes = pole.CreateStripes();
+		WltTrackingResult result = WltTrackingResult();
+		double levelDelta = 0;
+		long long countMatches = 0;
+		LatencyRecorder recorder(state);
+		for (auto _ : state) {
+			MarkerProperties marker = sourceMarker;
+			StripeProperties stripes = sourceStripes;
+			recorder.Start();
+			result = tracker.Measure(pole.GetFrame(), marker, stripes, pole.GetRotation());
+			benchmark::DoNotOptimize(result.level);
+			recorder.Stop();
+			if (compare) {
+				state.PauseTiming();
+				marker = sourceMarker;
+				stripes = sourceStripes;
+				WltTrackingResult expected = reference.Measure(pole.GetFrame(), marker, stripes, pole.GetRotation());
+				levelDelta += std::abs(result.level - expected.level);
+				countMatches += result.status == expected.status && result.stripeCount == expected.stripeCount ? 1 : 0;
+				state.ResumeTiming();
+			}
+		}
+
+		recorder.Report();
+		state.counters["level_error_m"] = result.level == 0 ? -1 : std::abs(result.level - pole.GetExpectedLevel());
+		state.counters["skipped"] = (double)tracker.GetSkippedCount() / state.iterations();
+		if (compare) {
+			state.counters["region_delta_m"] = levelDelta / state.iterations();
+			state.counters["region_count_match"] = (double)countMatches / state.iterations();
+		}
+	}
+
+	/// <summary>
+	/// Measure how close the level comes to water which covers part of a stripe, the third argument is the part above the water
+	/// in quarters of a stripe, the fourth the profile mode and the fifth whether the water line is located to a fraction of a pixel.
+	/// Without it the level moves in whole stripes, so the error is up to the height of a stripe.
+	/// </summary>
+	static void BM_SubPixel(benchmark::State &state) {
+		SyntheticPole pole(Resolutions[state.range(0)], (double)state.range(1), 8 + (state.range(2) / 4.0));
+		TrackerOptions options;
+		options.profileMode = (ProfileMode)state.range(3);
+		options.subPixel = state.range(4) != 0;
+		WaterLevelTracker tracker(options);
+		MarkerProperties sourceMarker = pole.CreateMarker();
+		StripeProperties sourceStripes = pole.CreateStripes();
+		double level = 0;
+		LatencyRecorder recorder(state);
+		for (auto _ : state) {
+			MarkerProperties marker = sourceMarker;
+			StripeProperties stripes = sourceStripes;
+			recorder.Start();
+			level = tracker.Track(pole.GetFrame(), marker, stripes, pole.GetRotation());
+			benchmark::DoNotOptimize(level);
+			recorder.Stop();
+		}
+
+		recorder.Report();
+		state.counters["level_error_m"] = level == 0 ? -1 : std::abs(level - pole.GetExpectedLevel());
+	}
+
+	/// <summary>
+	/// Step a governor down to a quality level, it stays there as long as no cost is recorded
+	/// </summary>
+	/// <param name="qualityLevel">The quality level</param>
+	/// <returns>A governor at the quality level</returns>
+	static LatencyGovernor PinnedGovernor(int qualityLevel) {
+		LatencyGovernor governor(1e-9);
+		while (governor.GetQualityLevel() < std::min(qualityLevel, (int)LatencyGovernor::MaxQualityLevel)) {
+			governor.Record(1);
+		}
+
+		return governor;
+	}
+
+	/// <summary>
+	/// Track frames with 10 stripes above the water under a latency budget, the third and fourth argument select the region mode and the
+	/// profile mode and the fifth is the budget in microseconds, 0 to process every frame as configured. When the sixth argument is not -1
+	/// the governor is pinned at that quality level instead, so the frames per second of the levels can be compared: every level has to
+	/// be faster than the one before it.
+	/// Reports the quality level the governor settled on, the share of frames it skipped and how far the last level is off.
+	/// </summary>
+	static void BM_LatencyGovernor(benchmark::State &state) {
+		SyntheticPole pole(Resolutions[state.range(0)], (double)state.range(1), 10);
+		TrackerOptions options;
+		options.regionMode = (RegionMode)state.range(2);
+		options.profileMode = (ProfileMode)state.range(3);
+		int qualityLevel = (int)state.range(5);
+		LatencyGovernor governor = PinnedGovernor(qualityLevel);
+		if (qualityLevel < 0) {
+			options.latencyBudget = state.range(4) / 1e6;
+		} else {
+			options = governor.Apply(options);
+		}
+
+		WaterLevelTracker tracker(options);
+		MarkerProperties sourceMarker = pole.CreateMarker();
+		StripeProperties sourceStripes = pole.CreateStripes();
+		double level = 0;
+		long long skipped = 0;
+		LatencyRecorder recorder(state);
+		for (auto _ : state) {
+			MarkerProperties marker = sourceMarker;
+			StripeProperties stripes = sourceStripes;
+			recorder.Start();
+			if (qualityLevel < 0 || governor.Admit()) {
+				level = tracker.Track(pole.GetFrame(), marker, stripes, pole.GetRotation());
+			} else {
+				skipped++;
+			}
+
+			benchmark::DoNotOptimize(level);
+			recorder.Stop();
+		}
+
+		recorder.Report();
+		state.counters["level_error_m"] = level == 0 ? -1 : std::abs(level - pole.GetExpectedLevel());
+		state.counters["quality"] = qualityLevel < 0 ? tracker.GetQualityLevel() : qualityLevel;
+		state.counters["skipped"] = (double)(qualityLevel < 0 ? tracker.GetBudgetSkippedCount() : skipped) / state.iterations();
+	}
+
+	/// <summary>
+	/// Replay synthetic streams on the stream engine, the first argument is the amount of streams and the second the amount of threads.
+	/// The streams cycle through the resolutions, so cheap and expensive streams share the pool. Every iteration submits a burst of frames to every stream.
+	/// Reports the aggregate frames per second, the amount of steals and the Jain fairness index of the mean time the frames of a stream waited,
+	/// which is 1 when every stream waits equally long.
+	/// </summary>
+	static void BM_StreamEngine(benchmark::State &state) {
+		const int burst = 4;
+		int streamCount = (int)state.range(0);
+		StreamEngine engine(TrackerOptions(), (int)state.range(1));
+		std::vector<SyntheticPole> poles;
+		for (int i = 0; i < streamCount; i++) {
+			poles.push_back(SyntheticPole(Resolutions[i % 3], (double)((i * 7) % 30), 4 + i % 8));
+			engine.AddStream(poles[i].CreateMarker(), poles[i].CreateStripes());
+		}
+
+		EngineResult result;
+		for (auto _ : state) {
+			for (int frame = 0; frame < burst; frame++) {
+				for (int i = 0; i < streamCount; i++) {
+					engine.Submit(i, poles[i].GetFrame(), poles[i].GetRotation());
+				}
+			}
+
+			engine.Wait();
+			while (engine.TryGetResult(result)) {
+				benchmark::DoNotOptimize(result.level);
+			}
+		}
+
+		double sum = 0;
+		double squares = 0;
+		for (int i = 0; i < streamCount; i++) {
+			StreamStatistics statistics = engine.GetStatistics(i);
+			double waiting = statistics.processed == 0 ? 0 : (statistics.totalLatency - statistics.totalProcessing) / statistics.processed;
+			sum += waiting;
+			squares += waiting * waiting;
+		}
+
+		state.counters["frames/s"] = benchmark::Counter((double)state.iterations() * streamCount * burst, benchmark::Counter::kIsRate);
+		state.counters["fairness"] = squares == 0 ? 1 : (sum * sum) / (streamCount * squares);
+		state.counters["steals"] = (double)engine.GetStealCount();
+	}
+
+	/// <summary>
+	/// Record frames of the pole to a temporary recording and time feeding them back through the tracker from the memory mapping.
+	/// The fourth argument selects whether the stripe region or the whole frame is recorded.
+	/// Reports the size of the recording per frame and how many replayed levels differ from the recorded ones.
+	/// </summary>
+	static void BM_Replay(benchmark::State &state) {
+		const int frameCount = 32;
+		const std::string path = "WaterLevelTrackingBenchmark.wltr";
+		SyntheticPole pole = CreatePole(state);
+		TrackerOptions options;
+		options.regionMode = RegionMode::OrientedRegion;
+		{
+			FrameRecorder recorder(path, (RecordContent)state.range(3));
+			WaterLevelTracker tracker(options);
+			tracker.SetRecorder(&recorder);
+			for (int i = 0; i < frameCount; i++) {
+				MarkerProperties marker = pole.CreateMarker();
+				StripeProperties stripes = pole.CreateStripes();
+				tracker.Track(pole.GetFrame(), marker, stripes, pole.GetRotation());
+			}
+		}
+
+		FrameReplay replay;
+		if (!replay.Open(path)) {
+			state.SkipWithError("Recording could not be opened");
+			return;
+		}
+
+		WaterLevelTracker tracker(options);
+		ReplayFrame frame;
+		long long mismatches = 0;
+		int index = 0;
+		LatencyRecorder recorder(state);
+		for (auto _ : state) {
+			recorder.Start();
+			double level = replay.Replay(index, tracker);
+			recorder.Stop();
+			replay.GetFrame(index, frame);
+			mismatches += level == frame.level ? 0 : 1;
+			index = (index + 1) % replay.GetCount();
+		}
+
+		recorder.Report();
+		std::ifstream file(path.c_str(), std::ios::binary | std::ios::ate);
+		state.counters["bytes_per_frame"] = (double)file.tellg() / frameCount;
+		state.counters["mismatches"] = (double)mismatches;
+		replay.Close();
+		std::remove(path.c_str());
+	}
+
+	/// <summary>
+	/// Add the levels of a marker filmed at 25 frames per second to its history, the argument is the amount of rows a row profile is stored with.
+	/// The level rises a centimeter per minute, so the rate of rise of the one hour window should stay at 0.6 meters per hour however long it runs.
+	/// </summary>
+	static void BM_LevelHistory(benchmark::State &state) {
+		LevelHistory history(4096, (int)state.range(0));
+		std::vector<uchar> profile(600);
+		for (size_t row = 0; row < profile.size(); row++) {
+			profile[row] = (row / 20) % 2 == 0 ? 255 : 0;
+		}
+
+		long long timestamp = 0;
+		LatencyRecorder recorder(state);
+		for (auto _ : state) {
+			timestamp += 40000;
+			double level = 1.0 + (timestamp / 6e9);
+			recorder.Start();
+			history.Add(timestamp, level, true, profile);
+			recorder.Stop();
+		}
+
+		recorder.Report();
+		WltLevelStatistics statistics;
+		history.GetStatistics(1, statistics);
+		state.counters["rate_m_per_h"] = statistics.rateOfRise;
+	}
+
+	/// <summary>
+	/// Read the level board while a writer thread publishes to the same slot as fast as it can.
+	/// Every field of a published sample is derived from its timestamp, so a torn read shows up as a sample that does not add up.
+	/// Reports the torn and out of order reads next to the read latencies and fails when there are any.
+	/// </summary>
+	static void BM_LevelBoard(benchmark::State &state) {
+		const int marker = LevelBoard::MarkerCapacity - 1;
+		std::atomic<bool> writing(true);
+		std::thread writer([&writing] {
+			WltLevelSample sample = WltLevelSample();
+			for (long long timestamp = 0; writing.load(std::memory_order_relaxed); timestamp++) {
+				sample.timestamp = timestamp;
+				sample.level = timestamp * 0.5;
+				sample.confidence = (timestamp % 100) / 100.0;
+				for (int i = 0; i < WLT_STAGE_COUNT; i++) {
+					sample.stageTimings[i] = (double)(timestamp + i);
+				}
+
+				LevelBoard::Publish(marker, sample);
+			}
+		});
+
+		WltLevelSample sample;
+		long long torn = 0;
+		long long outOfOrder = 0;
+		long long lastSequence = 0;
+		LatencyRecorder recorder(state);
+		for (auto _ : state) {
+			recorder.Start();
+			bool read = LevelBoard::Read(marker, sample);
+			recorder.Stop();
+			if (!read) {
+				continue;
+			}
+
+			bool consistent = sample.level == sample.timestamp * 0.5 && sample.confidence == (sample.timestamp % 100) / 100.0;
+			for (int i = 0; i < WLT_STAGE_COUNT; i++) {
+				consistent = consistent && sample.stageTimings[i] == (double)(sample.timestamp + i);
+			}
+
+			torn += consistent ? 0 : 1;
+			outOfOrder += sample.sequence < lastSequence ? 1 : 0;
+			lastSequence = sample.sequence;
+		}
+
+		writing = false;
+		writer.join();
+		recorder.Report();
+		state.counters["torn"] = (double)torn;
+		state.counters["out_of_order"] = (double)outOfOrder;
+		if (torn > 0 || outOfOrder > 0) {
+			state.SkipWithError("The level board handed out torn or reordered samples");
+		}
+	}
+
+	/// <summary>
+	/// Time the fused threshold and row projection kernel for one instruction set, the second argument selects it.
+	/// Reports the amount of rows on which the kernel disagrees with the scalar kernel.
+	/// </summary>
+	static void BM_ThresholdRowProjection(benchmark::State &state) {
+		SegmentKernels::InstructionSet instructionSet = (SegmentKernels::InstructionSet)state.range(1);
+		if (instructionSet > SegmentKernels::GetSupportedInstructionSet()) {
+			state.SkipWithError("Instruction set not supported");
+			return;
+		}
+
+		SyntheticPole pole(Resolutions[state.range(0)], 0, 10);
+		WaterLevelTracker tracker;
+		Mat blurred = TrackerStages::Blur(tracker, CreateRegion(pole)).clone();
+		std::vector<uchar> expected(blurred.rows);
+		std::vector<uchar> profile(blurred.rows);
+		SegmentKernels::ThresholdRowProjection(SegmentKernels::Scalar, blurred.data, blurred.step, blurred.rows, blurred.cols, 150, &expected[0]);
+		LatencyRecorder recorder(state);
+		for (auto _ : state) {
+			recorder.Start();
+			SegmentKernels::ThresholdRowProjection(instructionSet, blurred.data, blurred.step, blurred.rows, blurred.cols, 150, &profile[0]);
+			benchmark::DoNotOptimize(profile.data());
+			recorder.Stop();
+		}
+
+		recorder.Report();
+		state.counters["mismatches"] = (double)std::inner_product(profile.begin(), profile.end(), expected.begin(), 0, std::plus<int>(), std::not_equal_to<uchar>());
+	}
+
+	BENCHMARK(BM_Rotate)->ArgNames({ "res", "rot", "water" })->ArgsProduct({ { 0, 1, 2 }, { 0, 5, 15 }, { 10 } })->UseRealTime();
+	BENCHMARK(BM_Crop)->ArgNames({ "res", "rot", "water" })->ArgsProduct({ { 0, 1, 2 }, { 0, 5, 15 }, { 10 } })->UseRealTime();
+	BENCHMARK(BM_Blur)->ArgNames({ "res", "rot", "water" })->ArgsProduct({ { 0, 1, 2 }, { 0, 15 }, { 10 } })->UseRealTime();
+	BENCHMARK(BM_Segment)->ArgNames({ "res", "rot", "water" })->ArgsProduct({ { 0, 1, 2 }, { 0, 15 }, { 10 } })->UseRealTime();
+	BENCHMARK(BM_StripeCount)->ArgNames({ "res", "rot", "water" })->ArgsProduct({ { 0, 1, 2 }, { 0 }, { 4, 12 } })->UseRealTime();
+	BENCHMARK(BM_EndToEnd)->ArgNames({ "res", "rot", "water", "region", "profile", "minstripe", "motion" })->ArgsProduct({ { 0, 2 }, { 0, 15 }, { 4, 12 }, { 0, 1, 2 }, { 0, 1, 2, 3 }, { 0 }, { 0 } })->UseRealTime();
+	BENCHMARK(BM_EndToEnd)->ArgNames({ "res", "rot", "water", "region", "profile", "minstripe", "motion" })->ArgsProduct({ { 1, 2 }, { 0, 15 }, { 4, 12 }, { 0, 1 }, { 0 }, { 4, 8 }, { 0 } })->UseRealTime();
+	BENCHMARK(BM_EndToEnd)->ArgNames({ "res", "rot", "water", "region", "profile", "minstripe", "motion" })->ArgsProduct({ { 1, 2 }, { 0, 15 }, { 4 }, { 0, 2 }, { 0 }, { 0 }, { 2 } })->UseRealTime();
+	BENCHMARK(BM_SubPixel)->ArgNames({ "res", "rot", "quarter", "profile", "subpixel" })->ArgsProduct({ { 0, 1, 2 }, { 0, 15 }, { 0, 1, 2, 3 }, { 0, 1 }, { 0, 1 } })->UseRealTime();
+	BENCHMARK(BM_LatencyGovernor)->ArgNames({ "res", "rot", "region", "profile", "budget_us", "quality" })->ArgsProduct({ { 0, 1, 2 }, { 15 }, { 0, 1, 2 }, { 0 }, { 0, 250, 1000, 4000 }, { -1 } })->UseRealTime();
+	BENCHMARK(BM_LatencyGovernor)->ArgNames({ "res", "rot", "region", "profile", "budget_us", "quality" })->ArgsProduct({ { 1, 2 }, { 15 }, { 1, 2 }, { 0, 1, 3 }, { 0 }, { 0, 1, 2, 3, 4 } })->UseRealTime();
+	BENCHMARK(BM_StreamEngine)->ArgNames({ "streams", "threads" })->ArgsProduct({ { 4, 16, 48 }, { 1, 2, 4, 8 } })->UseRealTime();
+	BENCHMARK(BM_Replay)->ArgNames({ "res", "rot", "water", "content" })->ArgsProduct({ { 0, 2 }, { 0, 15 }, { 4 }, { 0, 1 } })->UseRealTime();
+	BENCHMARK(BM_LevelBoard)->UseRealTime();
+	BENCHMARK(BM_LevelHistory)->ArgNames({ "rows" })->Arg(0)->Arg(256)->UseRealTime();
+	BENCHMARK(BM_ThresholdRowProjection)->ArgNames({ "res", "isa" })->ArgsProduct({ { 0, 1, 2 }, { 0, 1, 2 } })->UseRealTime();
+}
+
+BENCHMARK_MAIN();
\ No newline at end of file
@@ -0,0 +1,125 @@
+// <copyright file="SyntheticPole.cpp" company="Delft University of Technology">
+// Copyright (c) Delft University of Technology. All rights reserved.
+// </copyright>
+
+#include "SyntheticPole.h"
+
+namespace waterleveltracking {
+	/// <summary>
+	/// The size of the marker in meters
+	/// </summary>
+	static const double MarkerSize = 0.15;
+
+	/// <summary>
+	/// The distance from the center of the marker to the highest stripe in meters
+	/// </summary>
+	static const double DistanceToStripes = 0.15;
+
+	/// <summary>
+	/// The height of the center of the marker in meters
+	/// </summary>
+	static const double MarkerHeight = 2.0;
+
+	/// <summary>
+	/// The height of a stripe in meters
+	/// </summary>
+	static const double StripeHeight = 0.05;
+
+	/// <summary>
+	/// The amount of stripes underneath the marker
+	/// </summary>
+	static const int StripeCount = 30;
+
+	/// <summary>
+	/// Generate a frame of the pole. The pole fills the frame vertically and is rotated around the center of the frame.
+	/// </summary>
+	/// <param name="frameSize">The size of the frame</param>
+	/// <param name="rotation">Angle in degrees of the rotation of the pole</param>
+	/// <param name="stripesAboveWater">The amount of stripes above the water, with a fraction the lowest of them is partly under water</param>
+	/// <param name="channels">1 for a grayscale frame, 3 for a color frame</param>
+	/// <param name="seed">The seed of the noise in the frame</param>
+	SyntheticPole::SyntheticPole(Size frameSize, double rotation, double stripesAboveWater, int channels, unsigned seed) {
+		this->rotation = rotation;
+		this->expectedLevel = MarkerHeight - DistanceToStripes - (StripeHeight * stripesAboveWater);
+
+		// Two and a half meters of the pole fit in the frame
+		double meterToPixelFactor = frameSize.height / 2.5;
+		int markerPixels = (int)(MarkerSize * meterToPixelFactor);
+		int left = (frameSize.width - markerPixels) / 2;
+		int top = frameSize.height / 12;
+		int centerY = top + markerPixels / 2;
+		int stripeTop = centerY + (int)(DistanceToStripes * meterToPixelFactor);
+		int waterTop = stripeTop + (int)(StripeHeight * meterToPixelFactor * stripesAboveWater);
+
+		// Background and water are noisy but never black, so the bottom of the image is found where the rotation ends it
+		Mat upright(frameSize, CV_8UC1);
+		RNG rng(seed);
+		rng.fill(upright, RNG::UNIFORM, 70, 110);
+		Mat water = upright.rowRange(std::min(waterTop, frameSize.height), frameSize.height);
+		water -= 40;
+
+		Rect marker(left, top, markerPixels, markerPixels);
+		upright(marker).setTo(20);
+		upright(Rect(left + markerPixels / 4, top + markerPixels / 4, markerPixels / 2, markerPixels / 2)).setTo(230);
+		for (int stripe = 0; stripe < StripeCount; stripe++) {
+			int start = stripeTop + (int)(StripeHeight * meterToPixelFactor * stripe);
+			int end = std::min(stripeTop + (int)(StripeHeight * meterToPixelFactor * (stripe + 1)), waterTop);
+			if (start >= end) {
+				break;
+			}
+
+			upright(Range(start, end), Range(left, left + markerPixels)).setTo(stripe % 2 == 0 ? 230 : 20);
+		}
+
+		// Rotate the pole the way the tracker rotates it back
+		Mat mRotation = getRotationMatrix2D(Point2f((float)(frameSize.width / 2) - 1, (float)(frameSize.height / 2) - 1), rotation, 1.0);
+		Point2d uprightCorners[] = { Point2d(left, top + markerPixels), Point2d(left + markerPixels, top + markerPixels), Point2d(left + markerPixels, top), Point2d(left, top) };
+		for (int i = 0; i < 4; i++) {
+			this->corners[2 * i] = (int)(mRotation.at<double>(0, 0) * uprightCorners[i].x + mRotation.at<double>(0, 1) * uprightCorners[i].y + mRotation.at<double>(0, 2));
+			this->corners[2 * i + 1] = (int)(mRotation.at<double>(1, 0) * uprightCorners[i].x + mRotation.at<double>(1, 1) * uprightCorners[i].y + mRotation.at<double>(1, 2));
+		}
+
+		Mat rotated;
+		warpAffine(upright, rotated, mRotation, frameSize, INTER_LINEAR, BORDER_REPLICATE);
+		if (channels == 1) {
+			this->frame = rotated;
+		} else {
+			cvtColor(rotated, this->frame, COLOR_GRAY2RGB);
+		}
+	}
+
+	/// <summary>
+	/// Gets the frame
+	/// </summary>
+	const Mat &SyntheticPole::GetFrame() {
+		return this->frame;
+	}
+
+	/// <summary>
+	/// Gets the rotation to pass to the tracker
+	/// </summary>
+	double SyntheticPole::GetRotation() {
+		return this->rotation;
+	}
+
+	/// <summary>
+	/// Gets the water level height the frame shows
+	/// </summary>
+	double SyntheticPole::GetExpectedLevel() {
+		return this->expectedLevel;
+	}
+
+	/// <summary>
+	/// Create the properties of the marker as a detector would report them
+	/// </summary>
+	MarkerProperties SyntheticPole::CreateMarker() {
+		return MarkerProperties(this->corners, MarkerSize, DistanceToStripes, MarkerHeight);
+	}
+
+	/// <summary>
+	/// Create the properties of the stripes underneath the marker
+	/// </summary>
+	StripeProperties SyntheticPole::CreateStripes() {
+		return StripeProperties(this->CreateMarker(), StripeHeight, StripeCount);
+	}
+}
\ No newline at end of file
@@ -0,0 +1,78 @@
+// <copyright file="SyntheticPole.h" company="Delft University of Technology">
+// Copyright (c) Delft University of Technology. All rights reserved.
+// </copyright>
+
+#ifndef __SYNTHETICPOLE_H__
+#define __SYNTHETICPOLE_H__
+
+#include <opencv2/opencv.hpp>
+#include "MarkerProperties.h"
+#include "StripeProperties.h"
+
+using namespace cv;
+
+namespace waterleveltracking {
+	/// <summary>
+	/// A generated frame of a striped gauge pole with a marker on top, partly under water
+	/// </summary>
+	class SyntheticPole {
+	public:
+		/// <summary>
+		/// Generate a frame of the pole. The pole fills the frame vertically and is rotated around the center of the frame.
+		/// </summary>
+		/// <param name="frameSize">The size of the frame</param>
+		/// <param name="rotation">Angle in degrees of the rotation of the pole</param>
+		/// <param name="stripesAboveWater">The amount of stripes above the water, with a fraction the lowest of them is partly under water</param>
+		/// <param name="channels">1 for a grayscale frame, 3 for a color frame</param>
+		/// <param name="seed">The seed of the noise in the frame</param>
+		SyntheticPole(Size frameSize, double rotation, double stripesAboveWater, int channels = 3, unsigned seed = 1);
+
+		/// <summary>
+		/// Gets the frame
+		/// </summary>
+		const Mat &GetFrame();
+
+		/// <summary>
+		/// Gets the rotation to pass to the tracker
+		/// </summary>
+		double GetRotation();
+
+		/// <summary>
+		/// Gets the water level height the frame shows
+		/// </summary>
+		double GetExpectedLevel();
+
+		/// <summary>
+		/// Create the properties of the marker as a detector would report them
+		/// </summary>
+		MarkerProperties CreateMarker();
+
+		/// <summary>
+		/// Create the properties of the stripes underneath the marker
+		/// </summary>
+		StripeProperties CreateStripes();
+
+	private:
+		/// <summary>
+		/// The generated frame
+		/// </summary>
+		Mat frame;
+
+		/// <summary>
+		/// The pixel locations of the marker corners in the order bottom left, bottom right, top right, top left
+		/// </summary>
+		int corners[8];
+
+		/// <summary>
+		/// Angle in degrees of the rotation of the pole
+		/// </summary>
+		double rotation;
+
+		/// <summary>
+		/// The water level height the frame shows
+		/// </summary>
+		double expectedLevel;
+	};
+}
+
+#endif
\ No newline at end of file
@@ -0,0 +1,59 @@
+// <copyright file="BatchTracker.h" company="Delft University of Technology">
+// Copyright (c) Delft University of Technology. All rights reserved.
+// </copyright>
+
+#ifndef __BATCHTRACKER_H__
+#define __BATCHTRACKER_H__
+
+#include <vector>
+#include <opencv2/opencv.hpp>
+#include "MarkerProperties.h"
+#include "StripeProperties.h"
+#include "TrackerOptions.h"
+#include "WaterLevelTracker.h"
+
+namespace waterleveltracking {
+	/// <summary>
+	/// Calculates the water level at every marker visible in a frame.
+	/// The frame is converted to grayscale once and the markers are processed in parallel.
+	/// </summary>
+	class BatchTracker
+	{
+	public:
+		/// <summary>
+		/// Initializes a new instance of the <see cref="BatchTracker"/> class.
+		/// The stripe regions are always resampled from the shared grayscale frame, so the FullFrame region mode is replaced by OrientedRegion.
+		/// </summary>
+		/// <param name="options">The options which select how the stripe regions are processed</param>
+		BatchTracker(TrackerOptions options = TrackerOptions());
+
+		/// <summary>
+		/// Predict the height of the water level at every marker in the frame.
+		/// A level is NULL if it cannot be derived from the information, all levels are -1 if the input lists differ in size.
+		/// </summary>
+		/// <param name="frame">The captured frame of the video feed, which is not modified</param>
+		/// <param name="markerProperties">Properties of the measured markers</param>
+		/// <param name="stripeProperties">Properties of the stripes underneath each of the markers</param>
+		/// <param name="rotations">Angle in degrees of the rotation of each of the markers</param>
+		/// <param name="levels">The height of the water in meters at each of the markers</param>
+		void CalculateWaterLevels(const Mat &frame, std::vector<MarkerProperties> &markerProperties, std::vector<StripeProperties> &stripeProperties, const std::vector<double> &rotations, std::vector<double> &levels);
+
+	private:
+		/// <summary>
+		/// The options which select how the stripe regions are processed
+		/// </summary>
+		TrackerOptions options;
+
+		/// <summary>
+		/// One tracker with its own scratch buffers per marker
+		/// </summary>
+		std::vector<WaterLevelTracker> trackers;
+
+		/// <summary>
+		/// Scratch buffer for the shared grayscale frame
+		/// </summary>
+		Mat grayBuffer;
+	};
+}
+
+#endif
\ No newline at end of file
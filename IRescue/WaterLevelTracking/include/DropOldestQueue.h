@@ -0,0 +1,90 @@
+// <copyright file="DropOldestQueue.h" company="Delft University of Technology">
+// Copyright (c) Delft University of Technology. All rights reserved.
+// </copyright>
+
+#ifndef __DROPOLDESTQUEUE_H__
+#define __DROPOLDESTQUEUE_H__
+
+#include <atomic>
+#include <cstddef>
+#include <vector>
+
+namespace waterleveltracking {
+	/// <summary>
+	/// Bounded lock-free queue of pointers between one producer and one consumer.
+	/// When the queue is full the oldest item is dropped to make room, so the consumer only ever sees recent items.
+	/// </summary>
+	template<typename T>
+	class DropOldestQueue
+	{
+	public:
+		/// <summary>
+		/// Initializes a new instance of the <see cref="DropOldestQueue"/> class.
+		/// </summary>
+		/// <param name="capacity">The maximum amount of items in the queue</param>
+		DropOldestQueue(size_t capacity) : slots(capacity), capacity(capacity), head(0), tail(0) {
+		}
+
+		/// <summary>
+		/// Add an item to the queue, may only be called by the producer
+		/// </summary>
+		/// <param name="item">The item to add</param>
+		/// <returns>The oldest item if it was dropped to make room, otherwise nullptr</returns>
+		T *Push(T *item) {
+			size_t h = this->head.load(std::memory_order_relaxed);
+			size_t t = this->tail.load(std::memory_order_acquire);
+			T *dropped = nullptr;
+			while (dropped == nullptr && h - t >= this->capacity) {
+				// Claim the oldest item; once the tail moved past it the consumer can no longer take it
+				if (this->tail.compare_exchange_weak(t, t + 1, std::memory_order_acq_rel)) {
+					dropped = this->slots[t % this->capacity].load(std::memory_order_relaxed);
+				}
+			}
+
+			this->slots[h % this->capacity].store(item, std::memory_order_relaxed);
+			this->head.store(h + 1, std::memory_order_release);
+			return dropped;
+		}
+
+		/// <summary>
+		/// Take the oldest item from the queue, may only be called by the consumer
+		/// </summary>
+		/// <returns>The oldest item or nullptr if the queue is empty</returns>
+		T *Pop() {
+			size_t t = this->tail.load(std::memory_order_acquire);
+			while (t != this->head.load(std::memory_order_acquire)) {
+				T *item = this->slots[t % this->capacity].load(std::memory_order_relaxed);
+
+				// Fails if the producer dropped this item in the meantime, the slot is then read again
+				if (this->tail.compare_exchange_weak(t, t + 1, std::memory_order_acq_rel)) {
+					return item;
+				}
+			}
+
+			return nullptr;
+		}
+
+	private:
+		/// <summary>
+		/// The ring of items
+		/// </summary>
+		std::vector<std::atomic<T*>> slots;
+
+		/// <summary>
+		/// The maximum amount of items in the queue
+		/// </summary>
+		size_t capacity;
+
+		/// <summary>
+		/// The amount of items ever pushed, only written by the producer
+		/// </summary>
+		std::atomic<size_t> head;
+
+		/// <summary>
+		/// The amount of items ever popped or dropped
+		/// </summary>
+		std::atomic<size_t> tail;
+	};
+}
+
+#endif
\ No newline at end of file
@@ -0,0 +1,21 @@
+// <copyright file="Export.h" company="Delft University of Technology">
+// Copyright (c) Delft University of Technology. All rights reserved.
+// </copyright>
+
+#ifndef __EXPORT_H__
+#define __EXPORT_H__
+
+/// <summary>
+/// Marks a function as part of the C interface of the library, which the Unity host calls
+/// </summary>
+#if defined(_WIN32)
+#ifdef WATERLEVELTRACKING_EXPORTS
+#define WLT_EXPORT extern "C" __declspec(dllexport)
+#else
+#define WLT_EXPORT extern "C" __declspec(dllimport)
+#endif
+#else
+#define WLT_EXPORT extern "C" __attribute__((visibility("default")))
+#endif
+
+#endif
\ No newline at end of file
@@ -0,0 +1,109 @@
+// <copyright file="FrameRecorder.h" company="Delft University of Technology">
+// Copyright (c) Delft University of Technology. All rights reserved.
+// </copyright>
+
+#ifndef __FRAMERECORDER_H__
+#define __FRAMERECORDER_H__
+
+#include <fstream>
+#include <string>
+#include <vector>
+#include <opencv2/opencv.hpp>
+#include "MarkerProperties.h"
+#include "RecordingFormat.h"
+#include "Square.h"
+#include "StripeProperties.h"
+
+using namespace cv;
+
+namespace waterleveltracking {
+	/// <summary>
+	/// Appends what the tracker saw of every frame to a recording, so field failures can be replayed offline with <see cref="FrameReplay"/>.
+	/// Rejected and held frames are recorded as well, with the status they ended with.
+	/// A recorder may only be used by one tracker at a time.
+	/// </summary>
+	class FrameRecorder
+	{
+	public:
+		/// <summary>
+		/// Initializes a new instance of the <see cref="FrameRecorder"/> class and creates the recording.
+		/// </summary>
+		/// <param name="path">The path of the recording, an existing file is overwritten</param>
+		/// <param name="content">Whether the stripe region or the whole frame is recorded</param>
+		FrameRecorder(const std::string &path, RecordContent content = RecordContent::Region);
+
+		/// <summary>
+		/// Closes the recording.
+		/// </summary>
+		~FrameRecorder();
+
+		/// <summary>
+		/// Append a frame to the recording
+		/// </summary>
+		/// <param name="image">The stripe region or the whole frame, empty if no stripe region was extracted</param>
+		/// <param name="corners">The marker corners in the frame as they were handed to the tracker</param>
+		/// <param name="markerProperties">Properties of the measured marker</param>
+		/// <param name="stripeProperties">Properties of the striped underneath the measured marker</param>
+		/// <param name="stripePixelHeight">The height of a stripe in pixels in the image</param>
+		/// <param name="rotation">Angle in degrees of the rotation of the marker</param>
+		/// <param name="level">The water level the tracker calculated</param>
+		/// <param name="status">The WltStatus the frame ended with</param>
+		/// <returns>False if the recording could not be written</returns>
+		bool Record(const Mat &image, const Square &corners, MarkerProperties &markerProperties, StripeProperties &stripeProperties, int stripePixelHeight, double rotation, double level, int status);
+
+		/// <summary>
+		/// Write the index and close the recording, frames recorded afterwards are ignored
+		/// </summary>
+		void Close();
+
+		/// <summary>
+		/// Gets whether the recording is open for writing
+		/// </summary>
+		bool IsOpen();
+
+		/// <summary>
+		/// Gets what is recorded of every frame
+		/// </summary>
+		RecordContent GetContent();
+
+		/// <summary>
+		/// Gets the amount of recorded frames
+		/// </summary>
+		long long GetCount();
+
+	private:
+		/// <summary>
+		/// The recording
+		/// </summary>
+		std::ofstream file;
+
+		/// <summary>
+		/// What is recorded of every frame
+		/// </summary>
+		RecordContent content;
+
+		/// <summary>
+		/// The amount of bytes written so far
+		/// </summary>
+		uint64_t offset;
+
+		/// <summary>
+		/// The offset of every record
+		/// </summary>
+		std::vector<uint64_t> index;
+
+		/// <summary>
+		/// Append bytes to the recording
+		/// </summary>
+		/// <param name="data">The bytes</param>
+		/// <param name="size">The amount of bytes</param>
+		void Write(const void *data, uint64_t size);
+
+		/// <summary>
+		/// Append zeros up to the alignment of the records
+		/// </summary>
+		void Pad();
+	};
+}
+
+#endif
\ No newline at end of file
@@ -0,0 +1,181 @@
+// <copyright file="FrameReplay.h" company="Delft University of Technology">
+// Copyright (c) Delft University of Technology. All rights reserved.
+// </copyright>
+
+#ifndef __FRAMEREPLAY_H__
+#define __FRAMEREPLAY_H__
+
+#include <string>
+#include <vector>
+#include <opencv2/opencv.hpp>
+#include "MappedFile.h"
+#include "MarkerProperties.h"
+#include "RecordingFormat.h"
+#include "StripeProperties.h"
+#include "WaterLevelTracker.h"
+
+using namespace cv;
+
+namespace waterleveltracking {
+	/// <summary>
+	/// A recorded frame, its image points straight into the memory mapped recording
+	/// </summary>
+	struct ReplayFrame {
+		/// <summary>
+		/// The number of the frame within the recording
+		/// </summary>
+		long long sequence;
+
+		/// <summary>
+		/// The stripe region or the whole frame, valid as long as the recording is open and never to be written to
+		/// </summary>
+		Mat image;
+
+		/// <summary>
+		/// The marker corners in the frame in the order bottom left, bottom right, top right, top left
+		/// </summary>
+		int corners[8];
+
+		/// <summary>
+		/// The size of the marker in meters
+		/// </summary>
+		double markerSize;
+
+		/// <summary>
+		/// The distance from the center of the marker to the highest stripe in meters
+		/// </summary>
+		double distanceToStripes;
+
+		/// <summary>
+		/// The height of the center of the marker in meters
+		/// </summary>
+		double markerHeight;
+
+		/// <summary>
+		/// The height of a stripe in meters
+		/// </summary>
+		double stripeHeight;
+
+		/// <summary>
+		/// The amount of stripes underneath the marker
+		/// </summary>
+		int stripeCount;
+
+		/// <summary>
+		/// The height of a stripe in pixels in the recorded region
+		/// </summary>
+		int stripePixelHeight;
+
+		/// <summary>
+		/// Angle in degrees of the rotation of the marker
+		/// </summary>
+		double rotation;
+
+		/// <summary>
+		/// The water level the tracker calculated when the frame was recorded
+		/// </summary>
+		double level;
+
+		/// <summary>
+		/// The WltStatus the frame ended with when it was recorded
+		/// </summary>
+		int status;
+	};
+
+	/// <summary>
+	/// Reads a recording of a <see cref="FrameRecorder"/> through a memory mapping and feeds its frames back through the tracker without copying them
+	/// </summary>
+	class FrameReplay
+	{
+	public:
+		/// <summary>
+		/// Initializes a new instance of the <see cref="FrameReplay"/> class.
+		/// </summary>
+		FrameReplay();
+
+		/// <summary>
+		/// Unmaps the recording.
+		/// </summary>
+		~FrameReplay();
+
+		/// <summary>
+		/// Map a recording, the index is read from the footer or rebuilt by walking the records if the recording was not closed
+		/// </summary>
+		/// <param name="path">The path of the recording</param>
+		/// <returns>False if the file cannot be mapped or is not a recording</returns>
+		bool Open(const std::string &path);
+
+		/// <summary>
+		/// Unmap the recording, the images of the frames become invalid
+		/// </summary>
+		void Close();
+
+		/// <summary>
+		/// Gets a recorded frame
+		/// </summary>
+		/// <param name="index">The index of the frame</param>
+		/// <param name="frame">The frame</param>
+		/// <returns>False if the index is out of range</returns>
+		bool GetFrame(int index, ReplayFrame &frame);
+
+		/// <summary>
+		/// Feed a recorded frame through the tracker, a stripe region skips the straightening
+		/// A rejected or held frame recorded without a stripe region is rejected again, a recorded whole frame is tracked as it was
+		/// </summary>
+		/// <param name="index">The index of the frame</param>
+		/// <param name="tracker">The tracker</param>
+		/// <returns>The height of the water in meters, -1 if the index is out of range</returns>
+		double Replay(int index, WaterLevelTracker &tracker);
+
+		/// <summary>
+		/// Gets the amount of recorded frames
+		/// </summary>
+		int GetCount();
+
+		/// <summary>
+		/// Gets what was recorded of every frame
+		/// </summary>
+		RecordContent GetContent();
+
+	private:
+		/// <summary>
+		/// The mapped recording
+		/// </summary>
+		MappedFile file;
+
+		/// <summary>
+		/// The first byte of the mapped recording
+		/// </summary>
+		const uint8_t *data;
+
+		/// <summary>
+		/// The size in bytes of the recording
+		/// </summary>
+		uint64_t size;
+
+		/// <summary>
+		/// The offset of every record
+		/// </summary>
+		std::vector<uint64_t> offsets;
+
+		/// <summary>
+		/// What was recorded of every frame
+		/// </summary>
+		RecordContent content;
+
+		/// <summary>
+		/// Read the index from the footer, or rebuild it by walking the records
+		/// </summary>
+		/// <returns>False if the index in the footer points at damaged records</returns>
+		bool ReadIndex();
+
+		/// <summary>
+		/// Check whether a complete record starts at an offset
+		/// </summary>
+		/// <param name="offset">The offset in bytes</param>
+		/// <returns>True if the record is complete</returns>
+		bool IsRecord(uint64_t offset);
+	};
+}
+
+#endif
\ No newline at end of file
@@ -0,0 +1,173 @@
+// <copyright file="FusedKernels.h" company="Delft University of Technology">
+// Copyright (c) Delft University of Technology. All rights reserved.
+// </copyright>
+
+#ifndef __FUSEDKERNELS_H__
+#define __FUSEDKERNELS_H__
+
+#include <opencv2/opencv.hpp>
+#include "TrackerOptions.h"
+
+using namespace cv;
+
+namespace waterleveltracking {
+	/// <summary>
+	/// Pixels with one byte of intensity
+	/// </summary>
+	struct Gray8 {
+		static const int Channels = 1;
+
+		static inline int Luma(const uchar *pixel) {
+			return pixel[0];
+		}
+	};
+
+	/// <summary>
+	/// The binomial kernel GaussianBlur uses for the given radius when sigma is 0, the weights sum to 1 << Shift
+	/// </summary>
+	template<int Radius>
+	struct BinomialKernel;
+
+	template<>
+	struct BinomialKernel<1> {
+		static const int Shift = 2;
+
+		static inline int Weight(int tap) {
+			return tap == 1 ? 2 : 1;
+		}
+	};
+
+	template<>
+	struct BinomialKernel<2> {
+		static const int Shift = 4;
+
+		static inline int Weight(int tap) {
+			return tap == 2 ? 6 : tap == 1 || tap == 3 ? 4 : 1;
+		}
+	};
+
+	/// <summary>
+	/// A pixel is white above Threshold and a row belongs to a white stripe when at least Numerator / Denominator of its pixels are white
+	/// </summary>
+	template<int Threshold, int Numerator, int Denominator>
+	struct RowFraction {
+		static inline bool IsWhite(int value) {
+			return value > Threshold;
+		}
+
+		static inline bool IsWhiteRow(int count, int cols) {
+			return count * Denominator >= cols * Numerator;
+		}
+	};
+
+	/// <summary>
+	/// Blurs, thresholds and projects a stripe region in one integer-only pass, without writing the blurred region.
+	/// The result equals GaussianBlur with a binomial kernel followed by SegmentKernels::ThresholdRowProjection, including the
+	/// pixels GaussianBlur reads from around a region which is a view into a larger image.
+	/// </summary>
+	template<typename Pixel, int Radius, typename Policy>
+	class FusedSegmentKernel {
+	public:
+		/// <summary>
+		/// Segment the region
+		/// </summary>
+		/// <param name="region">The stripe region, with Pixel::Channels bytes per pixel</param>
+		/// <param name="profile">Receives 255 for every row of a white stripe and 0 for every other row</param>
+		/// <param name="columnSums">Scratch space for region.cols + 2 * Radius values</param>
+		static void Run(const Mat &region, uchar *profile, ushort *columnSums) {
+			typedef BinomialKernel<Radius> Kernel;
+			Size wholeSize;
+			Point offset;
+			region.locateROI(wholeSize, offset);
+			const uchar *origin = region.data - (offset.y * region.step) - (offset.x * Pixel::Channels);
+			int sumCount = region.cols + (2 * Radius);
+			for (int row = 0; row < region.rows; row++) {
+				const uchar *sources[2 * Radius + 1];
+				for (int tap = 0; tap <= 2 * Radius; tap++) {
+					sources[tap] = origin + (Reflect(offset.y + row + tap - Radius, wholeSize.height) * region.step);
+				}
+
+				// Vertical pass into one sum per column, the columns left and right of the region included
+				for (int column = 0; column < sumCount; column++) {
+					int x = Reflect(offset.x + column - Radius, wholeSize.width) * Pixel::Channels;
+					int sum = 0;
+					for (int tap = 0; tap <= 2 * Radius; tap++) {
+						sum += Kernel::Weight(tap) * Pixel::Luma(sources[tap] + x);
+					}
+
+					columnSums[column] = (ushort)sum;
+				}
+
+				// Horizontal pass, rounding like the fixed-point GaussianBlur, straight into the white pixel count
+				int count = 0;
+				for (int column = 0; column < region.cols; column++) {
+					int sum = 0;
+					for (int tap = 0; tap <= 2 * Radius; tap++) {
+						sum += Kernel::Weight(tap) * columnSums[column + tap];
+					}
+
+					count += Policy::IsWhite((sum + (1 << (2 * Kernel::Shift - 1))) >> (2 * Kernel::Shift));
+				}
+
+				profile[row] = Policy::IsWhiteRow(count, region.cols) ? 255 : 0;
+			}
+		}
+
+	private:
+		/// <summary>
+		/// Mirror an index into [0, size) without repeating the edge, like BORDER_REFLECT_101
+		/// </summary>
+		static inline int Reflect(int index, int size) {
+			if (size == 1) {
+				return 0;
+			}
+
+			while (index < 0 || index >= size) {
+				index = index < 0 ? -index : (2 * size) - 2 - index;
+			}
+
+			return index;
+		}
+	};
+
+	/// <summary>
+	/// Pick the fused kernel for the pixel format of the region and the blur size and threshold of the options
+	/// </summary>
+	/// <param name="region">The stripe region</param>
+	/// <param name="options">The options which select the blur size and threshold</param>
+	/// <param name="profile">Receives 255 for every row of a white stripe and 0 for every other row</param>
+	/// <param name="columnSums">Scratch space for region.cols + 4 values</param>
+	/// <returns>False if no fused kernel is compiled for this configuration, the generic path has to be used</returns>
+	template<typename Pixel>
+	inline bool FusedSegment(const Mat &region, const TrackerOptions &options, uchar *profile, ushort *columnSums) {
+		if (options.threshold != 150) {
+			return false;
+		}
+
+		if (options.blurSize == 5) {
+			FusedSegmentKernel<Pixel, 2, RowFraction<150, 9, 20> >::Run(region, profile, columnSums);
+			return true;
+		}
+
+		if (options.blurSize == 3) {
+			FusedSegmentKernel<Pixel, 1, RowFraction<150, 9, 20> >::Run(region, profile, columnSums);
+			return true;
+		}
+
+		return false;
+	}
+
+	/// <summary>
+	/// Pick the fused kernel for the pixel format of the region and the blur size and threshold of the options
+	/// </summary>
+	/// <param name="region">The grayscale stripe region</param>
+	/// <param name="options">The options which select the blur size and threshold</param>
+	/// <param name="profile">Receives 255 for every row of a white stripe and 0 for every other row</param>
+	/// <param name="columnSums">Scratch space for region.cols + 4 values</param>
+	/// <returns>False if no fused kernel is compiled for this configuration, the generic path has to be used</returns>
+	inline bool FusedSegment(const Mat &region, const TrackerOptions &options, uchar *profile, ushort *columnSums) {
+		return region.type() == CV_8UC1 && FusedSegment<Gray8>(region, options, profile, columnSums);
+	}
+}
+
+#endif
\ No newline at end of file
@@ -0,0 +1,314 @@
+// <copyright file="Instrumentation.h" company="Delft University of Technology">
+// Copyright (c) Delft University of Technology. All rights reserved.
+// </copyright>
+
+#ifndef __INSTRUMENTATION_H__
+#define __INSTRUMENTATION_H__
+
+#include <atomic>
+#include <cstdint>
+#include <string>
+#include "Export.h"
+
+namespace waterleveltracking {
+	/// <summary>
+	/// The stages of the pipeline which are timed
+	/// </summary>
+	enum class Stage {
+		/// <summary>
+		/// Converting the frame or the region to grayscale
+		/// </summary>
+		Gray,
+
+		/// <summary>
+		/// Rotating the frame or resampling the stripe region
+		/// </summary>
+		Warp,
+
+		/// <summary>
+		/// Searching the bottom row of the rotated image
+		/// </summary>
+		BottomScan,
+
+		/// <summary>
+		/// Smoothing the stripe region
+		/// </summary>
+		Blur,
+
+		/// <summary>
+		/// Reducing the stripe region to a row profile
+		/// </summary>
+		Segment,
+
+		/// <summary>
+		/// Counting the stripes in the row profile
+		/// </summary>
+		StripeCount,
+
+		/// <summary>
+		/// The whole frame
+		/// </summary>
+		Frame,
+
+		/// <summary>
+		/// The amount of stages
+		/// </summary>
+		Count
+	};
+
+	/// <summary>
+	/// The reason a frame gave no water level
+	/// </summary>
+	enum class Rejection {
+		/// <summary>
+		/// The frame gave a water level
+		/// </summary>
+		None,
+
+		/// <summary>
+		/// The stripe region lies outside the frame
+		/// </summary>
+		EmptyRegion,
+
+		/// <summary>
+		/// The stripes end before the water is reached
+		/// </summary>
+		IrregularStripes,
+
+		/// <summary>
+		/// Every stripe is above the water
+		/// </summary>
+		AllStripesAboveWater,
+
+		/// <summary>
+		/// The frame is empty or the marker or stripe configuration is wrong
+		/// </summary>
+		InvalidInput,
+
+		/// <summary>
+		/// The amount of reasons
+		/// </summary>
+		Count
+	};
+
+	/// <summary>
+	/// Collects the stage timings and counters of the pipeline into per-thread histograms.
+	/// A thread only writes its own histograms, so recording takes no locks; reading sums the histograms of all threads.
+	/// The pipeline only records when it is built with WLT_ENABLE_INSTRUMENTATION.
+	/// </summary>
+	class Instrumentation {
+	public:
+		/// <summary>
+		/// The amount of buckets of a histogram, bucket i counts the values in [2^(i-1), 2^i)
+		/// </summary>
+		static const int BucketCount = 40;
+
+		/// <summary>
+		/// The amount of events the trace keeps per thread, older events are overwritten
+		/// </summary>
+		static const int TraceCapacity = 4096;
+
+		/// <summary>
+		/// Gets the current time in nanoseconds of a monotonic clock
+		/// </summary>
+		static uint64_t Now();
+
+		/// <summary>
+		/// Record the duration of a stage
+		/// </summary>
+		/// <param name="stage">The timed stage</param>
+		/// <param name="start">The start of the stage in nanoseconds</param>
+		/// <param name="duration">The duration of the stage in nanoseconds</param>
+		static void RecordStage(Stage stage, uint64_t start, uint64_t duration);
+
+		/// <summary>
+		/// Record the size of the stripe region
+		/// </summary>
+		/// <param name="width">The width of the region in pixels</param>
+		/// <param name="height">The height of the region in pixels</param>
+		static void RecordRegion(int width, int height);
+
+		/// <summary>
+		/// Record the amount of counted stripes
+		/// </summary>
+		/// <param name="count">The amount of stripes above the water</param>
+		static void RecordStripes(int count);
+
+		/// <summary>
+		/// Record why a frame gave no water level, or that it gave one
+		/// </summary>
+		/// <param name="rejection">The reason</param>
+		static void RecordRejection(Rejection rejection);
+
+		/// <summary>
+		/// Take the summed duration of every stage the calling thread ran since its last call, and start summing again
+		/// </summary>
+		/// <param name="durations">Receives the duration in nanoseconds of every stage</param>
+		static void TakeFrameDurations(uint64_t durations[]);
+
+		/// <summary>
+		/// Sum the duration histogram of a stage over all threads
+		/// </summary>
+		/// <param name="stage">The timed stage</param>
+		/// <param name="buckets">Receives BucketCount buckets of durations in nanoseconds</param>
+		/// <param name="total">Receives the summed duration in nanoseconds</param>
+		/// <returns>The amount of recorded durations</returns>
+		static uint64_t GetStageHistogram(Stage stage, uint64_t buckets[], uint64_t &total);
+
+		/// <summary>
+		/// Sum the histogram of the region sizes in pixels over all threads
+		/// </summary>
+		/// <param name="buckets">Receives BucketCount buckets of region sizes</param>
+		/// <returns>The amount of recorded regions</returns>
+		static uint64_t GetRegionHistogram(uint64_t buckets[]);
+
+		/// <summary>
+		/// Sum the histogram of the counted stripes over all threads
+		/// </summary>
+		/// <param name="buckets">Receives BucketCount buckets, bucket i counts the frames with i stripes and the last one every frame with more</param>
+		/// <returns>The amount of recorded counts</returns>
+		static uint64_t GetStripeHistogram(uint64_t buckets[]);
+
+		/// <summary>
+		/// Sum the amount of frames with the given outcome over all threads
+		/// </summary>
+		/// <param name="rejection">The reason</param>
+		/// <returns>The amount of frames</returns>
+		static uint64_t GetRejectionCount(Rejection rejection);
+
+		/// <summary>
+		/// Clear the histograms of all threads
+		/// </summary>
+		static void Reset();
+
+		/// <summary>
+		/// Sets whether the stages are also kept as trace events
+		/// </summary>
+		static void SetTraceEnabled(bool enabled);
+
+		/// <summary>
+		/// Write the kept trace events of all threads as a Chrome trace, which can be opened in chrome://tracing
+		/// </summary>
+		/// <param name="path">The path of the JSON file</param>
+		/// <returns>False if the file could not be written</returns>
+		static bool WriteTrace(const std::string &path);
+
+	private:
+		/// <summary>
+		/// Gets the bucket of a value
+		/// </summary>
+		/// <param name="value">The value</param>
+		/// <returns>The index of the bucket</returns>
+		static int Bucket(uint64_t value);
+
+		/// <summary>
+		/// Whether the stages are also kept as trace events
+		/// </summary>
+		static std::atomic<bool> traceEnabled;
+	};
+
+	/// <summary>
+	/// Times a stage from its construction until it goes out of scope
+	/// </summary>
+	class StageTimer {
+	public:
+		/// <summary>
+		/// Initializes a new instance of the <see cref="StageTimer"/> class, which starts timing.
+		/// </summary>
+		/// <param name="stage">The timed stage</param>
+		explicit StageTimer(Stage stage) : stage(stage), start(Instrumentation::Now()) {
+		}
+
+		/// <summary>
+		/// Finalizes an instance of the <see cref="StageTimer"/> class, which records the duration.
+		/// </summary>
+		~StageTimer() {
+			Instrumentation::RecordStage(this->stage, this->start, Instrumentation::Now() - this->start);
+		}
+
+	private:
+		/// <summary>
+		/// The timed stage
+		/// </summary>
+		Stage stage;
+
+		/// <summary>
+		/// The start of the stage in nanoseconds
+		/// </summary>
+		uint64_t start;
+	};
+}
+
+#define WLT_CONCAT_(a, b) a##b
+#define WLT_CONCAT(a, b) WLT_CONCAT_(a, b)
+
+/// <summary>
+/// WLT_TIME_STAGE times the rest of the enclosing scope as the given stage and WLT_RECORD calls a record function of
+/// the instrumentation. Both compile to nothing unless WLT_ENABLE_INSTRUMENTATION is defined.
+/// </summary>
+#ifdef WLT_ENABLE_INSTRUMENTATION
+#define WLT_TIME_STAGE(stage) ::waterleveltracking::StageTimer WLT_CONCAT(stageTimer, __LINE__)(::waterleveltracking::Stage::stage)
+#define WLT_RECORD(call) ::waterleveltracking::Instrumentation::call
+#else
+#define WLT_TIME_STAGE(stage)
+#define WLT_RECORD(call)
+#endif
+
+/// <summary>
+/// Gets whether the library is built with the instrumentation
+/// </summary>
+/// <returns>1 if the pipeline records, 0 if every histogram stays empty</returns>
+WLT_EXPORT int WltIsInstrumentationEnabled();
+
+/// <summary>
+/// Copy the duration histogram of a stage, summed over all threads
+/// </summary>
+/// <param name="stage">The index of the stage in the Stage enum</param>
+/// <param name="buckets">Receives up to bucketCount buckets, bucket i counts the durations in [2^(i-1), 2^i) nanoseconds</param>
+/// <param name="bucketCount">The size of buckets</param>
+/// <param name="totalNanoseconds">Receives the summed duration</param>
+/// <returns>The amount of recorded durations, -1 if the stage does not exist</returns>
+WLT_EXPORT long long WltGetStageHistogram(int stage, unsigned long long *buckets, int bucketCount, unsigned long long *totalNanoseconds);
+
+/// <summary>
+/// Copy the histogram of the stripe region sizes in pixels, summed over all threads
+/// </summary>
+/// <param name="buckets">Receives up to bucketCount buckets, bucket i counts the sizes in [2^(i-1), 2^i)</param>
+/// <param name="bucketCount">The size of buckets</param>
+/// <returns>The amount of recorded regions</returns>
+WLT_EXPORT long long WltGetRegionHistogram(unsigned long long *buckets, int bucketCount);
+
+/// <summary>
+/// Copy the histogram of the counted stripes, summed over all threads
+/// </summary>
+/// <param name="buckets">Receives up to bucketCount buckets, bucket i counts the frames with i stripes</param>
+/// <param name="bucketCount">The size of buckets</param>
+/// <returns>The amount of recorded counts</returns>
+WLT_EXPORT long long WltGetStripeHistogram(unsigned long long *buckets, int bucketCount);
+
+/// <summary>
+/// Gets the amount of frames with the given outcome, summed over all threads
+/// </summary>
+/// <param name="rejection">The index of the reason in the Rejection enum</param>
+/// <returns>The amount of frames, -1 if the reason does not exist</returns>
+WLT_EXPORT long long WltGetRejectionCount(int rejection);
+
+/// <summary>
+/// Clear all histograms
+/// </summary>
+WLT_EXPORT void WltResetInstrumentation();
+
+/// <summary>
+/// Sets whether the stages are also kept as trace events
+/// </summary>
+/// <param name="enabled">Non zero to keep the events</param>
+WLT_EXPORT void WltSetTraceEnabled(int enabled);
+
+/// <summary>
+/// Write the kept trace events as a Chrome trace
+/// </summary>
+/// <param name="path">The path of the JSON file</param>
+/// <returns>1 if the file was written, 0 otherwise</returns>
+WLT_EXPORT int WltWriteTrace(const char *path);
+
+#endif
\ No newline at end of file
@@ -0,0 +1,98 @@
+// <copyright file="JpegRegionDecoder.h" company="Delft University of Technology">
+// Copyright (c) Delft University of Technology. All rights reserved.
+// </copyright>
+
+#ifndef __JPEGREGIONDECODER_H__
+#define __JPEGREGIONDECODER_H__
+
+#include <cstddef>
+#include <opencv2/opencv.hpp>
+
+using namespace cv;
+
+namespace waterleveltracking {
+	/// <summary>
+	/// Decodes only the luma of the scanlines and MCU columns of a JPEG image which cover a region, for instance the stripe region of a marker.
+	/// The rows above the region are skipped without the inverse DCT and the rows below it are never read; the entropy decoding of the skipped MCUs remains.
+	/// Requires a build with WLT_WITH_LIBJPEG_TURBO, otherwise no image can be opened.
+	/// </summary>
+	class JpegRegionDecoder
+	{
+	public:
+		/// <summary>
+		/// Initializes a new instance of the <see cref="JpegRegionDecoder"/> class.
+		/// </summary>
+		JpegRegionDecoder();
+
+		/// <summary>
+		/// Releases the decompressor.
+		/// </summary>
+		~JpegRegionDecoder();
+
+		/// <summary>
+		/// Read the header of a JPEG image, the bytes must stay valid until the image is decoded
+		/// </summary>
+		/// <param name="data">The compressed image</param>
+		/// <param name="size">The size of the compressed image in bytes</param>
+		/// <param name="frameSize">Receives the size of the image</param>
+		/// <returns>False if the bytes are not a JPEG image or the library is built without libjpeg-turbo</returns>
+		bool Open(const unsigned char *data, size_t size, Size &frameSize);
+
+		/// <summary>
+		/// Decode the region of the opened image into a grayscale frame of the size of the image.
+		/// The region is widened to whole MCU columns, the pixels outside it are black.
+		/// </summary>
+		/// <param name="region">The region to decode, an empty region decodes nothing</param>
+		/// <param name="frame">Receives the grayscale frame, which shares the scratch buffer of the decoder</param>
+		/// <returns>False if no image is open or the image is corrupt</returns>
+		bool Decode(Rect region, Mat &frame);
+
+		/// <summary>
+		/// Gets the region the last call to Decode decoded, widened to whole MCU columns
+		/// </summary>
+		Rect GetDecodedRegion();
+
+		/// <summary>
+		/// Gets whether the library is built with libjpeg-turbo
+		/// </summary>
+		static bool IsAvailable();
+
+	private:
+		/// <summary>
+		/// The decompressor of libjpeg-turbo and its error handler, kept out of this header
+		/// </summary>
+		struct Context;
+
+		/// <summary>
+		/// The decompressor, NULL when the library is built without libjpeg-turbo
+		/// </summary>
+		Context *context;
+
+		/// <summary>
+		/// Whether the header of an image was read and the image is not decoded yet
+		/// </summary>
+		bool open;
+
+		/// <summary>
+		/// Scratch buffer for the grayscale frame
+		/// </summary>
+		Mat frameBuffer;
+
+		/// <summary>
+		/// The region the last call to Decode decoded
+		/// </summary>
+		Rect decodedRegion;
+
+		/// <summary>
+		/// The decoder owns its decompressor, it cannot be copied
+		/// </summary>
+		JpegRegionDecoder(const JpegRegionDecoder&) = delete;
+
+		/// <summary>
+		/// The decoder owns its decompressor, it cannot be copied
+		/// </summary>
+		JpegRegionDecoder &operator=(const JpegRegionDecoder&) = delete;
+	};
+}
+
+#endif
\ No newline at end of file
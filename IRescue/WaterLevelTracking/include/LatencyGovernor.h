@@ -0,0 +1,169 @@
+// <copyright file="LatencyGovernor.h" company="Delft University of Technology">
+// Copyright (c) Delft University of Technology. All rights reserved.
+// </copyright>
+
+#ifndef __LATENCYGOVERNOR_H__
+#define __LATENCYGOVERNOR_H__
+
+#include <algorithm>
+#include "TrackerOptions.h"
+
+namespace waterleveltracking {
+	/// <summary>
+	/// Keeps the processing time of a frame within a budget by stepping the quality of the tracker options down while the
+	/// smoothed cost of the processed frames exceeds the budget, and back up once it stays well below it.
+	/// Quality level 0 processes frames as configured, every higher level is coarser:
+	/// 1 blurs with a 3x3 kernel, halves the bands and samples every other column of the stripe region, 2 samples every fourth
+	/// column and analyses the stripes at a lower resolution, 3 lowers the resolution further, quarters the bands and skips every
+	/// other frame, 4 processes only every fourth frame. In the OrientedRegion and FixedCamera modes every level samples fewer pixels
+	/// or processes fewer frames than the one before it.
+	/// </summary>
+	class LatencyGovernor
+	{
+	public:
+		/// <summary>
+		/// Initializes a new instance of the <see cref="LatencyGovernor"/> class.
+		/// </summary>
+		/// <param name="budget">The time in seconds a frame may cost, 0 to always process at the configured quality</param>
+		/// <param name="smoothing">The weight of the newest cost in the moving average, between 0 and 1</param>
+		LatencyGovernor(double budget = 0, double smoothing = 0.2);
+
+		/// <summary>
+		/// Decide whether the next frame is processed or skipped at the active quality level
+		/// </summary>
+		/// <returns>True if the frame has to be processed, false if the level of the last processed frame is used</returns>
+		bool Admit();
+
+		/// <summary>
+		/// Add the cost of a processed frame to the moving average and step the quality level if the average
+		/// stayed on one side of the budget for long enough
+		/// </summary>
+		/// <param name="cost">The time in seconds the frame took</param>
+		/// <returns>True if the quality level changed, the options have to be applied again</returns>
+		bool Record(double cost);
+
+		/// <summary>
+		/// Lower the quality of the configured options to the active quality level
+		/// </summary>
+		/// <param name="options">The options as configured</param>
+		/// <returns>The options to process the frames with</returns>
+		TrackerOptions Apply(TrackerOptions options);
+
+		/// <summary>
+		/// Return to the configured quality and forget the measured cost
+		/// </summary>
+		void Reset();
+
+		/// <summary>
+		/// Gets the active quality level, 0 is the configured quality and MaxQualityLevel the coarsest
+		/// </summary>
+		int GetQualityLevel();
+
+		/// <summary>
+		/// Gets the budget
+		/// </summary>
+		double GetBudget();
+
+		/// <summary>
+		/// Sets the budget, 0 returns to the configured quality
+		/// </summary>
+		void SetBudget(double budget);
+
+		/// <summary>
+		/// Gets the moving average of the cost in seconds of the processed frames at the active quality level
+		/// </summary>
+		double GetAverageCost();
+
+		/// <summary>
+		/// Gets the amount of frames which were skipped
+		/// </summary>
+		long long GetSkippedCount();
+
+		/// <summary>
+		/// The coarsest quality level
+		/// </summary>
+		static const int MaxQualityLevel = 4;
+
+	private:
+		/// <summary>
+		/// Gets the amount of frames skipped after every processed frame at a quality level
+		/// </summary>
+		/// <param name="qualityLevel">The quality level</param>
+		/// <returns>The amount of skipped frames</returns>
+		static int FrameSkip(int qualityLevel);
+
+		/// <summary>
+		/// Move to another quality level and start measuring its cost from scratch
+		/// </summary>
+		/// <param name="qualityLevel">The new quality level</param>
+		void Step(int qualityLevel);
+
+		/// <summary>
+		/// The amount of processed frames in a row over the budget before the quality is lowered
+		/// </summary>
+		static const int StepDownFrames = 3;
+
+		/// <summary>
+		/// The amount of processed frames in a row well below the budget before the quality is raised
+		/// </summary>
+		static const int StepUpFrames = 30;
+
+		/// <summary>
+		/// The percentage of the budget the cost has to stay below at the frame rate of the finer level before the quality is raised,
+		/// which leaves room for the finer level to cost about twice as much without stepping straight back down
+		/// </summary>
+		static const int StepUpPercent = 50;
+
+		/// <summary>
+		/// The minimum stripe height in pixels at quality level 2, halved at every level above it
+		/// </summary>
+		static const int CoarseStripePixelHeight = 8;
+
+		/// <summary>
+		/// The time in seconds a frame may cost
+		/// </summary>
+		double budget;
+
+		/// <summary>
+		/// The weight of the newest cost in the moving average
+		/// </summary>
+		double smoothing;
+
+		/// <summary>
+		/// The moving average of the cost in seconds of the processed frames
+		/// </summary>
+		double averageCost;
+
+		/// <summary>
+		/// Whether a frame was processed at the active quality level
+		/// </summary>
+		bool hasCost;
+
+		/// <summary>
+		/// The active quality level
+		/// </summary>
+		int qualityLevel;
+
+		/// <summary>
+		/// The amount of processed frames in a row over the budget
+		/// </summary>
+		int overCount;
+
+		/// <summary>
+		/// The amount of processed frames in a row well below the budget
+		/// </summary>
+		int underCount;
+
+		/// <summary>
+		/// The amount of frames skipped since the last processed frame
+		/// </summary>
+		int framesSinceProcessed;
+
+		/// <summary>
+		/// The amount of frames which were skipped
+		/// </summary>
+		long long skippedCount;
+	};
+}
+
+#endif
\ No newline at end of file
@@ -0,0 +1,138 @@
+// <copyright file="LevelBoard.h" company="Delft University of Technology">
+// Copyright (c) Delft University of Technology. All rights reserved.
+// </copyright>
+
+#ifndef __LEVELBOARD_H__
+#define __LEVELBOARD_H__
+
+#include <atomic>
+#include <thread>
+#include "Export.h"
+#include "Instrumentation.h"
+#include "TripleBuffer.h"
+
+/// <summary>
+/// The amount of stage timings in a level sample, one per stage of the Stage enum
+/// </summary>
+#define WLT_STAGE_COUNT 7
+
+/// <summary>
+/// The newest water level of a marker as the render thread reads it
+/// </summary>
+typedef struct WltLevelSample {
+	/// <summary>
+	/// The number of the sample, counting from 1 per marker. A reader that sees the same number twice got no new level
+	/// </summary>
+	long long sequence;
+
+	/// <summary>
+	/// The timestamp of the frame in microseconds, in the clock of the publisher
+	/// </summary>
+	long long timestamp;
+
+	/// <summary>
+	/// The height of the water in meters, NULL if it cannot be derived from the frame
+	/// </summary>
+	double level;
+
+	/// <summary>
+	/// How much the level can be trusted, from 0 to 1
+	/// </summary>
+	double confidence;
+
+	/// <summary>
+	/// The time in seconds every stage took for the frame, zero when the instrumentation is compiled out
+	/// </summary>
+	double stageTimings[WLT_STAGE_COUNT];
+} WltLevelSample;
+
+namespace waterleveltracking {
+	/// <summary>
+	/// A fixed set of result slots, one per marker, through which processing threads hand the newest level to the render thread.
+	/// Reading is wait-free, so a publisher can never make the render thread miss a frame.
+	/// Publishers of the same slot take turns, so several streams or callers may publish a marker; a slot takes one reader at a time.
+	/// </summary>
+	class LevelBoard
+	{
+	public:
+		/// <summary>
+		/// The amount of markers the board has a slot for
+		/// </summary>
+		static const int MarkerCapacity = 64;
+
+		/// <summary>
+		/// Publish the level of a frame with the stage timings the calling thread recorded since it last published
+		/// </summary>
+		/// <param name="marker">The slot of the marker</param>
+		/// <param name="level">The height of the water in meters</param>
+		/// <param name="confidence">How much the level can be trusted, from 0 to 1</param>
+		/// <param name="timestamp">The timestamp of the frame in microseconds</param>
+		/// <returns>False if the slot does not exist</returns>
+		static bool Publish(int marker, double level, double confidence, long long timestamp);
+
+		/// <summary>
+		/// Publish a sample, its sequence number is assigned by the board. Publishers of the same slot take turns
+		/// </summary>
+		/// <param name="marker">The slot of the marker</param>
+		/// <param name="sample">The sample to publish</param>
+		/// <returns>False if the slot does not exist</returns>
+		static bool Publish(int marker, WltLevelSample sample);
+
+		/// <summary>
+		/// Read the newest sample of a marker
+		/// </summary>
+		/// <param name="marker">The slot of the marker</param>
+		/// <param name="sample">The newest sample</param>
+		/// <returns>False if the slot does not exist or nothing was published to it yet</returns>
+		static bool Read(int marker, WltLevelSample &sample);
+
+	private:
+		/// <summary>
+		/// The result slot of a marker
+		/// </summary>
+		struct Slot {
+			/// <summary>
+			/// The newest sample
+			/// </summary>
+			TripleBuffer<WltLevelSample> buffer;
+
+			/// <summary>
+			/// The sequence number of the last published sample, only touched by the publisher which holds the slot
+			/// </summary>
+			long long sequence;
+
+			/// <summary>
+			/// Set while a publisher writes the slot, the triple buffer takes only one writer at a time
+			/// </summary>
+			std::atomic<bool> publishing;
+		};
+
+		/// <summary>
+		/// The slot of every marker
+		/// </summary>
+		static Slot slots[MarkerCapacity];
+	};
+}
+
+/// <summary>
+/// Publish the level of a marker for the render thread. The sequence number of the sample is assigned here
+/// </summary>
+/// <param name="marker">The slot of the marker, from 0 to the capacity of the board</param>
+/// <param name="sample">The sample to publish</param>
+/// <returns>1 on success, -1 if the input is wrong</returns>
+WLT_EXPORT int WltPublishLevel(int marker, const WltLevelSample *sample);
+
+/// <summary>
+/// Read the newest level of a marker without waiting, only one thread may read a marker at a time
+/// </summary>
+/// <param name="marker">The slot of the marker, from 0 to the capacity of the board</param>
+/// <param name="sample">Receives the newest sample</param>
+/// <returns>1 if a sample was read, 0 if nothing was published yet, -1 if the input is wrong</returns>
+WLT_EXPORT int WltReadLevel(int marker, WltLevelSample *sample);
+
+/// <summary>
+/// Gets the amount of markers the board has a slot for
+/// </summary>
+WLT_EXPORT int WltGetLevelBoardCapacity();
+
+#endif
\ No newline at end of file
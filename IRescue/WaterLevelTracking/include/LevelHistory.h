@@ -0,0 +1,462 @@
+// <copyright file="LevelHistory.h" company="Delft University of Technology">
+// Copyright (c) Delft University of Technology. All rights reserved.
+// </copyright>
+
+#ifndef __LEVELHISTORY_H__
+#define __LEVELHISTORY_H__
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <vector>
+#include "Export.h"
+#include "TrackingResult.h"
+
+/// <summary>
+/// The statistics of the levels of a marker over a sliding window which ends at the newest sample
+/// </summary>
+typedef struct WltLevelStatistics {
+	/// <summary>
+	/// The length of the window in microseconds
+	/// </summary>
+	long long window;
+
+	/// <summary>
+	/// The amount of samples with a level in the window
+	/// </summary>
+	long long count;
+
+	/// <summary>
+	/// The lowest level in the window in meters
+	/// </summary>
+	double minimum;
+
+	/// <summary>
+	/// The highest level in the window in meters
+	/// </summary>
+	double maximum;
+
+	/// <summary>
+	/// The mean level in the window in meters
+	/// </summary>
+	double mean;
+
+	/// <summary>
+	/// The slope of the least squares line through the levels in the window in meters per hour, 0 if it cannot be fitted
+	/// </summary>
+	double rateOfRise;
+} WltLevelStatistics;
+
+namespace waterleveltracking {
+	/// <summary>
+	/// The recent levels of a single marker with their timestamps and bit-packed row profiles, in memory which is allocated once.
+	/// The samples are kept in a ring which overwrites the oldest sample. Next to it every window splits its time into a fixed
+	/// amount of buckets, so the minimum, maximum, mean and rate of rise of the window are kept up to date in constant time per
+	/// sample and the window ends on the resolution of one bucket. The history takes one thread at a time.
+	/// </summary>
+	class LevelHistory
+	{
+	public:
+		/// <summary>
+		/// The most windows a history keeps statistics for
+		/// </summary>
+		static const int MaxWindowCount = 4;
+
+		/// <summary>
+		/// The amount of buckets a window is split into
+		/// </summary>
+		static const int BucketCount = 60;
+
+		/// <summary>
+		/// The height in meters of one step of a stored level
+		/// </summary>
+		static const double LevelStep;
+
+		/// <summary>
+		/// The highest level in meters a sample can hold, and the negative of the lowest. A level beyond it is stored as a frame which gave no level
+		/// </summary>
+		static const double MaxLevel;
+
+		/// <summary>
+		/// Initializes a new instance of the <see cref="LevelHistory"/> class with windows of a minute, an hour and a day.
+		/// </summary>
+		/// <param name="capacity">The amount of samples the ring holds</param>
+		/// <param name="profileRows">The amount of rows a row profile is resampled to before it is stored</param>
+		LevelHistory(int capacity = 4096, int profileRows = 256);
+
+		/// <summary>
+		/// Initializes a new instance of the <see cref="LevelHistory"/> class.
+		/// </summary>
+		/// <param name="capacity">The amount of samples the ring holds</param>
+		/// <param name="profileRows">The amount of rows a row profile is resampled to before it is stored</param>
+		/// <param name="windows">The length of every window in microseconds</param>
+		/// <param name="windowCount">The amount of windows, at most MaxWindowCount</param>
+		LevelHistory(int capacity, int profileRows, const long long windows[], int windowCount);
+
+		/// <summary>
+		/// Add the level of a frame without a row profile
+		/// </summary>
+		/// <param name="timestamp">The timestamp of the frame in microseconds, not negative and not earlier than that of the previous sample</param>
+		/// <param name="level">The height of the water in meters, ignored if the frame gave no level, kept as no level if it is not finite or beyond 2147483.647 meters up or down</param>
+		/// <param name="valid">Whether the frame gave a level, the status of the frame is WLT_STATUS_OK</param>
+		/// <returns>False if the timestamp is negative or earlier than that of the previous sample</returns>
+		bool Add(long long timestamp, double level, bool valid);
+
+		/// <summary>
+		/// Add the level of a frame with the row profile it was counted from
+		/// </summary>
+		/// <param name="timestamp">The timestamp of the frame in microseconds, not negative and not earlier than that of the previous sample</param>
+		/// <param name="level">The height of the water in meters, ignored if the frame gave no level, kept as no level if it is not finite or beyond 2147483.647 meters up or down</param>
+		/// <param name="valid">Whether the frame gave a level, the status of the frame is WLT_STATUS_OK</param>
+		/// <param name="profile">The row profile of the stripe region, 255 for every row of a white stripe and 0 for every other row</param>
+		/// <returns>False if the timestamp is negative or earlier than that of the previous sample</returns>
+		bool Add(long long timestamp, double level, bool valid, const std::vector<unsigned char> &profile);
+
+		/// <summary>
+		/// Gets a stored sample
+		/// </summary>
+		/// <param name="age">0 for the newest sample, 1 for the one before it and so on</param>
+		/// <param name="timestamp">Receives the timestamp of the sample in microseconds</param>
+		/// <param name="level">Receives the height of the water in meters, NULL if the frame gave no level</param>
+		/// <param name="valid">Receives whether the frame gave a level, a level of 0 is a real level when it did</param>
+		/// <returns>False if there is no sample of this age</returns>
+		bool GetSample(int age, long long &timestamp, double &level, bool &valid) const;
+
+		/// <summary>
+		/// Gets the row profile of a stored sample
+		/// </summary>
+		/// <param name="age">0 for the newest sample, 1 for the one before it and so on</param>
+		/// <param name="profile">Receives 255 for every row of a white stripe and 0 for every other row, at least the amount of profile rows</param>
+		/// <returns>The amount of rows written, 0 if the sample has no profile, -1 if there is no sample of this age</returns>
+		int GetProfile(int age, unsigned char profile[]) const;
+
+		/// <summary>
+		/// Gets the statistics of a window
+		/// </summary>
+		/// <param name="window">The index of the window</param>
+		/// <param name="statistics">Receives the statistics of the window</param>
+		/// <returns>False if the window does not exist</returns>
+		bool GetStatistics(int window, WltLevelStatistics &statistics) const;
+
+		/// <summary>
+		/// Gets the amount of stored samples
+		/// </summary>
+		int GetCount() const;
+
+		/// <summary>
+		/// Gets the amount of samples the ring holds
+		/// </summary>
+		int GetCapacity() const;
+
+		/// <summary>
+		/// Gets the amount of rows a stored row profile has
+		/// </summary>
+		int GetProfileRows() const;
+
+		/// <summary>
+		/// Gets the amount of windows
+		/// </summary>
+		int GetWindowCount() const;
+
+	private:
+		/// <summary>
+		/// The sums of the levels which fell in one bucket of a window, the times are in seconds from the start of the bucket
+		/// </summary>
+		struct Bucket {
+			/// <summary>
+			/// The number of the bucket counting from time zero, -1 if the bucket holds nothing
+			/// </summary>
+			long long index;
+
+			/// <summary>
+			/// The amount of levels
+			/// </summary>
+			int count;
+
+			/// <summary>
+			/// The lowest level
+			/// </summary>
+			double minimum;
+
+			/// <summary>
+			/// The highest level
+			/// </summary>
+			double maximum;
+
+			/// <summary>
+			/// The sum of the levels
+			/// </summary>
+			double sumLevel;
+
+			/// <summary>
+			/// The sum of the times
+			/// </summary>
+			double sumTime;
+
+			/// <summary>
+			/// The sum of the squared times
+			/// </summary>
+			double sumTimeSquared;
+
+			/// <summary>
+			/// The sum of the times multiplied by their levels
+			/// </summary>
+			double sumTimeLevel;
+		};
+
+		/// <summary>
+		/// A sliding window over the newest BucketCount buckets
+		/// </summary>
+		struct Window {
+			/// <summary>
+			/// The length of the window in microseconds
+			/// </summary>
+			long long duration;
+
+			/// <summary>
+			/// The length of a bucket in microseconds
+			/// </summary>
+			long long bucketDuration;
+
+			/// <summary>
+			/// The buckets, the bucket with number i is kept at i modulo BucketCount
+			/// </summary>
+			Bucket buckets[BucketCount];
+
+			/// <summary>
+			/// The number of the oldest bucket which may still hold levels, -1 if the window is empty
+			/// </summary>
+			long long oldest;
+
+			/// <summary>
+			/// The number of the newest bucket, -1 if the window is empty
+			/// </summary>
+			long long newest;
+
+			/// <summary>
+			/// The timestamp in microseconds the times of the totals are measured from
+			/// </summary>
+			long long anchor;
+
+			/// <summary>
+			/// The number of the bucket at which the totals are summed from the buckets again, which drops the rounding errors of removing buckets
+			/// </summary>
+			long long rebuild;
+
+			/// <summary>
+			/// The sums of all buckets of the window, the times are in seconds from the anchor
+			/// </summary>
+			Bucket total;
+
+			/// <summary>
+			/// The numbers of the buckets whose minimum is lower than that of every newer bucket, from old to new
+			/// </summary>
+			long long minima[BucketCount];
+
+			/// <summary>
+			/// The numbers of the buckets whose maximum is higher than that of every newer bucket, from old to new
+			/// </summary>
+			long long maxima[BucketCount];
+
+			/// <summary>
+			/// The position of the oldest entry in the minima
+			/// </summary>
+			int minimaStart;
+
+			/// <summary>
+			/// The amount of entries in the minima
+			/// </summary>
+			int minimaCount;
+
+			/// <summary>
+			/// The position of the oldest entry in the maxima
+			/// </summary>
+			int maximaStart;
+
+			/// <summary>
+			/// The amount of entries in the maxima
+			/// </summary>
+			int maximaCount;
+		};
+
+		/// <summary>
+		/// The level of a sample which has no level
+		/// </summary>
+		static const int32_t MissingLevel = INT32_MIN;
+
+		/// <summary>
+		/// Set up the ring and the windows
+		/// </summary>
+		/// <param name="capacity">The amount of samples the ring holds</param>
+		/// <param name="profileRows">The amount of rows a row profile is resampled to before it is stored</param>
+		/// <param name="windows">The length of every window in microseconds</param>
+		/// <param name="windowCount">The amount of windows</param>
+		void Initialize(int capacity, int profileRows, const long long windows[], int windowCount);
+
+		/// <summary>
+		/// Store a sample in the ring and add its level to every window
+		/// </summary>
+		/// <param name="timestamp">The timestamp of the frame in microseconds</param>
+		/// <param name="level">The height of the water in meters, ignored if the frame gave no level, stored as no level if it is not finite or beyond MaxLevel</param>
+		/// <param name="valid">Whether the frame gave a level, the status of the frame is WLT_STATUS_OK</param>
+		/// <returns>The position of the sample in the ring, -1 if the timestamp is negative or earlier than that of the previous sample</returns>
+		int Store(long long timestamp, double level, bool valid);
+
+		/// <summary>
+		/// Gets the position in the ring of a stored sample
+		/// </summary>
+		/// <param name="age">0 for the newest sample, 1 for the one before it and so on</param>
+		/// <returns>The position, -1 if there is no sample of this age</returns>
+		int Position(int age) const;
+
+		/// <summary>
+		/// Empty a window
+		/// </summary>
+		/// <param name="window">The window</param>
+		static void Clear(Window &window);
+
+		/// <summary>
+		/// Move the end of a window to a timestamp, removing the buckets which fell out of it
+		/// </summary>
+		/// <param name="window">The window</param>
+		/// <param name="timestamp">The timestamp of the newest sample in microseconds</param>
+		static void Advance(Window &window, long long timestamp);
+
+		/// <summary>
+		/// Add a level to a window which was advanced to its timestamp, opening a new bucket when needed
+		/// </summary>
+		/// <param name="window">The window</param>
+		/// <param name="timestamp">The timestamp of the level in microseconds</param>
+		/// <param name="level">The level in meters</param>
+		static void AddLevel(Window &window, long long timestamp, double level);
+
+		/// <summary>
+		/// Remove the buckets up to a number from a window
+		/// </summary>
+		/// <param name="window">The window</param>
+		/// <param name="last">The number of the newest bucket to remove</param>
+		static void Expire(Window &window, long long last);
+
+		/// <summary>
+		/// Add or subtract the sums of a bucket to the totals of a window
+		/// </summary>
+		/// <param name="window">The window</param>
+		/// <param name="bucket">The bucket</param>
+		/// <param name="sign">1 to add the bucket, -1 to subtract it</param>
+		static void Accumulate(Window &window, const Bucket &bucket, double sign);
+
+		/// <summary>
+		/// Sum the totals of a window from its buckets again, measuring the times from the start of its oldest bucket
+		/// </summary>
+		/// <param name="window">The window</param>
+		static void Rebuild(Window &window);
+
+		/// <summary>
+		/// The timestamp of every sample in microseconds
+		/// </summary>
+		std::vector<long long> timestamps;
+
+		/// <summary>
+		/// The level of every sample in steps of LevelStep, MissingLevel if the frame gave no level
+		/// </summary>
+		std::vector<int32_t> levels;
+
+		/// <summary>
+		/// The row profile of every sample with one bit per row, set for the rows of a white stripe
+		/// </summary>
+		std::vector<uint64_t> profiles;
+
+		/// <summary>
+		/// Whether every sample has a row profile
+		/// </summary>
+		std::vector<bool> profiled;
+
+		/// <summary>
+		/// The amount of 64 bit words of a stored row profile
+		/// </summary>
+		int profileWords;
+
+		/// <summary>
+		/// The amount of rows a stored row profile has
+		/// </summary>
+		int profileRows;
+
+		/// <summary>
+		/// The position in the ring the next sample is stored at
+		/// </summary>
+		int next;
+
+		/// <summary>
+		/// The amount of stored samples
+		/// </summary>
+		int count;
+
+		/// <summary>
+		/// The windows the statistics are kept for
+		/// </summary>
+		Window windows[MaxWindowCount];
+
+		/// <summary>
+		/// The amount of windows
+		/// </summary>
+		int windowCount;
+	};
+}
+
+/// <summary>
+/// Create a history which keeps the recent levels of a single marker and their statistics in memory which is allocated once
+/// </summary>
+/// <param name="capacity">The amount of samples the history holds</param>
+/// <param name="profileRows">The amount of rows a row profile is resampled to before it is stored, 0 to store no row profiles</param>
+/// <param name="windows">The length of every window in microseconds, NULL for windows of a minute, an hour and a day</param>
+/// <param name="windowCount">The amount of windows, at most 4</param>
+/// <returns>The history, NULL if the input is wrong</returns>
+WLT_EXPORT void *WltCreateLevelHistory(int capacity, int profileRows, const long long *windows, int windowCount);
+
+/// <summary>
+/// Destroy a history created by WltCreateLevelHistory
+/// </summary>
+/// <param name="history">The history, may be NULL</param>
+WLT_EXPORT void WltDestroyLevelHistory(void *history);
+
+/// <summary>
+/// Add the level of a frame to a history, without a row profile
+/// </summary>
+/// <param name="history">The history</param>
+/// <param name="timestamp">The timestamp of the frame in microseconds, not negative and not earlier than that of the previous sample</param>
+/// <param name="level">The height of the water in meters, ignored if the frame gave no level, kept as no level if it is not finite or beyond 2147483.647 meters up or down</param>
+/// <param name="status">The WltStatus of the frame, only a frame with WLT_STATUS_OK adds its level</param>
+/// <returns>1 on success, -1 if the input is wrong</returns>
+WLT_EXPORT int WltAddLevel(void *history, long long timestamp, double level, int status);
+
+/// <summary>
+/// Read the statistics of a window of a history
+/// </summary>
+/// <param name="history">The history</param>
+/// <param name="window">The index of the window</param>
+/// <param name="statistics">Receives the statistics of the window</param>
+/// <returns>1 on success, 0 if the window holds no level, -1 if the input is wrong</returns>
+WLT_EXPORT int WltGetLevelStatistics(void *history, int window, WltLevelStatistics *statistics);
+
+/// <summary>
+/// Read the newest samples of a history, from old to new
+/// </summary>
+/// <param name="history">The history</param>
+/// <param name="timestamps">Receives the timestamp of every sample in microseconds</param>
+/// <param name="levels">Receives the level of every sample in meters, NULL for frames which gave no level</param>
+/// <param name="valid">Receives 1 for every sample with a level and 0 for the frames which gave no level, may be NULL</param>
+/// <param name="capacity">The amount of samples the arrays can hold</param>
+/// <returns>The amount of samples read, -1 if the input is wrong</returns>
+WLT_EXPORT int WltGetLevelSamples(void *history, long long *timestamps, double *levels, int *valid, int capacity);
+
+/// <summary>
+/// Read the row profile of a sample of a history
+/// </summary>
+/// <param name="history">The history</param>
+/// <param name="age">0 for the newest sample, 1 for the one before it and so on</param>
+/// <param name="profile">Receives 255 for every row of a white stripe and 0 for every other row</param>
+/// <param name="capacity">The amount of rows the array can hold, at least the amount of profile rows of the history</param>
+/// <returns>The amount of rows read, 0 if the sample has no row profile, -1 if the input is wrong</returns>
+WLT_EXPORT int WltGetLevelProfile(void *history, int age, unsigned char *profile, int capacity);
+
+#endif
\ No newline at end of file
@@ -0,0 +1,78 @@
+// <copyright file="MappedFile.h" company="Delft University of Technology">
+// Copyright (c) Delft University of Technology. All rights reserved.
+// </copyright>
+
+#ifndef __MAPPEDFILE_H__
+#define __MAPPEDFILE_H__
+
+#include <cstdint>
+#include <string>
+
+namespace waterleveltracking {
+	/// <summary>
+	/// A file mapped read only into memory, so its bytes can be used without copying them
+	/// </summary>
+	class MappedFile
+	{
+	public:
+		/// <summary>
+		/// Initializes a new instance of the <see cref="MappedFile"/> class.
+		/// </summary>
+		MappedFile();
+
+		/// <summary>
+		/// Unmaps the file.
+		/// </summary>
+		~MappedFile();
+
+		/// <summary>
+		/// Map a file, the file is expected to be read mostly in order
+		/// </summary>
+		/// <param name="path">The path of the file</param>
+		/// <returns>False if the file cannot be mapped or is empty</returns>
+		bool Open(const std::string &path);
+
+		/// <summary>
+		/// Unmap the file, the bytes become invalid
+		/// </summary>
+		void Close();
+
+		/// <summary>
+		/// Gets the first byte of the file, nullptr if no file is mapped
+		/// </summary>
+		const uint8_t *GetData();
+
+		/// <summary>
+		/// Gets the size of the file in bytes
+		/// </summary>
+		uint64_t GetSize();
+
+	private:
+		/// <summary>
+		/// The first byte of the mapped file
+		/// </summary>
+		const uint8_t *data;
+
+		/// <summary>
+		/// The size in bytes of the file
+		/// </summary>
+		uint64_t size;
+
+		/// <summary>
+		/// The handle of the mapping, the file descriptor on POSIX systems
+		/// </summary>
+		intptr_t mapping;
+
+		/// <summary>
+		/// The mapping owns its view, it cannot be copied
+		/// </summary>
+		MappedFile(const MappedFile&) = delete;
+
+		/// <summary>
+		/// The mapping owns its view, it cannot be copied
+		/// </summary>
+		MappedFile &operator=(const MappedFile&) = delete;
+	};
+}
+
+#endif
\ No newline at end of file
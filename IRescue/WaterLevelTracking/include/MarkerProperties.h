@@ -23,7 +23,18 @@ namespace waterleveltracking {
 		/// <param name="markerCornerPixelLocations">Array of size 8 with the 4 x and y pixel positions of the edges in the camera feed [bottom left x, bottom left y, bottom right x, bottom right y, top right x, top right y, top left x, top left y]</param>
 		/// <param name="distanceToStripes">The distance in meters from the center of the marker to the first stripe</param>
 		/// <param name="markerHeight">The height of the center of the marker in meters</param>
-		MarkerProperties(int corners[], double markerSize, double distanceToStripes, double markerHeight);
+		MarkerProperties(const int corners[], double markerSize, double distanceToStripes, double markerHeight);
+
+		/// <summary>
+		/// Initializes a new instance of the <see cref="MarkerProperties"/> class with a center and meter to pixel factor which were calculated before.
+		/// </summary>
+		/// <param name="corners">Array of size 8 with the 4 x and y pixel positions of the edges in the camera feed [bottom left x, bottom left y, bottom right x, bottom right y, top right x, top right y, top left x, top left y]</param>
+		/// <param name="center">The center of the marker in pixels</param>
+		/// <param name="meterToPixelFactor">The factor to convert a meter to a pixel</param>
+		/// <param name="markerSize">The size of the marker in meters</param>
+		/// <param name="distanceToStripes">The distance in meters from the center of the marker to the first stripe</param>
+		/// <param name="markerHeight">The height of the center of the marker in meters</param>
+		MarkerProperties(const int corners[], Point center, double meterToPixelFactor, double markerSize, double distanceToStripes, double markerHeight);
 
 		/// <summary>
 		/// Recalculates the center of the marker
@@ -33,7 +44,7 @@ namespace waterleveltracking {
 		/// <summary>
 		/// Gets the corners
 		/// </summary>
-		Square GetCorners();
+		Square GetCorners() const;
 
 		/// <summary>
 		/// Sets the corners
@@ -43,7 +54,7 @@ namespace waterleveltracking {
 		/// <summary>
 		/// Gets the marker size
 		/// </summary>
-		double GetMarkerSize();
+		double GetMarkerSize() const;
 
 		/// <summary>
 		/// Sets the marker size
@@ -53,7 +64,7 @@ namespace waterleveltracking {
 		/// <summary>
 		/// Gets the meter to pixel factor
 		/// </summary>
-		double GetMeterToPixelFactor();
+		double GetMeterToPixelFactor() const;
 
 		/// <summary>
 		/// Sets the meter to pixel factor
@@ -63,7 +74,7 @@ namespace waterleveltracking {
 		/// <summary>
 		/// Gets the marker height
 		/// </summary>
-		double GetMarkerHeight();
+		double GetMarkerHeight() const;
 
 		/// <summary>
 		/// Sets the marker height
@@ -73,7 +84,7 @@ namespace waterleveltracking {
 		/// <summary>
 		/// Gets the distance to stripes
 		/// </summary>
-		double GetDistanceToStripes();
+		double GetDistanceToStripes() const;
 
 		/// <summary>
 		/// Sets the distance to stripes
@@ -83,7 +94,7 @@ namespace waterleveltracking {
 		/// <summary>
 		/// Gets the center
 		/// </summary>
-		cv::Point GetCenter();
+		cv::Point GetCenter() const;
 
 		/// <summary>
 		/// Sets the center
@@ -125,13 +136,13 @@ namespace waterleveltracking {
 		/// Calculate the center of the marker
 		/// </summary>
 		/// <param name="markerCornerPixelLocations">Array of size 8 with the 4 x and y pixel positions of the edges in the camera feed [bottom left x, bottom left y, bottom right x, bottom right y, top right x, top right y, top left x, top left y]</param>
-		void GetMarkerCenter(int markerCornerPixelLocations[]);
+		void GetMarkerCenter(const int markerCornerPixelLocations[]);
 
 		/// <summary>
 		/// Calculate the corners of the marker
 		/// </summary>
 		/// <param name="markerCornerPixelLocations">Array of size 8 with the 4 x and y pixel positions of the edges in the camera feed [bottom left x, bottom left y, bottom right x, bottom right y, top right x, top right y, top left x, top left y]</param>
-		void GetMarkerCorners(int corners[]);
+		void GetMarkerCorners(const int corners[]);
 	};
 }
 
@@ -0,0 +1,238 @@
+// <copyright file="MarkerRegistry.h" company="Delft University of Technology">
+// Copyright (c) Delft University of Technology. All rights reserved.
+// </copyright>
+
+#ifndef __MARKERREGISTRY_H__
+#define __MARKERREGISTRY_H__
+
+#include <unordered_map>
+#include <vector>
+#include "LatencyGovernor.h"
+#include "MarkerProperties.h"
+#include "MotionGate.h"
+#include "RegionCalibration.h"
+#include "StripeProperties.h"
+#include "TrackingState.h"
+#include "WaterLevelTracker.h"
+
+namespace waterleveltracking {
+	/// <summary>
+	/// Holds the fixed configuration of every marker of a site, so only the corners have to be handed over per frame.
+	/// Every field is kept in its own array indexed by the slot of the marker, so a pass over many markers reads contiguous memory.
+	/// The center and the meter to pixel factor are calculated once when the corners are updated.
+	/// The calibrated region, the tracked water line, the motion gate and the latency governor of every marker are kept in arrays as
+	/// well and lent to the tracker of the caller for the frame of the marker, so all markers share the scratch buffers of one tracker
+	/// without overwriting the state of each other.
+	/// </summary>
+	class MarkerRegistry
+	{
+	public:
+		/// <summary>
+		/// Register a marker, or replace the configuration of a marker which was registered before
+		/// </summary>
+		/// <param name="id">The id of the marker</param>
+		/// <param name="markerSize">The size of the marker in meters</param>
+		/// <param name="distanceToStripes">The distance in meters from the center of the marker to the first stripe</param>
+		/// <param name="markerHeight">The height of the center of the marker in meters</param>
+		/// <param name="stripeHeight">The height of individual stripes in meters</param>
+		/// <param name="stripeCount">The amount of stripes located under the marker</param>
+		/// <returns>The slot of the marker, -1 if the configuration is wrong</returns>
+		int Register(int id, double markerSize, double distanceToStripes, double markerHeight, double stripeHeight, int stripeCount);
+
+		/// <summary>
+		/// Find the slot of a marker
+		/// </summary>
+		/// <param name="id">The id of the marker</param>
+		/// <returns>The slot of the marker, -1 if it is not registered</returns>
+		int Find(int id) const;
+
+		/// <summary>
+		/// Update the corners of a marker in the current frame
+		/// </summary>
+		/// <param name="slot">The slot of the marker</param>
+		/// <param name="corners">Array of size 8 with the 4 x and y pixel positions of the edges in the camera feed [bottom left x, bottom left y, bottom right x, bottom right y, top right x, top right y, top left x, top left y]</param>
+		/// <returns>False if the slot does not exist</returns>
+		bool UpdateCorners(int slot, const int corners[]);
+
+		/// <summary>
+		/// Forget the corners of a marker, for instance when it is no longer detected
+		/// </summary>
+		/// <param name="slot">The slot of the marker</param>
+		void ClearCorners(int slot);
+
+		/// <summary>
+		/// Gets whether the corners of a marker are known
+		/// </summary>
+		/// <param name="slot">The slot of the marker</param>
+		bool HasCorners(int slot) const;
+
+		/// <summary>
+		/// Gets the properties of a marker with its current corners, the slot must have corners
+		/// </summary>
+		/// <param name="slot">The slot of the marker</param>
+		/// <returns>The properties of the marker</returns>
+		MarkerProperties GetMarkerProperties(int slot) const;
+
+		/// <summary>
+		/// Gets the properties of the stripes underneath a marker
+		/// </summary>
+		/// <param name="slot">The slot of the marker</param>
+		/// <param name="markerProperties">The properties of the marker with its current corners</param>
+		/// <returns>The properties of the stripes</returns>
+		StripeProperties GetStripeProperties(int slot, const MarkerProperties &markerProperties) const;
+
+		/// <summary>
+		/// Predict the height of the water level at a marker with its current corners.
+		/// Return NULL if the the water level cannot be derived from the information or the corners are unknown
+		/// Return -1 if the slot does not exist
+		/// </summary>
+		/// <param name="tracker">The tracker the marker is tracked with, the state of the marker is kept by the registry</param>
+		/// <param name="slot">The slot of the marker</param>
+		/// <param name="frame">The captured frame of the video feed</param>
+		/// <param name="rotation">Angle in degrees of the rotation of the marker</param>
+		/// <returns>The height of the water in meters</returns>
+		double Track(WaterLevelTracker &tracker, int slot, const Mat &frame, double rotation);
+
+		/// <summary>
+		/// Predict the height of the water level at every marker
+		/// </summary>
+		/// <param name="tracker">The tracker the markers are tracked with, the state of every marker is kept by the registry</param>
+		/// <param name="frame">The captured frame of the video feed</param>
+		/// <param name="rotation">Angle in degrees of the rotation of the markers</param>
+		/// <param name="levels">Receives the level of every slot, NULL for the markers which gave no level</param>
+		/// <param name="statuses">Receives the WltStatus of every slot, may be NULL</param>
+		/// <returns>The amount of markers which were tracked</returns>
+		int TrackAll(WaterLevelTracker &tracker, const Mat &frame, double rotation, double levels[], int statuses[] = NULL);
+
+		/// <summary>
+		/// Gets the result of the last frame of a marker, WLT_STATUS_MARKER_NOT_FOUND while its corners are unknown
+		/// </summary>
+		/// <param name="slot">The slot of the marker</param>
+		WltTrackingResult GetResult(int slot);
+
+		/// <summary>
+		/// Gets the amount of frames of a marker which returned the level of its last processed frame, because its stripe region did
+		/// not change or the latency budget skipped them
+		/// </summary>
+		/// <param name="slot">The slot of the marker</param>
+		long long GetSkippedCount(int slot);
+
+		/// <summary>
+		/// Gets the amount of registered markers
+		/// </summary>
+		int GetCount() const;
+
+		/// <summary>
+		/// Gets the id of the marker in a slot
+		/// </summary>
+		/// <param name="slot">The slot of the marker</param>
+		int GetId(int slot) const;
+
+	private:
+		/// <summary>
+		/// The slot of every marker id
+		/// </summary>
+		std::unordered_map<int, int> slots;
+
+		/// <summary>
+		/// The id of the marker in every slot
+		/// </summary>
+		std::vector<int> ids;
+
+		/// <summary>
+		/// The size of every marker in meters
+		/// </summary>
+		std::vector<double> markerSizes;
+
+		/// <summary>
+		/// The distance in meters from the center of every marker to its first stripe
+		/// </summary>
+		std::vector<double> distancesToStripes;
+
+		/// <summary>
+		/// The height of the center of every marker in meters
+		/// </summary>
+		std::vector<double> markerHeights;
+
+		/// <summary>
+		/// The height of the stripes underneath every marker in meters
+		/// </summary>
+		std::vector<double> stripeHeights;
+
+		/// <summary>
+		/// The amount of stripes underneath every marker
+		/// </summary>
+		std::vector<int> stripeCounts;
+
+		/// <summary>
+		/// The 8 corner coordinates of every marker in the current frame, one after the other
+		/// </summary>
+		std::vector<int> corners;
+
+		/// <summary>
+		/// The center of every marker in pixels
+		/// </summary>
+		std::vector<Point> centers;
+
+		/// <summary>
+		/// The factor to convert a meter to a pixel of every marker
+		/// </summary>
+		std::vector<double> meterToPixelFactors;
+
+		/// <summary>
+		/// Whether the corners of every marker are known, 1 if they are
+		/// </summary>
+		std::vector<unsigned char> located;
+
+		/// <summary>
+		/// The calibrated stripe region of every pyramid level of every marker, CalibrationLevels after each other
+		/// </summary>
+		std::vector<RegionCalibration> calibrations;
+
+		/// <summary>
+		/// The motion gate of every marker
+		/// </summary>
+		std::vector<MotionGate> motionGates;
+
+		/// <summary>
+		/// The latency governor of every marker
+		/// </summary>
+		std::vector<LatencyGovernor> governors;
+
+		/// <summary>
+		/// The tracked water line of every marker
+		/// </summary>
+		std::vector<TrackingState> states;
+
+		/// <summary>
+		/// The result of the last frame of every marker
+		/// </summary>
+		std::vector<WltTrackingResult> results;
+
+		/// <summary>
+		/// The amount of calibrations of a marker, one per pyramid level
+		/// </summary>
+		static const int CalibrationLevels = WaterLevelTracker::MaxPyramidLevel + 1;
+
+		/// <summary>
+		/// Check whether a slot exists
+		/// </summary>
+		/// <param name="slot">The slot of the marker</param>
+		/// <returns>True if the slot exists</returns>
+		bool IsSlot(int slot) const;
+
+		/// <summary>
+		/// Calculate the center and the meter to pixel factor of a marker from its stored corners
+		/// </summary>
+		/// <param name="slot">The slot of the marker</param>
+		void Locate(int slot);
+
+		/// <summary>
+		/// Forget the tracked state of a marker
+		/// </summary>
+		/// <param name="slot">The slot of the marker</param>
+		void ResetState(int slot);
+	};
+}
+
+#endif
\ No newline at end of file
@@ -0,0 +1,178 @@
+// <copyright file="MotionGate.h" company="Delft University of Technology">
+// Copyright (c) Delft University of Technology. All rights reserved.
+// </copyright>
+
+#ifndef __MOTIONGATE_H__
+#define __MOTIONGATE_H__
+
+#include <opencv2/opencv.hpp>
+#include "TrackingResult.h"
+
+using namespace cv;
+
+namespace waterleveltracking {
+	/// <summary>
+	/// Decides whether the stripe region of a frame changed enough since the last processed frame to process it again.
+	/// The region is compared through a small downscaled signature, so the check costs a fraction of the pipeline.
+	/// </summary>
+	class MotionGate
+	{
+	public:
+		/// <summary>
+		/// Initializes a new instance of the <see cref="MotionGate"/> class.
+		/// </summary>
+		/// <param name="threshold">The mean absolute difference per signature value above which the region changed</param>
+		/// <param name="forceInterval">The amount of frames after which a frame is processed even if nothing changed, 0 to never force</param>
+		/// <param name="regionTolerance">The amount of pixels the bounds of the stripe region may move while the region counts as the same</param>
+		MotionGate(double threshold = 2.0, int forceInterval = 30, int regionTolerance = 2);
+
+		/// <summary>
+		/// Compare the stripe region of the frame with the one of the last processed frame.
+		/// If the frame has to be processed its signature becomes the one to compare against.
+		/// </summary>
+		/// <param name="frame">The captured frame of the video feed</param>
+		/// <param name="region">The bounds of the stripe region in the frame</param>
+		/// <returns>True if the frame has to be processed, false if the stored level still holds</returns>
+		bool Check(const Mat &frame, Rect region);
+
+		/// <summary>
+		/// Store the result of the processed frame with the bounds of its stripe region, it is returned for the skipped frames of that region
+		/// </summary>
+		/// <param name="result">The result of the frame</param>
+		/// <param name="region">The bounds of the stripe region in the frame</param>
+		void Store(const WltTrackingResult &result, Rect region);
+
+		/// <summary>
+		/// Gets whether the stored result belongs to a stripe region, a frame of another region has to be processed
+		/// </summary>
+		/// <param name="region">The bounds of the stripe region in the frame</param>
+		/// <returns>True if a result is stored for the region</returns>
+		bool Holds(Rect region);
+
+		/// <summary>
+		/// Forget the last processed frame, so the next frame is processed
+		/// </summary>
+		void Reset();
+
+		/// <summary>
+		/// Gets the result of the last processed frame
+		/// </summary>
+		WltTrackingResult GetResult();
+
+		/// <summary>
+		/// Gets the threshold
+		/// </summary>
+		double GetThreshold();
+
+		/// <summary>
+		/// Sets the threshold
+		/// </summary>
+		void SetThreshold(double threshold);
+
+		/// <summary>
+		/// Gets the force interval
+		/// </summary>
+		int GetForceInterval();
+
+		/// <summary>
+		/// Sets the force interval
+		/// </summary>
+		void SetForceInterval(int forceInterval);
+
+		/// <summary>
+		/// Gets the region tolerance
+		/// </summary>
+		int GetRegionTolerance();
+
+		/// <summary>
+		/// Sets the region tolerance
+		/// </summary>
+		void SetRegionTolerance(int regionTolerance);
+
+		/// <summary>
+		/// Gets the amount of frames which were skipped
+		/// </summary>
+		long long GetSkippedCount();
+
+	private:
+		/// <summary>
+		/// Check whether the bounds of a stripe region lie within the tolerance of the ones of a processed frame
+		/// </summary>
+		/// <param name="region">The bounds of the stripe region in the frame</param>
+		/// <param name="processed">The bounds of the stripe region of the processed frame</param>
+		/// <returns>True if the region counts as the same</returns>
+		bool SameRegion(Rect region, Rect processed);
+
+		/// <summary>
+		/// The width of the signature of a stripe region, tall because the stripes run horizontally
+		/// </summary>
+		static const int SignatureWidth = 16;
+
+		/// <summary>
+		/// The height of the signature of a stripe region, tall because the stripes run horizontally
+		/// </summary>
+		static const int SignatureHeight = 64;
+
+		/// <summary>
+		/// The mean absolute difference per signature value above which the region changed
+		/// </summary>
+		double threshold;
+
+		/// <summary>
+		/// The amount of frames after which a frame is processed even if nothing changed
+		/// </summary>
+		int forceInterval;
+
+		/// <summary>
+		/// The amount of pixels the bounds of the stripe region may move while the region counts as the same
+		/// </summary>
+		int regionTolerance;
+
+		/// <summary>
+		/// The signature of the current frame
+		/// </summary>
+		Mat signature;
+
+		/// <summary>
+		/// The signature of the last processed frame
+		/// </summary>
+		Mat processedSignature;
+
+		/// <summary>
+		/// The bounds of the stripe region of the last processed frame
+		/// </summary>
+		Rect processedRegion;
+
+		/// <summary>
+		/// Whether a frame has been processed since the last reset
+		/// </summary>
+		bool hasProcessed;
+
+		/// <summary>
+		/// The result of the last processed frame
+		/// </summary>
+		WltTrackingResult result;
+
+		/// <summary>
+		/// The bounds of the stripe region the result was measured in
+		/// </summary>
+		Rect resultRegion;
+
+		/// <summary>
+		/// Whether a result has been stored since the last reset
+		/// </summary>
+		bool hasResult;
+
+		/// <summary>
+		/// The amount of frames skipped since the last processed frame
+		/// </summary>
+		int framesSinceProcessed;
+
+		/// <summary>
+		/// The amount of frames which were skipped
+		/// </summary>
+		long long skippedCount;
+	};
+}
+
+#endif
\ No newline at end of file
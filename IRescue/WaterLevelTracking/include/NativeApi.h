@@ -0,0 +1,207 @@
+// <copyright file="NativeApi.h" company="Delft University of Technology">
+// Copyright (c) Delft University of Technology. All rights reserved.
+// </copyright>
+
+#ifndef __NATIVEAPI_H__
+#define __NATIVEAPI_H__
+
+#include "Export.h"
+#include "TrackingResult.h"
+
+/// <summary>
+/// The layouts of the pixel buffers the C interface accepts
+/// </summary>
+enum WltPixelFormat {
+	/// <summary>
+	/// Four bytes per pixel in the order red, green, blue, alpha
+	/// </summary>
+	WLT_PIXEL_FORMAT_RGBA32 = 0,
+
+	/// <summary>
+	/// Four bytes per pixel in the order blue, green, red, alpha
+	/// </summary>
+	WLT_PIXEL_FORMAT_BGRA32 = 1,
+
+	/// <summary>
+	/// Three bytes per pixel in the order red, green, blue
+	/// </summary>
+	WLT_PIXEL_FORMAT_RGB24 = 2,
+
+	/// <summary>
+	/// One byte of intensity per pixel
+	/// </summary>
+	WLT_PIXEL_FORMAT_GRAY8 = 3,
+
+	/// <summary>
+	/// A full resolution Y plane followed by an interleaved UV plane, only the Y plane is read
+	/// </summary>
+	WLT_PIXEL_FORMAT_NV12 = 4,
+
+	/// <summary>
+	/// A full resolution Y plane followed by a U and a V plane, only the Y plane is read
+	/// </summary>
+	WLT_PIXEL_FORMAT_I420 = 5
+};
+
+/// <summary>
+/// Create a tracker which keeps its scratch buffers between frames
+/// </summary>
+/// <param name="regionMode">The index of the region mode in the RegionMode enum</param>
+/// <param name="profileMode">The index of the profile mode in the ProfileMode enum</param>
+/// <returns>The tracker, NULL if a mode does not exist</returns>
+WLT_EXPORT void *WltCreateTracker(int regionMode, int profileMode);
+
+/// <summary>
+/// Destroy a tracker created by WltCreateTracker
+/// </summary>
+/// <param name="tracker">The tracker, may be NULL</param>
+WLT_EXPORT void WltDestroyTracker(void *tracker);
+
+/// <summary>
+/// Set the time in seconds processing a frame may cost. While the measured cost exceeds it the tracker processes coarser,
+/// with a smaller blur, fewer bands, a lower resolution and finally skipped frames, and it returns to full quality once the cost allows
+/// </summary>
+/// <param name="tracker">The tracker, NULL to use the tracker of the calling thread</param>
+/// <param name="budget">The budget in seconds, 0 to always process frames as configured</param>
+/// <returns>1 on success, -1 if the budget is negative</returns>
+WLT_EXPORT int WltSetLatencyBudget(void *tracker, double budget);
+
+/// <summary>
+/// Gets the quality level the latency budget currently allows
+/// </summary>
+/// <param name="tracker">The tracker, NULL to use the tracker of the calling thread</param>
+/// <returns>0 when frames are processed as configured, up to 4 when only every fourth frame is processed at the coarsest settings</returns>
+WLT_EXPORT int WltGetQualityLevel(void *tracker);
+
+/// <summary>
+/// Predict the height of the water level from a pixel buffer of the caller. The buffer is wrapped without copying and
+/// is never modified; YUV buffers are read through their Y plane, so they need no color conversion.
+/// Return NULL if the the water level cannot be derived from the information, -1 if the input is wrong
+/// </summary>
+/// <param name="tracker">The tracker, NULL to use a tracker of the calling thread</param>
+/// <param name="pixels">The first pixel of the frame</param>
+/// <param name="width">The width of the frame in pixels</param>
+/// <param name="height">The height of the frame in pixels</param>
+/// <param name="stride">The amount of bytes between the starts of two rows, of the Y plane for YUV buffers</param>
+/// <param name="pixelFormat">The layout of the buffer, a WltPixelFormat</param>
+/// <param name="corners">The pixel locations of the marker corners in the order bottom left, bottom right, top right, top left</param>
+/// <param name="markerSize">The size of the marker in meters</param>
+/// <param name="distanceToStripes">The distance from the center of the marker to the highest stripe in meters</param>
+/// <param name="markerHeight">The height of the center of the marker in meters</param>
+/// <param name="stripeHeight">The height of a stripe in meters</param>
+/// <param name="stripeCount">The amount of stripes underneath the marker</param>
+/// <param name="rotation">Angle in degrees of the rotation of the marker</param>
+/// <returns>The height of the water in meters</returns>
+WLT_EXPORT double WltCalculateWaterLevel(void *tracker, const unsigned char *pixels, int width, int height, int stride, int pixelFormat,
+	const int corners[8], double markerSize, double distanceToStripes, double markerHeight, double stripeHeight, int stripeCount, double rotation);
+
+/// <summary>
+/// Predict the height of the water level from a pixel buffer of the caller and tell why the frame did or did not give one.
+/// The stripe region is validated from the corners before any pixel is touched, and nothing is thrown
+/// </summary>
+/// <param name="tracker">The tracker, NULL to use a tracker of the calling thread</param>
+/// <param name="pixels">The first pixel of the frame</param>
+/// <param name="width">The width of the frame in pixels</param>
+/// <param name="height">The height of the frame in pixels</param>
+/// <param name="stride">The amount of bytes between the starts of two rows, of the Y plane for YUV buffers</param>
+/// <param name="pixelFormat">The layout of the buffer, a WltPixelFormat</param>
+/// <param name="corners">The pixel locations of the marker corners in the order bottom left, bottom right, top right, top left</param>
+/// <param name="markerSize">The size of the marker in meters</param>
+/// <param name="distanceToStripes">The distance from the center of the marker to the highest stripe in meters</param>
+/// <param name="markerHeight">The height of the center of the marker in meters</param>
+/// <param name="stripeHeight">The height of a stripe in meters</param>
+/// <param name="stripeCount">The amount of stripes underneath the marker</param>
+/// <param name="rotation">Angle in degrees of the rotation of the marker</param>
+/// <param name="result">Receives the status, level, confidence and stripe count of the frame</param>
+/// <returns>The status of the frame, a WltStatus</returns>
+WLT_EXPORT int WltMeasureWaterLevel(void *tracker, const unsigned char *pixels, int width, int height, int stride, int pixelFormat,
+	const int corners[8], double markerSize, double distanceToStripes, double markerHeight, double stripeHeight, int stripeCount, double rotation, WltTrackingResult *result);
+
+/// <summary>
+/// Predict the height of the water level from a JPEG image, for instance a frame of an MJPEG stream. Only the luma of the rows and
+/// MCU columns which hold the stripe region of the marker and a margin for the blur is decoded, the region is worked out from the corners before decoding.
+/// Return NULL if the the water level cannot be derived from the information, -1 if the input is wrong or the library is built without libjpeg-turbo
+/// </summary>
+/// <param name="tracker">The tracker, NULL to use a tracker of the calling thread</param>
+/// <param name="data">The compressed image</param>
+/// <param name="size">The size of the compressed image in bytes</param>
+/// <param name="corners">The pixel locations of the marker corners in the order bottom left, bottom right, top right, top left</param>
+/// <param name="markerSize">The size of the marker in meters</param>
+/// <param name="distanceToStripes">The distance from the center of the marker to the highest stripe in meters</param>
+/// <param name="markerHeight">The height of the center of the marker in meters</param>
+/// <param name="stripeHeight">The height of a stripe in meters</param>
+/// <param name="stripeCount">The amount of stripes underneath the marker</param>
+/// <param name="rotation">Angle in degrees of the rotation of the marker</param>
+/// <returns>The height of the water in meters</returns>
+WLT_EXPORT double WltCalculateWaterLevelJpeg(void *tracker, const unsigned char *data, int size,
+	const int corners[8], double markerSize, double distanceToStripes, double markerHeight, double stripeHeight, int stripeCount, double rotation);
+
+/// <summary>
+/// Gets whether the library is built with libjpeg-turbo
+/// </summary>
+/// <returns>1 if WltCalculateWaterLevelJpeg decodes images, 0 if it always returns -1</returns>
+WLT_EXPORT int WltIsJpegDecodingEnabled();
+
+/// <summary>
+/// Create a registry which holds the fixed configuration of the markers of a site, so only the corners are handed over per frame
+/// </summary>
+/// <returns>The registry</returns>
+WLT_EXPORT void *WltCreateMarkerRegistry();
+
+/// <summary>
+/// Destroy a registry created by WltCreateMarkerRegistry
+/// </summary>
+/// <param name="registry">The registry, may be NULL</param>
+WLT_EXPORT void WltDestroyMarkerRegistry(void *registry);
+
+/// <summary>
+/// Register a marker once, or replace the configuration of a marker which was registered before
+/// </summary>
+/// <param name="registry">The registry</param>
+/// <param name="id">The id of the marker</param>
+/// <param name="markerSize">The size of the marker in meters</param>
+/// <param name="distanceToStripes">The distance from the center of the marker to the highest stripe in meters</param>
+/// <param name="markerHeight">The height of the center of the marker in meters</param>
+/// <param name="stripeHeight">The height of a stripe in meters</param>
+/// <param name="stripeCount">The amount of stripes underneath the marker</param>
+/// <returns>The slot of the marker, -1 if the input is wrong</returns>
+WLT_EXPORT int WltRegisterMarker(void *registry, int id, double markerSize, double distanceToStripes, double markerHeight, double stripeHeight, int stripeCount);
+
+/// <summary>
+/// Update the corners of a marker in the current frame, NULL corners mark the marker as not detected
+/// </summary>
+/// <param name="registry">The registry</param>
+/// <param name="slot">The slot of the marker</param>
+/// <param name="corners">The pixel locations of the marker corners in the order bottom left, bottom right, top right, top left</param>
+/// <returns>1 on success, -1 if the input is wrong</returns>
+WLT_EXPORT int WltUpdateMarkerCorners(void *registry, int slot, const int corners[8]);
+
+/// <summary>
+/// Predict the height of the water level at every registered marker with known corners from a pixel buffer of the caller.
+/// The buffer is wrapped without copying like in WltCalculateWaterLevel. Every marker keeps its own tracking state in the registry
+/// </summary>
+/// <param name="registry">The registry</param>
+/// <param name="tracker">The tracker whose options the markers are tracked with, NULL to use a tracker of the calling thread</param>
+/// <param name="pixels">The first pixel of the frame</param>
+/// <param name="width">The width of the frame in pixels</param>
+/// <param name="height">The height of the frame in pixels</param>
+/// <param name="stride">The amount of bytes between the starts of two rows, of the Y plane for YUV buffers</param>
+/// <param name="pixelFormat">The layout of the buffer, a WltPixelFormat</param>
+/// <param name="rotation">Angle in degrees of the rotation of the markers</param>
+/// <param name="levels">Receives the level of every slot, NULL for the markers which gave no level</param>
+/// <param name="statuses">Receives the WltStatus of every slot, WLT_STATUS_MARKER_NOT_FOUND for the markers whose corners are unknown, may be NULL</param>
+/// <param name="capacity">The amount of levels and statuses the arrays can hold, at least the amount of registered markers</param>
+/// <returns>The amount of markers which were tracked, -1 if the input is wrong</returns>
+WLT_EXPORT int WltTrackMarkers(void *registry, void *tracker, const unsigned char *pixels, int width, int height, int stride, int pixelFormat,
+	double rotation, double *levels, int *statuses, int capacity);
+
+/// <summary>
+/// Add the result of the last frame a tracker processed to a history created by WltCreateLevelHistory, with the row profile its stripes were counted from
+/// </summary>
+/// <param name="history">The history</param>
+/// <param name="tracker">The tracker, NULL to use the tracker of the calling thread</param>
+/// <param name="timestamp">The timestamp of the frame in microseconds, not negative and not earlier than that of the previous sample</param>
+/// <returns>1 on success, -1 if the input is wrong</returns>
+WLT_EXPORT int WltAddTrackedLevel(void *history, void *tracker, long long timestamp);
+
+#endif
\ No newline at end of file
@@ -0,0 +1,208 @@
+// <copyright file="RecordingFormat.h" company="Delft University of Technology">
+// Copyright (c) Delft University of Technology. All rights reserved.
+// </copyright>
+
+#ifndef __RECORDINGFORMAT_H__
+#define __RECORDINGFORMAT_H__
+
+#include <cstdint>
+
+namespace waterleveltracking {
+	/// <summary>
+	/// What the recorder stores of every frame
+	/// </summary>
+	enum class RecordContent {
+		/// <summary>
+		/// The straightened grayscale stripe region, which is a fraction of the frame
+		/// </summary>
+		Region,
+
+		/// <summary>
+		/// The whole frame as it was handed to the tracker
+		/// </summary>
+		Frame
+	};
+
+	/// <summary>
+	/// The layout of a recording: a file header, the frame records one after another and, once the recording is closed, an index and a footer.
+	/// Every record and the pixels in it start on a multiple of Alignment bytes, so a memory mapped record can be used as a frame as is.
+	/// A recording without a footer, for instance after a crash, is read by walking the records.
+	/// </summary>
+	namespace RecordingFormat {
+		/// <summary>
+		/// The first bytes of a recording, "WLTR"
+		/// </summary>
+		static const uint32_t FileMagic = 0x52544C57;
+
+		/// <summary>
+		/// The first bytes of a frame record, "FRME"
+		/// </summary>
+		static const uint32_t RecordMagic = 0x454D5246;
+
+		/// <summary>
+		/// The last bytes of a closed recording, "WLTI"
+		/// </summary>
+		static const uint32_t FooterMagic = 0x49544C57;
+
+		/// <summary>
+		/// The version of the layout, 2 added the status of every frame
+		/// </summary>
+		static const uint32_t Version = 2;
+
+		/// <summary>
+		/// The alignment in bytes of the records and their pixels
+		/// </summary>
+		static const uint32_t Alignment = 64;
+
+		/// <summary>
+		/// The header at the start of a recording
+		/// </summary>
+		struct FileHeader {
+			/// <summary>
+			/// FileMagic
+			/// </summary>
+			uint32_t magic;
+
+			/// <summary>
+			/// The version of the layout
+			/// </summary>
+			uint32_t version;
+
+			/// <summary>
+			/// The RecordContent of the frames
+			/// </summary>
+			uint32_t content;
+
+			/// <summary>
+			/// Padding up to the first record
+			/// </summary>
+			uint8_t reserved[Alignment - 12];
+		};
+
+		/// <summary>
+		/// The header of a frame record, followed by the pixels on the next multiple of Alignment
+		/// </summary>
+		struct RecordHeader {
+			/// <summary>
+			/// RecordMagic
+			/// </summary>
+			uint32_t magic;
+
+			/// <summary>
+			/// The OpenCV type of the pixels
+			/// </summary>
+			int32_t type;
+
+			/// <summary>
+			/// The size in bytes of the record, header and padding included
+			/// </summary>
+			uint64_t size;
+
+			/// <summary>
+			/// The number of the frame within the recording
+			/// </summary>
+			int64_t sequence;
+
+			/// <summary>
+			/// The width of the image in pixels
+			/// </summary>
+			int32_t width;
+
+			/// <summary>
+			/// The height of the image in pixels
+			/// </summary>
+			int32_t height;
+
+			/// <summary>
+			/// The amount of bytes between the starts of two rows
+			/// </summary>
+			int64_t step;
+
+			/// <summary>
+			/// The marker corners in the frame in the order bottom left, bottom right, top right, top left
+			/// </summary>
+			int32_t corners[8];
+
+			/// <summary>
+			/// The size of the marker in meters
+			/// </summary>
+			double markerSize;
+
+			/// <summary>
+			/// The distance from the center of the marker to the highest stripe in meters
+			/// </summary>
+			double distanceToStripes;
+
+			/// <summary>
+			/// The height of the center of the marker in meters
+			/// </summary>
+			double markerHeight;
+
+			/// <summary>
+			/// The height of a stripe in meters
+			/// </summary>
+			double stripeHeight;
+
+			/// <summary>
+			/// The amount of stripes underneath the marker
+			/// </summary>
+			int32_t stripeCount;
+
+			/// <summary>
+			/// The height of a stripe in pixels in the recorded region, which may be downscaled
+			/// </summary>
+			int32_t stripePixelHeight;
+
+			/// <summary>
+			/// Angle in degrees of the rotation of the marker
+			/// </summary>
+			double rotation;
+
+			/// <summary>
+			/// The water level the tracker calculated for the frame
+			/// </summary>
+			double level;
+
+			/// <summary>
+			/// The WltStatus the frame ended with, a held frame has the status of the frame whose level it returned
+			/// </summary>
+			int32_t status;
+
+			/// <summary>
+			/// Padding up to the alignment of the doubles
+			/// </summary>
+			int32_t reserved;
+		};
+
+		/// <summary>
+		/// The footer at the end of a closed recording, preceded by the offset of every record
+		/// </summary>
+		struct Footer {
+			/// <summary>
+			/// The offset in bytes of the index
+			/// </summary>
+			uint64_t indexOffset;
+
+			/// <summary>
+			/// The amount of records
+			/// </summary>
+			uint32_t count;
+
+			/// <summary>
+			/// FooterMagic
+			/// </summary>
+			uint32_t magic;
+		};
+
+		/// <summary>
+		/// Round a size up to the alignment of the records
+		/// </summary>
+		/// <param name="size">The size in bytes</param>
+		/// <returns>The aligned size</returns>
+		inline uint64_t Align(uint64_t size) {
+			return (size + Alignment - 1) / Alignment * Alignment;
+		}
+	}
+}
+
+#endif
\ No newline at end of file
@@ -0,0 +1,81 @@
+// <copyright file="RegionCalibration.h" company="Delft University of Technology">
+// Copyright (c) Delft University of Technology. All rights reserved.
+// </copyright>
+
+#ifndef __REGIONCALIBRATION_H__
+#define __REGIONCALIBRATION_H__
+
+#include <opencv2/opencv.hpp>
+#include "Square.h"
+
+using namespace cv;
+
+namespace waterleveltracking {
+	/// <summary>
+	/// The geometry of the stripe region of a marker seen by a fixed camera, calculated once and reused for every frame.
+	/// It stays valid as long as the frame size and the quantized rotation are the same and the marker does not move.
+	/// </summary>
+	struct RegionCalibration {
+		/// <summary>
+		/// Whether the calibration has been calculated
+		/// </summary>
+		bool valid = false;
+
+		/// <summary>
+		/// The size of the frames the calibration was calculated for
+		/// </summary>
+		Size frameSize;
+
+		/// <summary>
+		/// The quantized angle in degrees the calibration was calculated for
+		/// </summary>
+		double rotation = 0;
+
+		/// <summary>
+		/// The step between the sampled columns of the stripe region the calibration was calculated for
+		/// </summary>
+		int columnStep = 1;
+
+		/// <summary>
+		/// Whether the calibration covers the wider stripe region of the BandVote profile mode
+		/// </summary>
+		bool wide = false;
+
+		/// <summary>
+		/// The corners of the marker in the unrotated frame when the calibration was calculated
+		/// </summary>
+		Square sourceCorners;
+
+		/// <summary>
+		/// The corners of the marker in the rotated frame
+		/// </summary>
+		Square corners;
+
+		/// <summary>
+		/// The center of the marker in the rotated frame
+		/// </summary>
+		Point center;
+
+		/// <summary>
+		/// The starting pixel of the highest stripe in the rotated frame
+		/// </summary>
+		int stripePixelStart = 0;
+
+		/// <summary>
+		/// The last row of the stripe region which lies inside the frame, the region is empty if this is 0
+		/// </summary>
+		int bottom = 0;
+
+		/// <summary>
+		/// The integer part of the source pixel of every region pixel, as pairs of shorts
+		/// </summary>
+		Mat map;
+
+		/// <summary>
+		/// The interpolation weights of the source pixel of every region pixel
+		/// </summary>
+		Mat mapFraction;
+	};
+}
+
+#endif
\ No newline at end of file
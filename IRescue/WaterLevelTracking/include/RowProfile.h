@@ -0,0 +1,65 @@
+// <copyright file="RowProfile.h" company="Delft University of Technology">
+// Copyright (c) Delft University of Technology. All rights reserved.
+// </copyright>
+
+#ifndef __ROWPROFILE_H__
+#define __ROWPROFILE_H__
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+#include <opencv2/opencv.hpp>
+
+using namespace cv;
+
+namespace waterleveltracking {
+	/// <summary>
+	/// Operations on the 1-D intensity profile of a stripe region, holding one value per row.
+	/// </summary>
+	class RowProfile
+	{
+	public:
+		/// <summary>
+		/// Collapse every row of the region to its mean intensity
+		/// </summary>
+		/// <param name="region">The 8 bit grayscale stripe region</param>
+		/// <param name="intensity">Receives the mean intensity of every row</param>
+		static void Mean(const Mat &region, std::vector<float> &intensity);
+
+		/// <summary>
+		/// Collapse every row of the region to the mean intensity of its middle half, which ignores glare and dark spots
+		/// </summary>
+		/// <param name="region">The 8 bit grayscale stripe region</param>
+		/// <param name="intensity">Receives the trimmed mean intensity of every row</param>
+		/// <param name="scratch">Scratch buffer for the pixels of a row</param>
+		static void TrimmedMean(const Mat &region, std::vector<float> &intensity, std::vector<uchar> &scratch);
+
+		/// <summary>
+		/// Smooth the profile with the same 5 tap Gaussian kernel GaussianBlur uses for a 5x5 window
+		/// </summary>
+		/// <param name="intensity">The profile to smooth</param>
+		/// <param name="smoothed">Receives the smoothed profile</param>
+		static void Blur(const std::vector<float> &intensity, std::vector<float> &smoothed);
+
+		/// <summary>
+		/// Decide per row whether it belongs to a white stripe
+		/// </summary>
+		/// <param name="intensity">The smoothed profile</param>
+		/// <param name="threshold">Rows brighter than this value belong to a white stripe</param>
+		/// <param name="profile">Receives 255 for every row of a white stripe and 0 for every other row</param>
+		static void Threshold(const std::vector<float> &intensity, float threshold, std::vector<uchar> &profile);
+
+		/// <summary>
+		/// Find the part of the partially submerged stripe above the water. The edges of the stripe and of the stripe above it give
+		/// the height of a stripe, the water line is the strongest change from the stripe to the water below its top edge.
+		/// The intensity of the stripe is taken from the stripe of the same color above it and that of the water from the rows below the stripe.
+		/// </summary>
+		/// <param name="intensity">The smoothed profile</param>
+		/// <param name="stripeStart">The first row of the partially submerged stripe</param>
+		/// <param name="stripeHeight">The height of a stripe in rows</param>
+		/// <returns>The part of the stripe above the water from 0 to 1, -1 if it cannot be found</returns>
+		static double StripeAboveWater(const std::vector<float> &intensity, int stripeStart, int stripeHeight);
+	};
+}
+
+#endif
\ No newline at end of file
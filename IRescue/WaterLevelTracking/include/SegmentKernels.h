@@ -0,0 +1,97 @@
+// <copyright file="SegmentKernels.h" company="Delft University of Technology">
+// Copyright (c) Delft University of Technology. All rights reserved.
+// </copyright>
+
+#ifndef __SEGMENTKERNELS_H__
+#define __SEGMENTKERNELS_H__
+
+#include <stddef.h>
+
+namespace waterleveltracking {
+	/// <summary>
+	/// Kernels which threshold the stripe region and decide per row whether it belongs to a white stripe.
+	/// The widest instruction set supported by the processor is picked at runtime.
+	/// </summary>
+	class SegmentKernels
+	{
+	public:
+		/// <summary>
+		/// The instruction sets a kernel can be implemented with
+		/// </summary>
+		enum InstructionSet {
+			/// <summary>
+			/// Plain C++
+			/// </summary>
+			Scalar,
+
+			/// <summary>
+			/// 128 bit SSE2 vectors
+			/// </summary>
+			Sse2,
+
+			/// <summary>
+			/// 256 bit AVX2 vectors
+			/// </summary>
+			Avx2
+		};
+
+		/// <summary>
+		/// Threshold every pixel of the region and count the foreground pixels of each row in a single pass.
+		/// A row is foreground when at least 45% of its pixels are brighter than the threshold.
+		/// </summary>
+		/// <param name="data">The first pixel of the 8 bit grayscale region</param>
+		/// <param name="step">The amount of bytes between the starts of two rows</param>
+		/// <param name="rows">The amount of rows of the region</param>
+		/// <param name="cols">The amount of columns of the region</param>
+		/// <param name="threshold">Pixels brighter than this value are foreground</param>
+		/// <param name="profile">Receives 255 for every foreground row and 0 for every other row</param>
+		static void ThresholdRowProjection(const unsigned char *data, size_t step, int rows, int cols, unsigned char threshold, unsigned char *profile);
+
+		/// <summary>
+		/// Threshold and project the region with a specific instruction set, falling back to plain C++ if it is not supported
+		/// </summary>
+		/// <param name="instructionSet">The instruction set to use</param>
+		/// <param name="data">The first pixel of the 8 bit grayscale region</param>
+		/// <param name="step">The amount of bytes between the starts of two rows</param>
+		/// <param name="rows">The amount of rows of the region</param>
+		/// <param name="cols">The amount of columns of the region</param>
+		/// <param name="threshold">Pixels brighter than this value are foreground</param>
+		/// <param name="profile">Receives 255 for every foreground row and 0 for every other row</param>
+		static void ThresholdRowProjection(InstructionSet instructionSet, const unsigned char *data, size_t step, int rows, int cols, unsigned char threshold, unsigned char *profile);
+
+		/// <summary>
+		/// Gets the widest instruction set supported by the processor
+		/// </summary>
+		static InstructionSet GetSupportedInstructionSet();
+
+	private:
+		/// <summary>
+		/// Count the pixels of a row which are brighter than the threshold, in plain C++
+		/// </summary>
+		/// <param name="row">The first pixel of the row</param>
+		/// <param name="cols">The amount of pixels in the row</param>
+		/// <param name="threshold">Pixels brighter than this value are counted</param>
+		/// <returns>The amount of pixels brighter than the threshold</returns>
+		static int CountScalar(const unsigned char *row, int cols, unsigned char threshold);
+
+		/// <summary>
+		/// Count the pixels of a row which are brighter than the threshold, using SSE2
+		/// </summary>
+		/// <param name="row">The first pixel of the row</param>
+		/// <param name="cols">The amount of pixels in the row</param>
+		/// <param name="threshold">Pixels brighter than this value are counted</param>
+		/// <returns>The amount of pixels brighter than the threshold</returns>
+		static int CountSse2(const unsigned char *row, int cols, unsigned char threshold);
+
+		/// <summary>
+		/// Count the pixels of a row which are brighter than the threshold, using AVX2
+		/// </summary>
+		/// <param name="row">The first pixel of the row</param>
+		/// <param name="cols">The amount of pixels in the row</param>
+		/// <param name="threshold">Pixels brighter than this value are counted</param>
+		/// <returns>The amount of pixels brighter than the threshold</returns>
+		static int CountAvx2(const unsigned char *row, int cols, unsigned char threshold);
+	};
+}
+
+#endif
\ No newline at end of file
@@ -0,0 +1,439 @@
+// <copyright file="StreamEngine.h" company="Delft University of Technology">
+// Copyright (c) Delft University of Technology. All rights reserved.
+// </copyright>
+
+#ifndef __STREAMENGINE_H__
+#define __STREAMENGINE_H__
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include <opencv2/opencv.hpp>
+#include "LevelBoard.h"
+#include "MarkerProperties.h"
+#include "StripeProperties.h"
+#include "TrackerOptions.h"
+#include "WaterLevelTracker.h"
+
+namespace waterleveltracking {
+	/// <summary>
+	/// The water level calculated for a frame of one of the streams of the engine
+	/// </summary>
+	struct EngineResult {
+		/// <summary>
+		/// The identifier of the stream the frame was submitted to
+		/// </summary>
+		int stream;
+
+		/// <summary>
+		/// The sequence number of the frame within its stream, counting from 0 in the order of submission
+		/// </summary>
+		long long sequence;
+
+		/// <summary>
+		/// The height of the water in meters, NULL if it cannot be derived from the frame or the frame expired
+		/// </summary>
+		double level;
+
+		/// <summary>
+		/// The time in seconds between the submission of the frame and the result
+		/// </summary>
+		double latency;
+
+		/// <summary>
+		/// True if the frame was skipped because it outlived the latency budget of its stream while a newer frame was waiting
+		/// </summary>
+		bool expired;
+	};
+
+	/// <summary>
+	/// The counters of one of the streams of the engine
+	/// </summary>
+	struct StreamStatistics {
+		/// <summary>
+		/// The amount of frames submitted to the stream
+		/// </summary>
+		long long submitted;
+
+		/// <summary>
+		/// The amount of frames whose water level was calculated
+		/// </summary>
+		long long processed;
+
+		/// <summary>
+		/// The amount of frames skipped because they outlived the latency budget
+		/// </summary>
+		long long expired;
+
+		/// <summary>
+		/// The summed latency in seconds of the processed frames
+		/// </summary>
+		double totalLatency;
+
+		/// <summary>
+		/// The highest latency in seconds of a processed frame
+		/// </summary>
+		double maxLatency;
+
+		/// <summary>
+		/// The summed time in seconds spent calculating the water level of the processed frames
+		/// </summary>
+		double totalProcessing;
+	};
+
+	/// <summary>
+	/// Calculates the water level of many camera streams on a shared pool of threads.
+	/// A stream is scheduled as a task which processes its oldest frame and then queues itself again behind the other streams,
+	/// so the frames of a stream are processed in order, one at a time, and a busy stream cannot starve the others.
+	/// Every thread has its own queue of streams and steals from the queues of the others when it runs dry.
+	/// </summary>
+	class StreamEngine
+	{
+	public:
+		/// <summary>
+		/// Called on a thread of the pool with the result of every frame of a stream, in the order the frames were submitted
+		/// </summary>
+		typedef std::function<void(const EngineResult&)> ResultCallback;
+
+		/// <summary>
+		/// Initializes a new instance of the <see cref="StreamEngine"/> class and starts the threads.
+		/// </summary>
+		/// <param name="options">The options which select how frames are processed</param>
+		/// <param name="threadCount">The amount of threads in the pool, 0 to use one per hardware thread</param>
+		StreamEngine(TrackerOptions options = TrackerOptions(), int threadCount = 0);
+
+		/// <summary>
+		/// Stops the threads and waits for them to finish, frames which were not processed yet are discarded.
+		/// </summary>
+		~StreamEngine();
+
+		/// <summary>
+		/// Register a stream
+		/// </summary>
+		/// <param name="markerProperties">Properties of the measured marker</param>
+		/// <param name="stripeProperties">Properties of the striped underneath the measured marker</param>
+		/// <param name="latencyBudget">The time in seconds a frame may wait before it is skipped in favour of a newer frame, 0 to process every frame</param>
+		/// <param name="callback">Receives the results of the stream, when empty they are put on the completion queue</param>
+		/// <param name="boardSlot">The slot of the level board the levels of the stream are published to, -1 to not publish them</param>
+		/// <returns>The identifier of the stream</returns>
+		int AddStream(const MarkerProperties &markerProperties, const StripeProperties &stripeProperties, double latencyBudget = 0, ResultCallback callback = ResultCallback(), int boardSlot = -1);
+
+		/// <summary>
+		/// Submit a frame to a stream, the marker is where it was registered.
+		/// The frame is copied, so the caller can reuse it right away.
+		/// </summary>
+		/// <param name="stream">The identifier of the stream</param>
+		/// <param name="frame">The captured frame of the video feed</param>
+		/// <param name="rotation">Angle in degrees of the rotation of the marker</param>
+		/// <returns>False if the stream does not exist</returns>
+		bool Submit(int stream, const Mat &frame, double rotation);
+
+		/// <summary>
+		/// Submit a frame to a stream with the marker where it was found in this frame.
+		/// The frame is copied, so the caller can reuse it right away.
+		/// </summary>
+		/// <param name="stream">The identifier of the stream</param>
+		/// <param name="frame">The captured frame of the video feed</param>
+		/// <param name="markerProperties">Properties of the measured marker in this frame</param>
+		/// <param name="rotation">Angle in degrees of the rotation of the marker</param>
+		/// <returns>False if the stream does not exist</returns>
+		bool Submit(int stream, const Mat &frame, const MarkerProperties &markerProperties, double rotation);
+
+		/// <summary>
+		/// Take the oldest result from the completion queue, which holds the results of the streams without a callback
+		/// </summary>
+		/// <param name="result">The oldest result</param>
+		/// <returns>False if the completion queue is empty</returns>
+		bool TryGetResult(EngineResult &result);
+
+		/// <summary>
+		/// Block until every submitted frame has a result
+		/// </summary>
+		void Wait();
+
+		/// <summary>
+		/// Gets the counters of a stream
+		/// </summary>
+		/// <param name="stream">The identifier of the stream</param>
+		StreamStatistics GetStatistics(int stream);
+
+		/// <summary>
+		/// Gets the amount of streams
+		/// </summary>
+		int GetStreamCount();
+
+		/// <summary>
+		/// Gets the amount of times a thread took a stream from the queue of another thread
+		/// </summary>
+		long long GetStealCount();
+
+	private:
+		/// <summary>
+		/// A frame waiting to be processed
+		/// </summary>
+		struct PendingFrame {
+			/// <summary>
+			/// Initializes a new instance of the <see cref="PendingFrame"/> struct.
+			/// </summary>
+			/// <param name="markerProperties">Properties of the measured marker in this frame</param>
+			PendingFrame(const MarkerProperties &markerProperties) : markerProperties(markerProperties) {
+			}
+
+			/// <summary>
+			/// The sequence number of the frame within its stream
+			/// </summary>
+			long long sequence;
+
+			/// <summary>
+			/// The tick count at which the frame was submitted
+			/// </summary>
+			int64 submitTicks;
+
+			/// <summary>
+			/// Angle in degrees of the rotation of the marker
+			/// </summary>
+			double rotation;
+
+			/// <summary>
+			/// Properties of the measured marker in this frame
+			/// </summary>
+			MarkerProperties markerProperties;
+
+			/// <summary>
+			/// The copy of the submitted frame
+			/// </summary>
+			Mat frame;
+		};
+
+		/// <summary>
+		/// A registered stream with the frames waiting to be processed
+		/// </summary>
+		struct Stream {
+			/// <summary>
+			/// Initializes a new instance of the <see cref="Stream"/> struct.
+			/// </summary>
+			/// <param name="id">The identifier of the stream</param>
+			/// <param name="markerProperties">Properties of the measured marker</param>
+			/// <param name="stripeProperties">Properties of the striped underneath the measured marker</param>
+			/// <param name="latencyBudget">The time in seconds a frame may wait before it is skipped</param>
+			/// <param name="callback">Receives the results of the stream</param>
+			/// <param name="boardSlot">The slot of the level board the levels are published to</param>
+			/// <param name="options">The options which select how frames are processed</param>
+			Stream(int id, const MarkerProperties &markerProperties, const StripeProperties &stripeProperties, double latencyBudget, ResultCallback callback, int boardSlot, TrackerOptions options)
+				: id(id), markerProperties(markerProperties), stripeProperties(stripeProperties), latencyBudget(latencyBudget), callback(callback),
+				boardSlot(boardSlot), tracker(options), scheduled(false), nextSequence(0), statistics() {
+			}
+
+			/// <summary>
+			/// The identifier of the stream
+			/// </summary>
+			int id;
+
+			/// <summary>
+			/// Properties of the marker where it was registered
+			/// </summary>
+			MarkerProperties markerProperties;
+
+			/// <summary>
+			/// Properties of the striped underneath the measured marker
+			/// </summary>
+			StripeProperties stripeProperties;
+
+			/// <summary>
+			/// The time in seconds a frame may wait before it is skipped, 0 to process every frame
+			/// </summary>
+			double latencyBudget;
+
+			/// <summary>
+			/// Receives the results of the stream, empty to use the completion queue
+			/// </summary>
+			ResultCallback callback;
+
+			/// <summary>
+			/// The slot of the level board the levels are published to, -1 to not publish them
+			/// </summary>
+			int boardSlot;
+
+			/// <summary>
+			/// The tracker with the scratch buffers of the stream, only used by the thread holding the stream
+			/// </summary>
+			WaterLevelTracker tracker;
+
+			/// <summary>
+			/// Guards the pending frames, the scheduled flag and the statistics
+			/// </summary>
+			std::mutex mutex;
+
+			/// <summary>
+			/// The frames waiting to be processed, oldest first
+			/// </summary>
+			std::deque<PendingFrame> pending;
+
+			/// <summary>
+			/// Whether the stream is in a queue or being processed, a stream is never in two places at once
+			/// </summary>
+			bool scheduled;
+
+			/// <summary>
+			/// The sequence number of the next submitted frame
+			/// </summary>
+			long long nextSequence;
+
+			/// <summary>
+			/// The counters of the stream
+			/// </summary>
+			StreamStatistics statistics;
+		};
+
+		/// <summary>
+		/// The queue of streams of one thread of the pool
+		/// </summary>
+		struct WorkerQueue {
+			/// <summary>
+			/// Guards the streams
+			/// </summary>
+			std::mutex mutex;
+
+			/// <summary>
+			/// The scheduled streams, the owner takes from the front and thieves from the back
+			/// </summary>
+			std::deque<Stream*> streams;
+		};
+
+		/// <summary>
+		/// The options which select how frames are processed
+		/// </summary>
+		TrackerOptions options;
+
+		/// <summary>
+		/// Every registered stream, indexed by identifier
+		/// </summary>
+		std::vector<std::unique_ptr<Stream>> streams;
+
+		/// <summary>
+		/// Guards the list of streams
+		/// </summary>
+		std::mutex streamsMutex;
+
+		/// <summary>
+		/// The queue of every thread of the pool
+		/// </summary>
+		std::vector<std::unique_ptr<WorkerQueue>> queues;
+
+		/// <summary>
+		/// The threads of the pool
+		/// </summary>
+		std::vector<std::thread> workers;
+
+		/// <summary>
+		/// Whether the threads should keep running
+		/// </summary>
+		std::atomic<bool> running;
+
+		/// <summary>
+		/// The amount of streams in the queues
+		/// </summary>
+		std::atomic<int> queuedCount;
+
+		/// <summary>
+		/// The queue the next newly scheduled stream is put in
+		/// </summary>
+		std::atomic<unsigned int> nextQueue;
+
+		/// <summary>
+		/// The amount of times a thread took a stream from the queue of another thread
+		/// </summary>
+		std::atomic<long long> stealCount;
+
+		/// <summary>
+		/// Guards the sleeping of idle threads
+		/// </summary>
+		std::mutex sleepMutex;
+
+		/// <summary>
+		/// Wakes idle threads when a stream is scheduled
+		/// </summary>
+		std::condition_variable wake;
+
+		/// <summary>
+		/// The amount of submitted frames without a result, guarded by the idle mutex
+		/// </summary>
+		long long outstandingCount;
+
+		/// <summary>
+		/// Guards the amount of outstanding frames
+		/// </summary>
+		std::mutex idleMutex;
+
+		/// <summary>
+		/// Signals that every submitted frame has a result
+		/// </summary>
+		std::condition_variable idle;
+
+		/// <summary>
+		/// The results of the streams without a callback
+		/// </summary>
+		std::deque<EngineResult> completions;
+
+		/// <summary>
+		/// Guards the completion queue
+		/// </summary>
+		std::mutex completionsMutex;
+
+		/// <summary>
+		/// Gets a registered stream
+		/// </summary>
+		/// <param name="stream">The identifier of the stream</param>
+		/// <returns>The stream or nullptr if it does not exist</returns>
+		Stream *Find(int stream);
+
+		/// <summary>
+		/// Put a stream in a queue of the pool and wake a thread for it
+		/// </summary>
+		/// <param name="queue">The index of the queue</param>
+		/// <param name="stream">The stream to schedule</param>
+		void Schedule(int queue, Stream *stream);
+
+		/// <summary>
+		/// Take a stream from the own queue, or from the queue of another thread if it is empty
+		/// </summary>
+		/// <param name="worker">The index of the thread</param>
+		/// <returns>The stream or nullptr if every queue is empty</returns>
+		Stream *Take(int worker);
+
+		/// <summary>
+		/// Run a thread of the pool until the engine is stopped
+		/// </summary>
+		/// <param name="worker">The index of the thread</param>
+		void Run(int worker);
+
+		/// <summary>
+		/// Process the oldest frame of a stream, skipping the frames that outlived the latency budget, and schedule the stream again if frames are left
+		/// </summary>
+		/// <param name="worker">The index of the thread</param>
+		/// <param name="stream">The stream to process</param>
+		void Process(int worker, Stream &stream);
+
+		/// <summary>
+		/// Hand a result to the callback of its stream or to the completion queue
+		/// </summary>
+		/// <param name="stream">The stream of the result</param>
+		/// <param name="result">The result</param>
+		void Deliver(Stream &stream, const EngineResult &result);
+
+		/// <summary>
+		/// Count frames as done and wake the waiting threads when no frame is left
+		/// </summary>
+		/// <param name="count">The amount of frames which got a result</param>
+		void Complete(int count);
+	};
+}
+
+#endif
\ No newline at end of file
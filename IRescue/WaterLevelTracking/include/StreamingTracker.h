@@ -0,0 +1,235 @@
+// <copyright file="StreamingTracker.h" company="Delft University of Technology">
+// Copyright (c) Delft University of Technology. All rights reserved.
+// </copyright>
+
+#ifndef __STREAMINGTRACKER_H__
+#define __STREAMINGTRACKER_H__
+
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <thread>
+#include <vector>
+#include <opencv2/opencv.hpp>
+#include "DropOldestQueue.h"
+#include "MarkerProperties.h"
+#include "StripeProperties.h"
+#include "TrackerOptions.h"
+#include "WaterLevelTracker.h"
+
+namespace waterleveltracking {
+	/// <summary>
+	/// The water level calculated for a frame of the stream
+	/// </summary>
+	struct StreamResult {
+		/// <summary>
+		/// The sequence number of the frame, counting from 0 in the order of submission
+		/// </summary>
+		long long sequence;
+
+		/// <summary>
+		/// The height of the water in meters, NULL if it cannot be derived from the frame
+		/// </summary>
+		double level;
+
+		/// <summary>
+		/// The time in seconds between the submission of the frame and the calculated level
+		/// </summary>
+		double latency;
+	};
+
+	/// <summary>
+	/// Calculates the water level of a stream of frames in a pipeline of four stages, each running on its own thread:
+	/// colour conversion, region extraction, blur and segmentation, and stripe counting.
+	/// The stages are connected by bounded queues which drop the oldest frame when a stage falls behind.
+	/// </summary>
+	class StreamingTracker
+	{
+	public:
+		/// <summary>
+		/// Initializes a new instance of the <see cref="StreamingTracker"/> class and starts the stages.
+		/// </summary>
+		/// <param name="markerProperties">Properties of the measured marker</param>
+		/// <param name="stripeProperties">Properties of the striped underneath the measured marker</param>
+		/// <param name="options">The options which select how frames are processed</param>
+		/// <param name="queueCapacity">The amount of frames which can wait in front of each stage</param>
+		StreamingTracker(const MarkerProperties &markerProperties, const StripeProperties &stripeProperties, TrackerOptions options = TrackerOptions(), int queueCapacity = 2);
+
+		/// <summary>
+		/// Stops the stages and waits for them to finish.
+		/// </summary>
+		~StreamingTracker();
+
+		/// <summary>
+		/// Submit a frame to the pipeline. The frame is copied, so the caller can reuse it right away.
+		/// Must always be called from the same thread.
+		/// </summary>
+		/// <param name="frame">The captured frame of the video feed</param>
+		/// <param name="markerProperties">Properties of the measured marker in this frame</param>
+		/// <param name="stripeProperties">Properties of the striped underneath the measured marker</param>
+		/// <param name="rotation">Angle in degrees of the rotation of the marker</param>
+		void Submit(const Mat &frame, const MarkerProperties &markerProperties, const StripeProperties &stripeProperties, double rotation);
+
+		/// <summary>
+		/// Take the newest calculated water level, older results which were not taken yet are dropped.
+		/// Must always be called from the same thread.
+		/// </summary>
+		/// <param name="result">The newest result</param>
+		/// <returns>False if no new result was available</returns>
+		bool TryGetResult(StreamResult &result);
+
+		/// <summary>
+		/// Gets the amount of frames which were dropped because a stage or the consumer fell behind
+		/// </summary>
+		long long GetDroppedCount();
+
+	private:
+		/// <summary>
+		/// The amount of stages in the pipeline
+		/// </summary>
+		static const int StageCount = 4;
+
+		/// <summary>
+		/// A frame on its way through the pipeline, with a buffer for the output of every stage
+		/// </summary>
+		struct Job {
+			/// <summary>
+			/// Initializes a new instance of the <see cref="Job"/> struct.
+			/// </summary>
+			/// <param name="markerProperties">Properties of the measured marker</param>
+			/// <param name="stripeProperties">Properties of the striped underneath the measured marker</param>
+			Job(const MarkerProperties &markerProperties, const StripeProperties &stripeProperties)
+				: markerProperties(markerProperties), stripeProperties(stripeProperties), inUse(false) {
+			}
+
+			/// <summary>
+			/// The sequence number of the frame
+			/// </summary>
+			long long sequence;
+
+			/// <summary>
+			/// The tick count at which the frame was submitted
+			/// </summary>
+			int64 submitTicks;
+
+			/// <summary>
+			/// Angle in degrees of the rotation of the marker
+			/// </summary>
+			double rotation;
+
+			/// <summary>
+			/// The calculated height of the water in meters
+			/// </summary>
+			double level;
+
+			/// <summary>
+			/// False once a stage found the water level cannot be derived from the frame
+			/// </summary>
+			bool valid;
+
+			/// <summary>
+			/// Properties of the measured marker
+			/// </summary>
+			MarkerProperties markerProperties;
+
+			/// <summary>
+			/// Properties of the striped underneath the measured marker
+			/// </summary>
+			StripeProperties stripeProperties;
+
+			/// <summary>
+			/// The copy of the submitted frame
+			/// </summary>
+			Mat frame;
+
+			/// <summary>
+			/// The output of the colour conversion stage
+			/// </summary>
+			Mat gray;
+
+			/// <summary>
+			/// The output of the region extraction stage
+			/// </summary>
+			Mat region;
+
+			/// <summary>
+			/// The row profile put out by the blur and segmentation stage
+			/// </summary>
+			std::vector<uchar> profile;
+
+			/// <summary>
+			/// Whether the job is somewhere in the pipeline
+			/// </summary>
+			std::atomic<bool> inUse;
+		};
+
+		/// <summary>
+		/// Every job of the pipeline, enough to never run out while all queues are full
+		/// </summary>
+		std::vector<std::unique_ptr<Job>> jobs;
+
+		/// <summary>
+		/// The queue in front of every stage, followed by the queue of results
+		/// </summary>
+		std::vector<std::unique_ptr<DropOldestQueue<Job>>> queues;
+
+		/// <summary>
+		/// One tracker per stage, so every stage has its own scratch buffers
+		/// </summary>
+		std::vector<WaterLevelTracker> trackers;
+
+		/// <summary>
+		/// The thread of every stage
+		/// </summary>
+		std::vector<std::thread> workers;
+
+		/// <summary>
+		/// Whether the stages should keep running
+		/// </summary>
+		std::atomic<bool> running;
+
+		/// <summary>
+		/// The amount of frames which were dropped
+		/// </summary>
+		std::atomic<long long> droppedCount;
+
+		/// <summary>
+		/// The sequence number of the next submitted frame
+		/// </summary>
+		long long nextSequence;
+
+		/// <summary>
+		/// Run a stage until the pipeline is stopped
+		/// </summary>
+		/// <param name="stage">The index of the stage</param>
+		void Run(int stage);
+
+		/// <summary>
+		/// Perform the work of a stage on a job
+		/// </summary>
+		/// <param name="stage">The index of the stage</param>
+		/// <param name="job">The job to work on</param>
+		void Process(int stage, Job &job);
+
+		/// <summary>
+		/// Hand a job to the queue behind a stage, releasing the job it dropped if any
+		/// </summary>
+		/// <param name="queue">The index of the queue</param>
+		/// <param name="job">The job to hand over</param>
+		void Forward(int queue, Job *job);
+
+		/// <summary>
+		/// Take a job which is not in the pipeline
+		/// </summary>
+		/// <returns>The free job</returns>
+		Job *Acquire();
+
+		/// <summary>
+		/// Return a job so it can be reused
+		/// </summary>
+		/// <param name="job">The job to return</param>
+		void Release(Job *job);
+	};
+}
+
+#endif
\ No newline at end of file
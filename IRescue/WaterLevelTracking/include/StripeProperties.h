@@ -20,7 +20,7 @@ namespace waterleveltracking {
 		/// <param name="markerProperties">The properties of the marker which is currently visible</param>
 		/// <param name="stripeHeight">The height of individual stripes in meters</param>
 		/// <param name="stripeCount">The amount of stripes located under the marker</pafram>
-		StripeProperties(MarkerProperties markerProperties, double stripeHeight, int stripeCount);
+		StripeProperties(const MarkerProperties &markerProperties, double stripeHeight, int stripeCount);
 
 		/// <summary>
 		/// Sets the stripe height
@@ -30,7 +30,7 @@ namespace waterleveltracking {
 		/// <summary>
 		/// Gets the stripe height
 		/// </summary>
-		double GetStripeHeight();
+		double GetStripeHeight() const;
 
 		/// <summary>
 		/// Sets the stripe stripe start
@@ -40,7 +40,7 @@ namespace waterleveltracking {
 		/// <summary>
 		/// Gets the stripe stripe start
 		/// </summary>
-		double GetStripeStart();
+		double GetStripeStart() const;
 
 		/// <summary>
 		/// Sets the stripe stripe count
@@ -50,7 +50,7 @@ namespace waterleveltracking {
 		/// <summary>
 		/// Gets the stripe stripe count
 		/// </summary>
-		int GetStripeCount();
+		int GetStripeCount() const;
 
 		/// <summary>
 		/// Sets the stripe stripe pixel height
@@ -60,7 +60,7 @@ namespace waterleveltracking {
 		/// <summary>
 		/// Gets the stripe stripe pixel height
 		/// </summary>
-		int GetStripePixelHeight();
+		int GetStripePixelHeight() const;
 
 		/// <summary>
 		/// Sets the stripe stripe pixel start
@@ -70,7 +70,7 @@ namespace waterleveltracking {
 		/// <summary>
 		/// Gets the stripe stripe pixel start
 		/// </summary>
-		int GetStripePixelStart();
+		int GetStripePixelStart() const;
 
 	private:
 		/// <summary>
@@ -0,0 +1,153 @@
+// <copyright file="TrackerOptions.h" company="Delft University of Technology">
+// Copyright (c) Delft University of Technology. All rights reserved.
+// </copyright>
+
+#ifndef __TRACKEROPTIONS_H__
+#define __TRACKEROPTIONS_H__
+
+namespace waterleveltracking {
+	/// <summary>
+	/// The way the stripe region is straightened before the stripes are counted
+	/// </summary>
+	enum class RegionMode {
+		/// <summary>
+		/// Rotate the entire frame and crop the stripe region out of the result
+		/// </summary>
+		FullFrame,
+
+		/// <summary>
+		/// Resample only the oriented stripe region straight from the unrotated frame
+		/// </summary>
+		OrientedRegion,
+
+		/// <summary>
+		/// Like OrientedRegion, but the geometry and the resampling table are calculated once for a camera that does not move.
+		/// They are only calculated again when the frame size or the quantized rotation changes or the marker moves.
+		/// </summary>
+		FixedCamera
+	};
+
+	/// <summary>
+	/// The way the stripe region is reduced to one verdict per row
+	/// </summary>
+	enum class ProfileMode {
+		/// <summary>
+		/// Blur the whole region and count the bright pixels of every row
+		/// </summary>
+		Region,
+
+		/// <summary>
+		/// Collapse every row to its mean intensity first and blur and threshold that 1-D profile
+		/// </summary>
+		RowMean,
+
+		/// <summary>
+		/// Like RowMean, but the darkest and brightest quarter of every row are left out of the mean
+		/// </summary>
+		RowTrimmedMean,
+
+		/// <summary>
+		/// Take a wider stripe region, split it into narrow vertical bands and count the stripes of every band from one integral image.
+		/// The median count of the bands is used, so an occlusion or glare spot in a few bands does not change the result
+		/// </summary>
+		BandVote
+	};
+
+	/// <summary>
+	/// The order of the color channels of the frames
+	/// </summary>
+	enum class ChannelOrder {
+		/// <summary>
+		/// Red first, like the frames Unity hands over
+		/// </summary>
+		Rgb,
+
+		/// <summary>
+		/// Blue first, like most camera buffers
+		/// </summary>
+		Bgr
+	};
+
+	/// <summary>
+	/// Options which select how a frame is processed by the water level tracker
+	/// </summary>
+	struct TrackerOptions {
+		/// <summary>
+		/// The way the stripe region is straightened
+		/// </summary>
+		RegionMode regionMode = RegionMode::FullFrame;
+
+		/// <summary>
+		/// The way the stripe region is reduced to one verdict per row
+		/// </summary>
+		ProfileMode profileMode = ProfileMode::Region;
+
+		/// <summary>
+		/// The order of the color channels of color frames, with or without an alpha channel
+		/// </summary>
+		ChannelOrder channelOrder = ChannelOrder::Rgb;
+
+		/// <summary>
+		/// The size of the Gaussian blur before thresholding. Sizes 3 and 5 with the default threshold run a fused integer kernel,
+		/// other combinations use the generic OpenCV path
+		/// </summary>
+		int blurSize = 5;
+
+		/// <summary>
+		/// The intensity above which a pixel counts as white
+		/// </summary>
+		int threshold = 150;
+
+		/// <summary>
+		/// The step in degrees the rotation is rounded to in the FixedCamera mode, 0 to use the rotation as is
+		/// </summary>
+		double angleStep = 0.1;
+
+		/// <summary>
+		/// The amount of pixels a marker corner may move before the FixedCamera mode calculates the geometry again
+		/// </summary>
+		int cornerTolerance = 2;
+
+		/// <summary>
+		/// The minimum height in pixels a stripe may have after downscaling. When set, the frame is halved as often as
+		/// the stripes allow before it is processed, 0 to always process the frame at full resolution
+		/// </summary>
+		int minStripePixelHeight = 0;
+
+		/// <summary>
+		/// The OrientedRegion and FixedCamera modes sample every this many columns of the stripe region straight from the frame,
+		/// 1 to sample every column. The FullFrame mode ignores it
+		/// </summary>
+		int columnStep = 1;
+
+		/// <summary>
+		/// The amount of vertical bands the stripe region is split into in the BandVote profile mode, at most 32
+		/// </summary>
+		int bandCount = 8;
+
+		/// <summary>
+		/// Whether to locate the water line inside the partially submerged stripe to a fraction of a pixel, which gives a continuous
+		/// level instead of one that moves in whole stripes
+		/// </summary>
+		bool subPixel = false;
+
+		/// <summary>
+		/// The mean absolute difference per pixel of the downscaled stripe region above which a frame counts as changed.
+		/// When set, frames whose stripe region did not change return the level of the last processed frame, 0 to process every frame
+		/// </summary>
+		double motionThreshold = 0;
+
+		/// <summary>
+		/// The amount of frames after which a frame is processed even if its stripe region did not change
+		/// </summary>
+		int motionInterval = 30;
+
+		/// <summary>
+		/// The time in seconds processing a frame may cost. When set, the blur, the bands, the sampled columns, the resolution of the
+		/// analysis and the amount of skipped frames are coarsened while the measured cost exceeds it, 0 to always process frames as configured
+		/// </summary>
+		double latencyBudget = 0;
+	};
+}
+
+#endif
\ No newline at end of file
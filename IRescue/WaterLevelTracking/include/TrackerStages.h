@@ -0,0 +1,57 @@
+// <copyright file="TrackerStages.h" company="Delft University of Technology">
+// Copyright (c) Delft University of Technology. All rights reserved.
+// </copyright>
+
+#ifndef __TRACKERSTAGES_H__
+#define __TRACKERSTAGES_H__
+
+#include <vector>
+#include "WaterLevelTracker.h"
+
+namespace waterleveltracking {
+	/// <summary>
+	/// Internal access to the separate stages of a <see cref="WaterLevelTracker"/> for the benchmarks and tests which time or check
+	/// one stage at a time. Not part of the interface of the library, callers track frames through the tracker itself.
+	/// </summary>
+	class TrackerStages
+	{
+	public:
+		static inline Mat ConvertToGray(WaterLevelTracker &tracker, const Mat &frame) {
+			return tracker.ConvertToGray(frame);
+		}
+
+		static inline Mat ExtractRegion(WaterLevelTracker &tracker, const Mat &frame, double rotation, MarkerProperties &markerProperties, StripeProperties &stripeProperties) {
+			return tracker.ExtractRegion(frame, rotation, markerProperties, stripeProperties);
+		}
+
+		static inline Mat Blur(WaterLevelTracker &tracker, const Mat &region) {
+			return tracker.Blur(region);
+		}
+
+		static inline void SegmentRegion(WaterLevelTracker &tracker, const Mat &region, std::vector<uchar> &profile) {
+			tracker.SegmentRegion(region, profile);
+		}
+
+		static inline void Segment(const Mat &frame, std::vector<uchar> &profile, int threshold = 150) {
+			WaterLevelTracker::Segment(frame, profile, threshold);
+		}
+
+		static inline double StripeCount(const std::vector<uchar> &profile, StripeProperties &stripeProperties) {
+			return WaterLevelTracker::StripeCount(profile, stripeProperties);
+		}
+
+		static inline void Crop(Mat &frame, int bottomLeftCornerX, int bottomRightCornerX, int stripePixelStart, int bottom, bool wide = false) {
+			WaterLevelTracker::Crop(frame, bottomLeftCornerX, bottomRightCornerX, stripePixelStart, bottom, wide);
+		}
+
+		static inline int FindBottom(const Mat &image, int column, int hint) {
+			return WaterLevelTracker::FindBottom(image, column, hint);
+		}
+
+		static inline int Rotate(WaterLevelTracker &tracker, const Mat &frame, double rotation, MarkerProperties &markerProperties, Mat &rotated) {
+			return tracker.Rotate(frame, rotation, markerProperties, rotated);
+		}
+	};
+}
+
+#endif
\ No newline at end of file
@@ -0,0 +1,69 @@
+// <copyright file="TrackingResult.h" company="Delft University of Technology">
+// Copyright (c) Delft University of Technology. All rights reserved.
+// </copyright>
+
+#ifndef __TRACKINGRESULT_H__
+#define __TRACKINGRESULT_H__
+
+/// <summary>
+/// Why a frame did or did not give a water level
+/// </summary>
+enum WltStatus {
+	/// <summary>
+	/// The frame gave a water level
+	/// </summary>
+	WLT_STATUS_OK = 0,
+
+	/// <summary>
+	/// The frame is empty or the marker or stripe configuration is wrong
+	/// </summary>
+	WLT_STATUS_INVALID_INPUT = 1,
+
+	/// <summary>
+	/// The stripe region lies outside the frame
+	/// </summary>
+	WLT_STATUS_OUTSIDE_FRAME = 2,
+
+	/// <summary>
+	/// The stripes end before the water is reached
+	/// </summary>
+	WLT_STATUS_IRREGULAR_STRIPES = 3,
+
+	/// <summary>
+	/// Every stripe is above the water
+	/// </summary>
+	WLT_STATUS_ALL_STRIPES_ABOVE_WATER = 4,
+
+	/// <summary>
+	/// The corners of the marker are unknown, it was not detected in the frame
+	/// </summary>
+	WLT_STATUS_MARKER_NOT_FOUND = 5
+};
+
+/// <summary>
+/// The outcome of tracking the water level in a frame
+/// </summary>
+typedef struct WltTrackingResult {
+	/// <summary>
+	/// Why the frame did or did not give a water level, a WltStatus
+	/// </summary>
+	int status;
+
+	/// <summary>
+	/// The height of the water in meters, only meaningful when the status is WLT_STATUS_OK
+	/// </summary>
+	double level;
+
+	/// <summary>
+	/// How much the level can be trusted, from 0 to 1. How evenly the counted stripes follow each other, times the share of the bands
+	/// which agree on the count in the BandVote profile mode
+	/// </summary>
+	double confidence;
+
+	/// <summary>
+	/// The amount of stripes above the water which were counted
+	/// </summary>
+	int stripeCount;
+} WltTrackingResult;
+
+#endif
\ No newline at end of file
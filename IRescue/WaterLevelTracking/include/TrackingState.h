@@ -0,0 +1,136 @@
+// <copyright file="TrackingState.h" company="Delft University of Technology">
+// Copyright (c) Delft University of Technology. All rights reserved.
+// </copyright>
+
+#ifndef __TRACKINGSTATE_H__
+#define __TRACKINGSTATE_H__
+
+#include <math.h>
+#include <vector>
+#include <opencv2/opencv.hpp>
+
+using namespace cv;
+
+namespace waterleveltracking {
+	/// <summary>
+	/// Remembers where the water line of a marker was found in the previous frames,
+	/// so the next frame only has to look at the rows around it.
+	/// </summary>
+	class TrackingState
+	{
+	public:
+		/// <summary>
+		/// Initializes a new instance of the <see cref="TrackingState"/> class.
+		/// </summary>
+		/// <param name="fullScanInterval">The amount of frames after which the whole stripe region is scanned again</param>
+		/// <param name="smoothing">The weight of a new level in the filtered level, between 0 and 1</param>
+		TrackingState(int fullScanInterval = 30, double smoothing = 0.3);
+
+		/// <summary>
+		/// Forget the water line, so the next frame is scanned completely
+		/// </summary>
+		void Reset();
+
+		/// <summary>
+		/// Whether a water line is known and the next frame may be checked around it only
+		/// </summary>
+		/// <param name="rows">The amount of rows of the stripe region of the next frame</param>
+		/// <returns>True if the rows around the previous water line can be checked</returns>
+		bool CanTrack(int rows);
+
+		/// <summary>
+		/// Remember the water line found in a frame
+		/// </summary>
+		/// <param name="profile">The row profile of the segmented stripe region</param>
+		/// <param name="boundaryRow">The last row of the lowest accepted stripe</param>
+		/// <param name="stripePixelHeight">The height in pixels of the lowest accepted stripe</param>
+		/// <param name="fullScan">Whether the whole stripe region was scanned</param>
+		void Update(const std::vector<uchar> &profile, int boundaryRow, int stripePixelHeight, bool fullScan);
+
+		/// <summary>
+		/// Smooth the reported level, a jump of more than a stripe is followed right away
+		/// </summary>
+		/// <param name="level">The level in meters calculated for the current frame</param>
+		/// <param name="stripeHeight">The height of individual stripes in meters</param>
+		/// <returns>The filtered level in meters</returns>
+		double Filter(double level, double stripeHeight);
+
+		/// <summary>
+		/// Gets the row profile of the previous frame
+		/// </summary>
+		const std::vector<uchar> &GetProfile();
+
+		/// <summary>
+		/// Gets the last row of the lowest accepted stripe in the previous frame
+		/// </summary>
+		int GetBoundaryRow();
+
+		/// <summary>
+		/// Gets the height in pixels of the lowest accepted stripe in the previous frame
+		/// </summary>
+		int GetStripePixelHeight();
+
+		/// <summary>
+		/// Gets the bottom row of the image found in the previous frame, -1 if unknown
+		/// </summary>
+		int GetImageBottom();
+
+		/// <summary>
+		/// Sets the bottom row of the image found in the current frame
+		/// </summary>
+		void SetImageBottom(int imageBottom);
+
+	private:
+		/// <summary>
+		/// Whether a water line is known
+		/// </summary>
+		bool locked;
+
+		/// <summary>
+		/// The row profile of the previous frame
+		/// </summary>
+		std::vector<uchar> profile;
+
+		/// <summary>
+		/// The last row of the lowest accepted stripe
+		/// </summary>
+		int boundaryRow;
+
+		/// <summary>
+		/// The height in pixels of the lowest accepted stripe
+		/// </summary>
+		int stripePixelHeight;
+
+		/// <summary>
+		/// The bottom row of the image found in the previous frame
+		/// </summary>
+		int imageBottom;
+
+		/// <summary>
+		/// The amount of frames since the whole stripe region was scanned
+		/// </summary>
+		int framesSinceFullScan;
+
+		/// <summary>
+		/// The amount of frames after which the whole stripe region is scanned again
+		/// </summary>
+		int fullScanInterval;
+
+		/// <summary>
+		/// Whether a filtered level is known
+		/// </summary>
+		bool filtered;
+
+		/// <summary>
+		/// The filtered level in meters
+		/// </summary>
+		double filteredLevel;
+
+		/// <summary>
+		/// The weight of a new level in the filtered level
+		/// </summary>
+		double smoothing;
+	};
+}
+
+#endif
\ No newline at end of file
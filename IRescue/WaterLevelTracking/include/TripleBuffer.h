@@ -0,0 +1,103 @@
+// <copyright file="TripleBuffer.h" company="Delft University of Technology">
+// Copyright (c) Delft University of Technology. All rights reserved.
+// </copyright>
+
+#ifndef __TRIPLEBUFFER_H__
+#define __TRIPLEBUFFER_H__
+
+#include <atomic>
+#include <cstdint>
+
+namespace waterleveltracking {
+	/// <summary>
+	/// Wait-free hand over of the latest value from one writer to one reader.
+	/// The writer fills a back buffer and swaps it with the middle buffer, the reader swaps its front buffer with the middle buffer
+	/// when it holds a newer value. Both sides only ever touch a buffer the other side cannot reach, so a value is never torn.
+	/// Writes may come from different threads as long as they do not overlap, the same goes for reads.
+	/// </summary>
+	template<typename T>
+	class TripleBuffer
+	{
+	public:
+		/// <summary>
+		/// Initializes a new instance of the <see cref="TripleBuffer"/> class.
+		/// </summary>
+		TripleBuffer() : middle(2), back(1), front(0), hasValue(false) {
+		}
+
+		/// <summary>
+		/// Publish a value, may only be called by the writer
+		/// </summary>
+		/// <param name="value">The value to publish</param>
+		void Publish(const T &value) {
+			this->buffers[this->back].value = value;
+			this->back = this->middle.exchange(this->back | Fresh, std::memory_order_acq_rel) & IndexMask;
+		}
+
+		/// <summary>
+		/// Read the latest published value, may only be called by the reader
+		/// </summary>
+		/// <param name="value">The latest value</param>
+		/// <returns>False if no value was published yet</returns>
+		bool Read(T &value) {
+			if ((this->middle.load(std::memory_order_relaxed) & Fresh) != 0) {
+				this->front = this->middle.exchange(this->front, std::memory_order_acq_rel) & IndexMask;
+				this->hasValue = true;
+			}
+
+			if (this->hasValue) {
+				value = this->buffers[this->front].value;
+			}
+
+			return this->hasValue;
+		}
+
+	private:
+		/// <summary>
+		/// The bits of the middle index which hold the buffer
+		/// </summary>
+		static const uint8_t IndexMask = 3;
+
+		/// <summary>
+		/// The bit of the middle index which is set while the middle buffer holds a value the reader has not seen
+		/// </summary>
+		static const uint8_t Fresh = 4;
+
+		/// <summary>
+		/// A buffer on a cache line of its own, so the writer and the reader do not slow each other down
+		/// </summary>
+		struct alignas(64) Buffer {
+			/// <summary>
+			/// The value
+			/// </summary>
+			T value;
+		};
+
+		/// <summary>
+		/// The three buffers
+		/// </summary>
+		Buffer buffers[3];
+
+		/// <summary>
+		/// The index of the buffer between the writer and the reader, with the fresh bit
+		/// </summary>
+		alignas(64) std::atomic<uint8_t> middle;
+
+		/// <summary>
+		/// The index of the buffer of the writer
+		/// </summary>
+		alignas(64) uint8_t back;
+
+		/// <summary>
+		/// The index of the buffer of the reader
+		/// </summary>
+		alignas(64) uint8_t front;
+
+		/// <summary>
+		/// Whether the reader took a value yet
+		/// </summary>
+		bool hasValue;
+	};
+}
+
+#endif
\ No newline at end of file
@@ -8,17 +8,76 @@
 #include <iostream>
 #include <opencv2/opencv.hpp>
 #include <math.h>
+#include "FrameRecorder.h"
+#include "FusedKernels.h"
+#include "Instrumentation.h"
+#include "LatencyGovernor.h"
+#include "RowProfile.h"
+#include "SegmentKernels.h"
 #include "Square.h"
 #include "MarkerProperties.h"
+#include "MotionGate.h"
+#include "RegionCalibration.h"
 #include "StripeProperties.h"
+#include "TrackerOptions.h"
+#include "TrackingResult.h"
+#include "TrackingState.h"
 
 namespace waterleveltracking {
+	/// <summary>
+	/// The outcome of counting the stripes in a row profile from the top down
+	/// </summary>
+	struct StripeScan {
+		/// <summary>
+		/// False if the stripes end in a way the water level cannot be derived from
+		/// </summary>
+		bool valid;
+
+		/// <summary>
+		/// Whether the count stopped at a run which is too long to be a stripe, which is where the water starts
+		/// </summary>
+		bool reachedWater;
+
+		/// <summary>
+		/// The amount of counted stripes
+		/// </summary>
+		int count;
+
+		/// <summary>
+		/// The last row of the lowest accepted stripe
+		/// </summary>
+		int boundaryRow;
+
+		/// <summary>
+		/// The height in pixels of the lowest accepted stripe
+		/// </summary>
+		int stripePixelHeight;
+
+		/// <summary>
+		/// The share of the bands which counted the same amount of stripes, 1 for a single row profile
+		/// </summary>
+		double agreement;
+
+		/// <summary>
+		/// How evenly the accepted stripes follow each other, from 0 when every stripe is at the 30% tolerance to 1 when they are all as high
+		/// as the expected first stripe
+		/// </summary>
+		double consistency;
+	};
+
 	/// <summary>
 	/// The class can calculate the water level.
+	/// An instance owns the scratch buffers of the pipeline and reuses them for every frame it processes.
 	/// </summary>
 	class WaterLevelTracker
 	{
 	public:
+		/// <summary>
+		/// Initializes a new instance of the <see cref="WaterLevelTracker"/> class.
+		/// </summary>
+		/// <param name="options">The options which select how frames are processed</param>
+		WaterLevelTracker(TrackerOptions options = TrackerOptions());
+
 		/// <summary>
 		/// Predict the height of the water level using markers.
 		/// Return NULL if the the water level cannot be derived from the information
@@ -29,14 +88,275 @@ namespace waterleveltracking {
 		/// <param name="stripeProperties">Properties of the striped underneath the measured marker</param>
 		/// <param name="rotation">Angle in degrees of the rotation of the marker</param>
 		/// <returns>The height of the water in meters</returns>
-		static double WaterLevelTracker::CalculateWaterLevel(Mat &frame, MarkerProperties &markerProperties, StripeProperties &stripeProperties, double rotation);
+		static double CalculateWaterLevel(Mat &frame, MarkerProperties &markerProperties, StripeProperties &stripeProperties, double rotation);
+
+		/// <summary>
+		/// Predict the height of the water level using markers, processing the frame as selected by the options.
+		/// Return NULL if the the water level cannot be derived from the information
+		/// </summary>
+		/// <param name="frame">The captured frame of the video feed</param>
+		/// <param name="markerProperties">Properties of the measured marker</param>
+		/// <param name="stripeProperties">Properties of the striped underneath the measured marker</param>
+		/// <param name="rotation">Angle in degrees of the rotation of the marker</param>
+		/// <param name="options">The options which select how the frame is processed</param>
+		/// <returns>The height of the water in meters</returns>
+		static double CalculateWaterLevel(Mat &frame, MarkerProperties &markerProperties, StripeProperties &stripeProperties, double rotation, TrackerOptions options);
+
+		/// <summary>
+		/// Predict the height of the water level using markers and tell why the frame did or did not give one, without throwing.
+		/// The stripe region is validated from the corners before any pixel is touched
+		/// </summary>
+		/// <param name="frame">The captured frame of the video feed</param>
+		/// <param name="markerProperties">Properties of the measured marker</param>
+		/// <param name="stripeProperties">Properties of the striped underneath the measured marker</param>
+		/// <param name="rotation">Angle in degrees of the rotation of the marker</param>
+		/// <param name="options">The options which select how the frame is processed</param>
+		/// <returns>The status, level, confidence and stripe count of the frame</returns>
+		static WltTrackingResult MeasureWaterLevel(const Mat &frame, MarkerProperties &markerProperties, StripeProperties &stripeProperties, double rotation, TrackerOptions options = TrackerOptions());
+
+		/// <summary>
+		/// Predict the height of the water level using markers, reusing the scratch buffers of this tracker.
+		/// The frame itself is not modified.
+		/// Return NULL if the the water level cannot be derived from the information
+		/// </summary>
+		/// <param name="frame">The captured frame of the video feed</param>
+		/// <param name="markerProperties">Properties of the measured marker</param>
+		/// <param name="stripeProperties">Properties of the striped underneath the measured marker</param>
+		/// <param name="rotation">Angle in degrees of the rotation of the marker</param>
+		/// <returns>The height of the water in meters</returns>
+		double Track(const Mat &frame, MarkerProperties &markerProperties, StripeProperties &stripeProperties, double rotation);
+
+		/// <summary>
+		/// Predict the height of the water level using markers, checking the rows around the water line of the previous frame first.
+		/// The whole stripe region is only scanned when that check fails. The returned level is filtered over the frames.
+		/// Return NULL if the the water level cannot be derived from the information
+		/// </summary>
+		/// <param name="frame">The captured frame of the video feed</param>
+		/// <param name="markerProperties">Properties of the measured marker</param>
+		/// <param name="stripeProperties">Properties of the striped underneath the measured marker</param>
+		/// <param name="rotation">Angle in degrees of the rotation of the marker</param>
+		/// <param name="state">The tracking state of the marker, updated with this frame</param>
+		/// <returns>The filtered height of the water in meters</returns>
+		double Track(const Mat &frame, MarkerProperties &markerProperties, StripeProperties &stripeProperties, double rotation, TrackingState &state);
+
+		/// <summary>
+		/// Predict the height of the water level using markers and tell why the frame did or did not give one, reusing the scratch buffers of this tracker
+		/// </summary>
+		/// <param name="frame">The captured frame of the video feed</param>
+		/// <param name="markerProperties">Properties of the measured marker</param>
+		/// <param name="stripeProperties">Properties of the striped underneath the measured marker</param>
+		/// <param name="rotation">Angle in degrees of the rotation of the marker</param>
+		/// <returns>The status, level, confidence and stripe count of the frame</returns>
+		WltTrackingResult Measure(const Mat &frame, MarkerProperties &markerProperties, StripeProperties &stripeProperties, double rotation);
+
+		/// <summary>
+		/// Predict the height of the water level using markers with the tracking state of the marker and tell why the frame did or did not give one
+		/// </summary>
+		/// <param name="frame">The captured frame of the video feed</param>
+		/// <param name="markerProperties">Properties of the measured marker</param>
+		/// <param name="stripeProperties">Properties of the striped underneath the measured marker</param>
+		/// <param name="rotation">Angle in degrees of the rotation of the marker</param>
+		/// <param name="state">The tracking state of the marker, updated with this frame</param>
+		/// <returns>The status, filtered level, confidence and stripe count of the frame</returns>
+		WltTrackingResult Measure(const Mat &frame, MarkerProperties &markerProperties, StripeProperties &stripeProperties, double rotation, TrackingState &state);
+
+		/// <summary>
+		/// Check the frame and the geometry of the marker and the stripes from the corners alone, without touching a pixel
+		/// </summary>
+		/// <param name="frameSize">The size of the frame</param>
+		/// <param name="rotation">Angle in degrees of the rotation of the marker</param>
+		/// <param name="markerProperties">Properties of the measured marker</param>
+		/// <param name="stripeProperties">Properties of the striped underneath the measured marker</param>
+		/// <param name="bounds">Receives the bounds of the stripe region in the unrotated frame, clipped to the frame</param>
+		/// <returns>WLT_STATUS_OK if the frame can give a water level, otherwise why it cannot</returns>
+		int Validate(Size frameSize, double rotation, MarkerProperties &markerProperties, StripeProperties &stripeProperties, Rect &bounds);
+
+		/// <summary>
+		/// Gets the result of the last frame which was processed
+		/// </summary>
+		WltTrackingResult GetLastResult();
+
+		/// <summary>
+		/// Gets the row profile the stripes of the last processed frame were counted from, empty if the frame was rejected before that
+		/// </summary>
+		const std::vector<uchar> &GetLastProfile();
+
+		/// <summary>
+		/// Predict the height of the water level from a stripe region which was already straightened, for instance a recorded one.
+		/// Return NULL if the the water level cannot be derived from the information
+		/// </summary>
+		/// <param name="region">The grayscale stripe region</param>
+		/// <param name="stripeProperties">Properties of the striped underneath the measured marker, with the stripe height in pixels of the region</param>
+		/// <returns>The height of the water in meters</returns>
+		double TrackRegion(const Mat &region, StripeProperties &stripeProperties);
+
+		/// <summary>
+		/// Allocate the scratch buffers up front for frames of the given size
+		/// </summary>
+		/// <param name="frameSize">The size of the frames which will be processed</param>
+		void Reserve(Size frameSize);
+
+		/// <summary>
+		/// Gets the options
+		/// </summary>
+		TrackerOptions GetOptions();
+
+		/// <summary>
+		/// Sets the options
+		/// </summary>
+		void SetOptions(TrackerOptions options);
+
+		/// <summary>
+		/// Gets the amount of times a scratch buffer of this tracker had to be allocated.
+		/// Once the buffers fit the frames this stays constant. It only counts the growth of these buffers, OpenCV may still allocate
+		/// temporaries of its own inside the blur, the warp and the color conversion.
+		/// </summary>
+		int GetAllocationCount();
+
+		/// <summary>
+		/// Gets the amount of times the FixedCamera mode had to calculate the geometry of the stripe region
+		/// </summary>
+		int GetCalibrationCount();
+
+		/// <summary>
+		/// Gets the amount of frames which returned the level of the last processed frame because their stripe region did not change
+		/// </summary>
+		long long GetSkippedCount();
+
+		/// <summary>
+		/// Gets the quality level the latency budget currently allows, 0 when frames are processed as configured
+		/// </summary>
+		int GetQualityLevel();
+
+		/// <summary>
+		/// Gets the amount of frames which returned the level of the last processed frame to stay within the latency budget
+		/// </summary>
+		long long GetBudgetSkippedCount();
+
+		/// <summary>
+		/// Sets the recorder every processed frame is appended to, NULL to stop recording. The recorder is not owned by the tracker
+		/// </summary>
+		void SetRecorder(FrameRecorder *recorder);
 
 	private:
 		/// <summary>
-		/// Perform a smoothing on the image using a Gaussian blur.
+		/// The trackers which run the stages of a frame apart, the registry which tracks its markers with one tracker, and the internal
+		/// stage access of the benchmarks and tests
+		/// </summary>
+		friend class BatchTracker;
+		friend class MarkerRegistry;
+		friend class StreamingTracker;
+		friend class TrackerStages;
+
+		/// <summary>
+		/// Exchange the state this tracker keeps from frame to frame with the state of a marker, so one tracker and its scratch buffers
+		/// track many markers. Exchanging the same state again restores the state of this tracker.
+		/// The motion gate and the governor follow the options of this tracker, the quality level follows the governor of the marker
+		/// </summary>
+		/// <param name="calibrations">The calibration of every pyramid level of the marker</param>
+		/// <param name="motionGate">The motion gate of the marker</param>
+		/// <param name="governor">The latency governor of the marker</param>
+		void SwapMarkerState(RegionCalibration calibrations[], MotionGate &motionGate, LatencyGovernor &governor);
+
+		/// <summary>
+		/// Gets the color conversion code which converts frames with the channel order of the options to grayscale
+		/// </summary>
+		/// <param name="options">The options which select how frames are processed</param>
+		/// <returns>The color conversion code</returns>
+		static int GrayConversion(const TrackerOptions &options);
+
+		/// <summary>
+		/// Convert the frame to grayscale, a frame which already is grayscale is returned as is
+		/// </summary>
+		/// <param name="frame">The captured frame of the video feed</param>
+		/// <returns>The grayscale frame</returns>
+		Mat ConvertToGray(const Mat &frame);
+
+		/// <summary>
+		/// Straighten the area underneath the marker that contains the stripes.
+		/// Return an empty region if the stripe region lies outside the frame
 		/// </summary>
 		/// <param name="frame">The captured frame of the video feed</param>
-		static void Blur(Mat &frame);
+		/// <param name="rotation">Angle in degrees of the rotation of the marker</param>
+		/// <param name="markerProperties">Properties of the measured marker</param>
+		/// <param name="stripeProperties">Properties of the striped underneath the measured marker</param>
+		/// <returns>The grayscale stripe region</returns>
+		Mat ExtractRegion(const Mat &frame, double rotation, MarkerProperties &markerProperties, StripeProperties &stripeProperties);
+
+		/// <summary>
+		/// Perform a smoothing on the image using a Gaussian blur.
+		/// </summary>
+		/// <param name="region">The stripe region</param>
+		/// <returns>The blurred stripe region</returns>
+		Mat Blur(const Mat &region);
+
+		/// <summary>
+		/// Reduce the stripe region to one verdict per row in the way selected by the profile mode of the options
+		/// </summary>
+		/// <param name="region">The grayscale stripe region</param>
+		/// <param name="profile">Receives 255 for every row of a white stripe and 0 for every other row</param>
+		void SegmentRegion(const Mat &region, std::vector<uchar> &profile);
+
+		/// <summary>
+		/// Split the stripe region into the vertical bands of the options and decide per row of every band whether it belongs to a white stripe.
+		/// The mean of every band row is taken from one integral image of the region, so a band row costs the same for any band width.
+		/// </summary>
+		/// <param name="region">The grayscale stripe region</param>
+		/// <param name="profiles">Receives the row profiles of the bands one after the other, each with one verdict per row</param>
+		void SegmentBands(const Mat &region, std::vector<uchar> &profiles);
+
+		/// <summary>
+		/// Threshold the blurred stripe region and decide per row whether it belongs to a white stripe.
+		/// </summary>
+		/// <param name="frame">The blurred stripe region</param>
+		/// <param name="profile">Receives 255 for every row of a white stripe and 0 for every other row</param>
+		/// <param name="threshold">The intensity above which a pixel counts as white</param>
+		static void Segment(const Mat &frame, std::vector<uchar> &profile, int threshold = 150);
+
+		/// <summary>
+		/// Count the number of measured striped and return the water level height.
+		/// </summary>
+		/// <param name="profile">The row profile of the segmented stripe region</param>
+		/// <param name="stripeProperties">The properties of the measured striped input</param>
+		/// <returns>The amount of iterations in which a 0 or 255 were drawe</returns>
+		static double StripeCount(const std::vector<uchar> &profile, StripeProperties &stripeProperties);
+
+		/// <summary>
+		/// Count the stripes of every band and return the water level height of the median count.
+		/// </summary>
+		/// <param name="profiles">The row profiles of the bands one after the other</param>
+		/// <param name="bandCount">The amount of bands</param>
+		/// <param name="stripeProperties">The properties of the measured striped input</param>
+		/// <returns>The height of the water in meters</returns>
+		static double StripeCount(const std::vector<uchar> &profiles, int bandCount, StripeProperties &stripeProperties);
+
+		/// <summary>
+		/// Count the stripes of every band and vote on the count. The vote fails when fewer than half of the bands give a valid count,
+		/// otherwise the band with the median of the valid counts is taken
+		/// </summary>
+		/// <param name="profiles">The row profiles of the bands one after the other</param>
+		/// <param name="bandCount">The amount of bands</param>
+		/// <param name="stripePixelHeight">The expected height of the first stripe in pixels</param>
+		/// <param name="profile">Receives the row profile of the band which was taken</param>
+		/// <returns>The counted stripes of the band which was taken and where its count stopped</returns>
+		static StripeScan VoteStripes(const std::vector<uchar> &profiles, int bandCount, int stripePixelHeight, std::vector<uchar> &profile);
+
+		/// <summary>
+		/// Count the stripes in the row profile from the top down until a run differs too much from the stripe above it
+		/// </summary>
+		/// <param name="profile">The row profile of the segmented stripe region</param>
+		/// <param name="stripePixelHeight">The expected height of the first stripe in pixels</param>
+		/// <returns>The counted stripes and where the count stopped</returns>
+		static StripeScan ScanStripes(const std::vector<uchar> &profile, int stripePixelHeight);
+
+		/// <summary>
+		/// Convert an amount of stripes above the water to the water level height.
+		/// Return NULL if every stripe is above the water
+		/// </summary>
+		/// <param name="count">The amount of stripes above the water</param>
+		/// <param name="stripeProperties">The properties of the measured striped input</param>
+		/// <returns>The height of the water in meters</returns>
+		static double Level(int count, StripeProperties &stripeProperties);
 
 		/// <summary>
 		/// Crop the area underneath the marker that contains the stripes
@@ -46,37 +366,451 @@ namespace waterleveltracking {
 		/// <param name="bottomRightCornerX">The x of the bottom right corner of the marker</param>
 		/// <param name="stripePixelStart">The starting pixel of the highest stripe</param>
 		/// <param name="bottom"> The bottom pixel to crop on</param>
-		static void Crop(Mat &frame, int bottomLeftCornerX, int bottomRightCornerX, int stripePixelStart, int bottom);
+		/// <param name="wide">Whether to keep the wider area the BandVote profile mode votes over instead of the middle third</param>
+		static void Crop(Mat &frame, int bottomLeftCornerX, int bottomRightCornerX, int stripePixelStart, int bottom, bool wide = false);
 
 		/// <summary>
-		/// Perform a smoothing on the image using a Gaussian blur.
+		/// Rotates the image and calculates the new pixel coordinates of the corners
+		/// </summary>
+		/// <param name="frame">The grayscale frame of the video feed</param>
+		/// <param name="rotation">Angle in degrees of the rotation of the marker</param>
+		/// <param name="markerProperties">Properties of the measured marker</param>
+		/// <param name="rotated">The rotated frame</param>
+		/// <returns>Return the y of the last pixel that should be iterated or the bottom</returns>
+		int Rotate(const Mat &frame, double rotation, MarkerProperties &markerProperties, Mat &rotated);
+
+		/// <summary>
+		/// The amount of times a frame is halved at most
+		/// </summary>
+		static const int MaxPyramidLevel = 4;
+
+		/// <summary>
+		/// The amount of columns the column step of the options leaves of the stripe region at least
+		/// </summary>
+		static const int MinRegionColumns = 8;
+
+		/// <summary>
+		/// The amount of bands the BandVote profile mode splits the stripe region into at most
+		/// </summary>
+		static const int MaxBandCount = 32;
+
+		/// <summary>
+		/// The amount of black rows which have to follow the expected bottom row before it is kept without a full scan
+		/// </summary>
+		static const int BottomRunLength = 16;
+
+		/// <summary>
+		/// The options which select how frames are processed
+		/// </summary>
+		TrackerOptions options;
+
+		/// <summary>
+		/// The options as set by the caller, the options above are these lowered to the quality level of the governor
+		/// </summary>
+		TrackerOptions configuredOptions;
+
+		/// <summary>
+		/// Scratch buffer for the grayscale frame
+		/// </summary>
+		Mat grayBuffer;
+
+		/// <summary>
+		/// Scratch buffer for the rotated frame or the resampled stripe region
+		/// </summary>
+		Mat warpBuffer;
+
+		/// <summary>
+		/// Scratch buffer for the grayscale stripe region
+		/// </summary>
+		Mat regionBuffer;
+
+		/// <summary>
+		/// Scratch buffer for the blurred stripe region
+		/// </summary>
+		Mat blurBuffer;
+
+		/// <summary>
+		/// Scratch buffer for the row profile of the segmented stripe region
+		/// </summary>
+		std::vector<uchar> profileBuffer;
+
+		/// <summary>
+		/// Scratch buffer for the row profile of the band around the previous water line
+		/// </summary>
+		std::vector<uchar> bandBuffer;
+
+		/// <summary>
+		/// Scratch buffer for the row profiles of the bands in the BandVote profile mode
+		/// </summary>
+		std::vector<uchar> voteBuffer;
+
+		/// <summary>
+		/// Scratch buffer for the integral image of the stripe region
+		/// </summary>
+		Mat integralBuffer;
+
+		/// <summary>
+		/// Scratch buffer for the downscaled frame of the FullFrame mode
+		/// </summary>
+		Mat pyramidBuffer;
+
+		/// <summary>
+		/// Scratch buffer for the mean intensity of every row of the stripe region
+		/// </summary>
+		std::vector<float> intensityBuffer;
+
+		/// <summary>
+		/// Scratch buffer for the smoothed intensity of every row of the stripe region
+		/// </summary>
+		std::vector<float> smoothBuffer;
+
+		/// <summary>
+		/// Scratch buffer for the pixels of a single row of the stripe region
+		/// </summary>
+		std::vector<uchar> rowBuffer;
+
+		/// <summary>
+		/// Scratch buffer for the column sums of the fused segmentation kernel
+		/// </summary>
+		std::vector<ushort> columnBuffer;
+
+		/// <summary>
+		/// The amount of times a scratch buffer had to be allocated
+		/// </summary>
+		int allocationCount;
+
+		/// <summary>
+		/// The bottom row of the image found in the last processed frame
+		/// </summary>
+		int imageBottom;
+
+		/// <summary>
+		/// The bottom row of the image expected for the current frame, -1 if unknown
+		/// </summary>
+		int bottomHint;
+
+		/// <summary>
+		/// The cached geometry of the stripe region for the FixedCamera mode, one per pyramid level so a change of level does not
+		/// calculate it again
+		/// </summary>
+		RegionCalibration calibrations[MaxPyramidLevel + 1];
+
+		/// <summary>
+		/// The pyramid level of the frame which is being tracked, it selects the calibration. The OrientedRegion and FixedCamera modes
+		/// sample the stripe region at this level straight from the frame at full resolution
+		/// </summary>
+		int pyramidLevel;
+
+		/// <summary>
+		/// The amount of times the geometry of the stripe region was calculated
+		/// </summary>
+		int calibrationCount;
+
+		/// <summary>
+		/// Skips the frames whose stripe region did not change when the motion threshold is set
+		/// </summary>
+		MotionGate motionGate;
+
+		/// <summary>
+		/// Lowers the quality of the options while processing a frame costs more than the latency budget
+		/// </summary>
+		LatencyGovernor governor;
+
+		/// <summary>
+		/// The recorder every processed frame is appended to, NULL if the frames are not recorded
+		/// </summary>
+		FrameRecorder *recorder;
+
+		/// <summary>
+		/// The stripe region of the last processed frame, only kept while recording
+		/// </summary>
+		Mat recordedRegion;
+
+		/// <summary>
+		/// The height of a stripe in pixels in the stripe region of the last processed frame, only kept while recording
+		/// </summary>
+		int recordedStripePixelHeight;
+
+		/// <summary>
+		/// The result of the last processed frame
+		/// </summary>
+		WltTrackingResult result;
+
+		/// <summary>
+		/// Gets a view of the given size on a scratch buffer, which is only allocated when it is too small.
+		/// The view is a continuous header without a parent, so filters never read the stale pixels of an earlier, larger frame around it.
+		/// </summary>
+		/// <param name="buffer">The scratch buffer</param>
+		/// <param name="size">The size of the view</param>
+		/// <param name="type">The type of the pixels</param>
+		/// <returns>The view on the scratch buffer</returns>
+		Mat Scratch(Mat &buffer, Size size, int type);
+
+		/// <summary>
+		/// Make sure a scratch vector can hold the given amount of elements, only allocating when it is too small
+		/// </summary>
+		/// <param name="buffer">The scratch vector</param>
+		/// <param name="size">The amount of elements it should hold</param>
+		template<typename T>
+		void Scratch(std::vector<T> &buffer, size_t size) {
+			if (buffer.capacity() < size) {
+				buffer.reserve(size);
+				this->allocationCount++;
+			}
+		}
+
+		/// <summary>
+		/// Resample the oriented stripe region underneath the marker straight from the unrotated frame.
+		/// The region is converted to grayscale and ends at the bottom of the image.
 		/// </summary>
 		/// <param name="frame">The captured frame of the video feed</param>
-		static void Segment(Mat &frame);
+		/// <param name="rotation">Angle in degrees of the rotation of the marker</param>
+		/// <param name="markerProperties">Properties of the measured marker</param>
+		/// <param name="stripeProperties">Properties of the striped underneath the measured marker</param>
+		/// <param name="region">The grayscale stripe region</param>
+		/// <returns>False if the stripe region lies outside the frame</returns>
+		bool ExtractOrientedRegion(const Mat &frame, double rotation, MarkerProperties &markerProperties, StripeProperties &stripeProperties, Mat &region);
 
 		/// <summary>
-		/// Rotates the image and calculates the new pixel coordinates of the corners
+		/// Resample the oriented stripe region underneath the marker with the cached calibration, calculating it first if it does not fit the frame.
+		/// The geometry of the marker and the stripes is taken from the calibration.
 		/// </summary>
 		/// <param name="frame">The captured frame of the video feed</param>
 		/// <param name="rotation">Angle in degrees of the rotation of the marker</param>
 		/// <param name="markerProperties">Properties of the measured marker</param>
-		/// <returns>Return the y of the last pixel that should be iterated or the bottom</returns>
-		static int Rotate(Mat &frame, double rotation, MarkerProperties &markerProperties);
+		/// <param name="stripeProperties">Properties of the striped underneath the measured marker</param>
+		/// <param name="region">The grayscale stripe region</param>
+		/// <returns>False if the stripe region lies outside the frame</returns>
+		bool ExtractCalibratedRegion(const Mat &frame, double rotation, MarkerProperties &markerProperties, StripeProperties &stripeProperties, Mat &region);
 
 		/// <summary>
-		/// Calculate the new pixel coordinates of the marker corners
+		/// Check whether the cached calibration fits the frame size, the rotation and the position of the marker
 		/// </summary>
-		/// <param name="markerProperties">The input marker properties</param>
-		/// <param name="rotationMatrix">The rotation matrix used for the entire image</param>
-		static void MapRotation(MarkerProperties &markerProperties, Mat &rotationMatrix);
+		/// <param name="frameSize">The size of the frame</param>
+		/// <param name="rotation">The quantized angle in degrees of the rotation of the marker</param>
+		/// <param name="markerProperties">Properties of the measured marker</param>
+		/// <returns>True if the calibration can be used</returns>
+		bool IsCalibrated(Size frameSize, double rotation, MarkerProperties &markerProperties);
 
 		/// <summary>
-		/// Count the number of measured striped and return the water level height.
+		/// Calculate the geometry of the stripe region and the table which resamples it from the unrotated frame
+		/// </summary>
+		/// <param name="frameSize">The size of the frame</param>
+		/// <param name="rotation">The quantized angle in degrees of the rotation of the marker</param>
+		/// <param name="markerProperties">Properties of the measured marker</param>
+		void Calibrate(Size frameSize, double rotation, MarkerProperties &markerProperties);
+
+		/// <summary>
+		/// Reduce the stripe region to a row profile in the way selected by the profile mode of the options and count its stripes.
+		/// The row profile which was counted is left in the profile buffer
+		/// </summary>
+		/// <param name="region">The grayscale stripe region</param>
+		/// <param name="stripePixelHeight">The expected height of the first stripe in pixels</param>
+		/// <returns>The counted stripes and where the count stopped</returns>
+		StripeScan ScanRegion(const Mat &region, int stripePixelHeight);
+
+		/// <summary>
+		/// Gets the columns of the stripe region underneath the marker
+		/// </summary>
+		/// <param name="bottomLeftCornerX">The x of the bottom left corner of the marker</param>
+		/// <param name="bottomRightCornerX">The x of the bottom right corner of the marker</param>
+		/// <param name="wide">Whether to take the middle two thirds the BandVote profile mode votes over instead of the middle third</param>
+		/// <param name="left">Receives the first column of the region</param>
+		/// <param name="right">Receives the column after the last column of the region</param>
+		static void StripeColumns(int bottomLeftCornerX, int bottomRightCornerX, bool wide, int &left, int &right);
+
+		/// <summary>
+		/// Record the outcome of a stripe count in the result of the frame and convert it to the water level height
+		/// </summary>
+		/// <param name="region">The grayscale stripe region the stripes were counted in</param>
+		/// <param name="scan">The counted stripes</param>
+		/// <param name="stripeProperties">The properties of the measured striped input</param>
+		/// <returns>The height of the water in meters, NULL if the count gave no water level</returns>
+		double Conclude(const Mat &region, const StripeScan &scan, StripeProperties &stripeProperties);
+
+		/// <summary>
+		/// Move the water level from the bottom of the partially submerged stripe to the water line inside it
+		/// </summary>
+		/// <param name="region">The grayscale stripe region the stripes were counted in</param>
+		/// <param name="scan">The counted stripes, which reached the water</param>
+		/// <param name="stripeProperties">The properties of the measured striped input</param>
+		/// <param name="level">The water level of the stripe count</param>
+		/// <returns>The refined height of the water in meters, the given level if the water line cannot be found</returns>
+		double RefineLevel(const Mat &region, const StripeScan &scan, StripeProperties &stripeProperties, double level);
+
+		/// <summary>
+		/// Hand the result of the last processed frame to a frame which is skipped
+		/// </summary>
+		/// <returns>The water level of the last processed frame</returns>
+		double Hold();
+
+		/// <summary>
+		/// Record in the result of the frame that it gave no water level before the stripes were counted
+		/// </summary>
+		/// <param name="status">Why the frame gave no water level, a WltStatus</param>
+		/// <returns>NULL, as the water level of the frame</returns>
+		double Reject(int status);
+
+		/// <summary>
+		/// Classify the outcome of a stripe count for the instrumentation
+		/// </summary>
+		/// <param name="scan">The counted stripes</param>
+		/// <param name="stripeProperties">The properties of the measured striped input</param>
+		/// <returns>The reason the count gave no water level, or None if it gave one</returns>
+		static Rejection Outcome(const StripeScan &scan, StripeProperties &stripeProperties);
+
+		/// <summary>
+		/// Reject hopeless frames from their corners and predict the height of the water level of the others with <see cref="TrackPyramid"/>.
+		/// When the motion threshold is set and the stripe region did not change, the level of the last processed frame is returned instead.
+		/// When the latency budget is set, the cost of the frame steers the quality of the following frames.
+		/// Every frame is handed to the recorder with the status it ended with, rejected and held frames included.
+		/// </summary>
+		/// <param name="frame">The captured frame of the video feed</param>
+		/// <param name="markerProperties">Properties of the measured marker</param>
+		/// <param name="stripeProperties">Properties of the striped underneath the measured marker</param>
+		/// <param name="rotation">Angle in degrees of the rotation of the marker</param>
+		/// <param name="state">The tracking state of the marker, NULL to track the frame on its own</param>
+		/// <returns>The height of the water in meters</returns>
+		double TrackScaled(const Mat &frame, MarkerProperties &markerProperties, StripeProperties &stripeProperties, double rotation, TrackingState *state);
+
+		/// <summary>
+		/// Predict the height of the water level at the coarsest pyramid level which keeps the stripes tall enough.
+		/// The OrientedRegion and FixedCamera modes fold the downscale into the resampling of the stripe region, so a coarser level only
+		/// samples fewer pixels. The geometry written to the properties is scaled back to the resolution of the frame
+		/// </summary>
+		/// <param name="frame">The captured frame of the video feed</param>
+		/// <param name="markerProperties">Properties of the measured marker</param>
+		/// <param name="stripeProperties">Properties of the striped underneath the measured marker</param>
+		/// <param name="rotation">Angle in degrees of the rotation of the marker</param>
+		/// <param name="state">The tracking state of the marker, NULL to track the frame on its own</param>
+		/// <returns>The height of the water in meters</returns>
+		double TrackPyramid(const Mat &frame, MarkerProperties &markerProperties, StripeProperties &stripeProperties, double rotation, TrackingState *state);
+
+		/// <summary>
+		/// Calculate the bounds of the stripe region in the unrotated frame, without touching the pixels
+		/// </summary>
+		/// <param name="frameSize">The size of the frame</param>
+		/// <param name="rotation">Angle in degrees of the rotation of the frame</param>
+		/// <param name="markerProperties">A copy of the properties of the measured marker</param>
+		/// <param name="wide">Whether the stripe region is the wider one of the BandVote profile mode</param>
+		/// <returns>The bounds of the stripe region, empty if it lies outside the frame</returns>
+		static Rect StripeBounds(Size frameSize, double rotation, MarkerProperties markerProperties, bool wide);
+
+		/// <summary>
+		/// Predict the height of the water level at the resolution of the given frame.
+		/// Return NULL if the the water level cannot be derived from the information
+		/// </summary>
+		/// <param name="frame">The captured frame of the video feed, possibly downscaled</param>
+		/// <param name="markerProperties">Properties of the measured marker at the resolution of the frame</param>
+		/// <param name="stripeProperties">Properties of the striped underneath the measured marker at the resolution of the frame</param>
+		/// <param name="rotation">Angle in degrees of the rotation of the marker</param>
+		/// <returns>The height of the water in meters</returns>
+		double TrackFrame(const Mat &frame, MarkerProperties &markerProperties, StripeProperties &stripeProperties, double rotation);
+
+		/// <summary>
+		/// Predict the height of the water level at the resolution of the given frame, checking the rows around the water line of the previous frame first.
+		/// Return NULL if the the water level cannot be derived from the information
+		/// </summary>
+		/// <param name="frame">The captured frame of the video feed, possibly downscaled</param>
+		/// <param name="markerProperties">Properties of the measured marker at the resolution of the frame</param>
+		/// <param name="stripeProperties">Properties of the striped underneath the measured marker at the resolution of the frame</param>
+		/// <param name="rotation">Angle in degrees of the rotation of the marker</param>
+		/// <param name="state">The tracking state of the marker, updated with this frame</param>
+		/// <returns>The filtered height of the water in meters</returns>
+		double TrackFrame(const Mat &frame, MarkerProperties &markerProperties, StripeProperties &stripeProperties, double rotation, TrackingState &state);
+
+		/// <summary>
+		/// Keep the stripe region of the frame for the recorder, it is only a view on the scratch buffers
+		/// </summary>
+		/// <param name="region">The grayscale stripe region</param>
+		/// <param name="stripeProperties">Properties of the striped underneath the measured marker at the resolution of the region</param>
+		void KeepRegion(const Mat &region, StripeProperties &stripeProperties);
+
+		/// <summary>
+		/// Gets the amount of times the frame can be halved while the stripes stay at least the minimum height of the options
+		/// </summary>
+		/// <param name="stripeProperties">Properties of the striped underneath the measured marker</param>
+		/// <returns>The pyramid level, 0 for full resolution</returns>
+		int PyramidLevel(StripeProperties &stripeProperties);
+
+		/// <summary>
+		/// Downscale the frame by a power of two, averaging the pixels of every block
 		/// </summary>
 		/// <param name="frame">The captured frame of the video feed</param>
+		/// <param name="level">The pyramid level, the frame is halved this many times</param>
+		/// <returns>The downscaled frame</returns>
+		Mat Downscale(const Mat &frame, int level);
+
+		/// <summary>
+		/// Gets the size of a frame at a pyramid level
+		/// </summary>
+		/// <param name="frameSize">The size of the frame at full resolution</param>
+		/// <param name="level">The pyramid level</param>
+		/// <returns>The size of the downscaled frame</returns>
+		static Size PyramidSize(Size frameSize, int level);
+
+		/// <summary>
+		/// Gets the step between the sampled columns of a stripe region, the column step of the options as far as the width allows
+		/// </summary>
+		/// <param name="width">The width in pixels of the stripe region</param>
+		/// <returns>The column step</returns>
+		int RegionColumnStep(int width);
+
+		/// <summary>
+		/// Scale the pixel geometry of the marker and the stripes
+		/// </summary>
+		/// <param name="markerProperties">Properties of the measured marker</param>
+		/// <param name="stripeProperties">Properties of the striped underneath the measured marker</param>
+		/// <param name="factor">The scale factor</param>
+		static void ScaleGeometry(MarkerProperties &markerProperties, StripeProperties &stripeProperties, double factor);
+
+		/// <summary>
+		/// Segment only the rows around the water line of the previous frame and count the stripes with the rows above taken from that frame.
+		/// The BandVote profile mode always votes over the whole region
+		/// </summary>
+		/// <param name="region">The grayscale stripe region</param>
 		/// <param name="stripeProperties">The properties of the measured striped input</param>
-		/// <returns>The amount of iterations in which a 0 or 255 were drawe</returns>
-		static double WaterLevelTracker::StripeCount(Mat &frame, StripeProperties &stripeProperties);
+		/// <param name="state">The tracking state of the marker</param>
+		/// <param name="level">The height of the water in meters if the water line was found around the previous one</param>
+		/// <returns>False if the water line was not found around the previous one</returns>
+		bool TrackBand(const Mat &region, StripeProperties &stripeProperties, TrackingState &state, double &level);
+
+		/// <summary>
+		/// Find the last row of the image which is not black in the given column.
+		/// The expected row is kept if a run of black rows follows it and the last row is black, so a dark pixel or a noisy row right
+		/// below it does not cut the region short. Otherwise the whole column is scanned
+		/// </summary>
+		/// <param name="image">The grayscale image</param>
+		/// <param name="column">The column to search</param>
+		/// <param name="hint">The expected row, -1 if unknown</param>
+		/// <returns>The last row which is not black, or the amount of rows if every row is black</returns>
+		static int FindBottom(const Mat &image, int column, int hint);
+
+		/// <summary>
+		/// Build the matrix which rotates a frame around its center
+		/// </summary>
+		/// <param name="frameSize">The size of the frame</param>
+		/// <param name="rotation">Angle in degrees of the rotation</param>
+		/// <returns>The 2x3 affine rotation matrix</returns>
+		static Matx23d RotationMatrix(Size frameSize, double rotation);
+
+		/// <summary>
+		/// Build the matrix which samples the stripe region straight from the frame at full resolution: the pixels of the frame are
+		/// mapped onto the pyramid level, the region matrix maps them into the region and every column step columns of the region
+		/// are merged into one. Every sample lies at the middle of the pixels it stands for
+		/// </summary>
+		/// <param name="regionMatrix">The matrix which maps the frame at the pyramid level onto the stripe region</param>
+		/// <param name="level">The pyramid level</param>
+		/// <param name="columnStep">The step between the sampled columns of the stripe region</param>
+		/// <returns>The 2x3 affine matrix which maps the frame at full resolution onto the sampled stripe region</returns>
+		static Matx23d SampleMatrix(const Matx23d &regionMatrix, int level, int columnStep);
+
+		/// <summary>
+		/// Calculate the new pixel coordinates of the marker corners
+		/// </summary>
+		/// <param name="markerProperties">The input marker properties</param>
+		/// <param name="rotationMatrix">The rotation matrix used for the entire image</param>
+		static void MapRotation(MarkerProperties &markerProperties, const Matx23d &rotationMatrix);
 	};
 }
 
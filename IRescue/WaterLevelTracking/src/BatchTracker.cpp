@@ -0,0 +1,89 @@
+// <copyright file="BatchTracker.cpp" company="Delft University of Technology">
+// Copyright (c) Delft University of Technology. All rights reserved.
+// </copyright>
+
+#include "../include/BatchTracker.h"
+
+namespace waterleveltracking {
+	/// <summary>
+	/// Processes a range of the markers of a batch on one thread of the pool.
+	/// </summary>
+	class BatchBody : public ParallelLoopBody
+	{
+	public:
+		/// <summary>
+		/// Initializes a new instance of the <see cref="BatchBody"/> class.
+		/// </summary>
+		/// <param name="gray">The shared grayscale frame</param>
+		/// <param name="trackers">One tracker per marker</param>
+		/// <param name="markerProperties">Properties of the measured markers</param>
+		/// <param name="stripeProperties">Properties of the stripes underneath each of the markers</param>
+		/// <param name="rotations">Angle in degrees of the rotation of each of the markers</param>
+		/// <param name="levels">The height of the water in meters at each of the markers</param>
+		BatchBody(const Mat &gray, std::vector<WaterLevelTracker> &trackers, std::vector<MarkerProperties> &markerProperties, std::vector<StripeProperties> &stripeProperties, const std::vector<double> &rotations, std::vector<double> &levels)
+			: gray(gray), trackers(trackers), markerProperties(markerProperties), stripeProperties(stripeProperties), rotations(rotations), levels(levels) {
+		}
+
+		/// <summary>
+		/// Calculate the water level at the markers in the range
+		/// </summary>
+		/// <param name="range">The indices of the markers to process</param>
+		void operator()(const Range &range) const {
+			for (int i = range.start; i < range.end; i++) {
+				this->levels[i] = this->trackers[i].Track(this->gray, this->markerProperties[i], this->stripeProperties[i], this->rotations[i]);
+			}
+		}
+
+	private:
+		const Mat &gray;
+		std::vector<WaterLevelTracker> &trackers;
+		std::vector<MarkerProperties> &markerProperties;
+		std::vector<StripeProperties> &stripeProperties;
+		const std::vector<double> &rotations;
+		std::vector<double> &levels;
+	};
+
+	/// <summary>
+	/// Initializes a new instance of the <see cref="BatchTracker"/> class.
+	/// The stripe regions are always resampled from the shared grayscale frame, so the FullFrame region mode is replaced by OrientedRegion.
+	/// </summary>
+	/// <param name="options">The options which select how the stripe regions are processed</param>
+	BatchTracker::BatchTracker(TrackerOptions options) {
+		this->options = options;
+		if (this->options.regionMode == RegionMode::FullFrame) {
+			this->options.regionMode = RegionMode::OrientedRegion;
+		}
+	}
+
+	/// <summary>
+	/// Predict the height of the water level at every marker in the frame.
+	/// A level is NULL if it cannot be derived from the information, all levels are -1 if the input lists differ in size.
+	/// </summary>
+	/// <param name="frame">The captured frame of the video feed, which is not modified</param>
+	/// <param name="markerProperties">Properties of the measured markers</param>
+	/// <param name="stripeProperties">Properties of the stripes underneath each of the markers</param>
+	/// <param name="rotations">Angle in degrees of the rotation of each of the markers</param>
+	/// <param name="levels">The height of the water in meters at each of the markers</param>
+	void BatchTracker::CalculateWaterLevels(const Mat &frame, std::vector<MarkerProperties> &markerProperties, std::vector<StripeProperties> &stripeProperties, const std::vector<double> &rotations, std::vector<double> &levels) {
+		size_t markerCount = markerProperties.size();
+		if (stripeProperties.size() != markerCount || rotations.size() != markerCount) {
+			levels.assign(markerCount, -1);
+			return;
+		}
+
+		levels.resize(markerCount);
+		while (this->trackers.size() < markerCount) {
+			this->trackers.push_back(WaterLevelTracker(this->options));
+		}
+
+		Mat gray = frame;
+		if (frame.channels() != 1) {
+			WLT_TIME_STAGE(Gray);
+			this->grayBuffer.create(frame.size(), CV_8UC1);
+			cvtColor(frame, this->grayBuffer, WaterLevelTracker::GrayConversion(this->options));
+			gray = this->grayBuffer;
+		}
+
+		parallel_for_(Range(0, (int)markerCount), BatchBody(gray, this->trackers, markerProperties, stripeProperties, rotations, levels));
+	}
+}
\ No newline at end of file
@@ -0,0 +1,141 @@
+// <copyright file="FrameRecorder.cpp" company="Delft University of Technology">
+// Copyright (c) Delft University of Technology. All rights reserved.
+// </copyright>
+
+#include "../include/FrameRecorder.h"
+
+namespace waterleveltracking {
+	/// <summary>
+	/// Initializes a new instance of the <see cref="FrameRecorder"/> class and creates the recording.
+	/// </summary>
+	/// <param name="path">The path of the recording, an existing file is overwritten</param>
+	/// <param name="content">Whether the stripe region or the whole frame is recorded</param>
+	FrameRecorder::FrameRecorder(const std::string &path, RecordContent content)
+		: file(path.c_str(), std::ios::binary | std::ios::trunc), content(content), offset(0) {
+		RecordingFormat::FileHeader header = RecordingFormat::FileHeader();
+		header.magic = RecordingFormat::FileMagic;
+		header.version = RecordingFormat::Version;
+		header.content = (uint32_t)content;
+		this->Write(&header, sizeof(header));
+	}
+
+	/// <summary>
+	/// Closes the recording.
+	/// </summary>
+	FrameRecorder::~FrameRecorder() {
+		this->Close();
+	}
+
+	/// <summary>
+	/// Append a frame to the recording
+	/// </summary>
+	/// <param name="image">The stripe region or the whole frame, empty if no stripe region was extracted</param>
+	/// <param name="corners">The marker corners in the frame as they were handed to the tracker</param>
+	/// <param name="markerProperties">Properties of the measured marker</param>
+	/// <param name="stripeProperties">Properties of the striped underneath the measured marker</param>
+	/// <param name="stripePixelHeight">The height of a stripe in pixels in the image</param>
+	/// <param name="rotation">Angle in degrees of the rotation of the marker</param>
+	/// <param name="level">The water level the tracker calculated</param>
+	/// <param name="status">The WltStatus the frame ended with</param>
+	/// <returns>False if the recording could not be written</returns>
+	bool FrameRecorder::Record(const Mat &image, const Square &corners, MarkerProperties &markerProperties, StripeProperties &stripeProperties, int stripePixelHeight, double rotation, double level, int status) {
+		if (!this->IsOpen()) {
+			return false;
+		}
+
+		// The rows are stored without the padding of the image, so a region view on a larger buffer takes no more room than it needs
+		uint64_t rowSize = (uint64_t)image.cols * image.elemSize();
+		uint64_t headerSize = RecordingFormat::Align(sizeof(RecordingFormat::RecordHeader));
+		RecordingFormat::RecordHeader header = RecordingFormat::RecordHeader();
+		header.magic = RecordingFormat::RecordMagic;
+		header.type = image.type();
+		header.size = headerSize + RecordingFormat::Align(rowSize * image.rows);
+		header.sequence = (int64_t)this->index.size();
+		header.width = image.cols;
+		header.height = image.rows;
+		header.step = (int64_t)rowSize;
+		int cornerValues[8] = { corners.bottomLeft.x, corners.bottomLeft.y, corners.bottomRight.x, corners.bottomRight.y, corners.topRight.x, corners.topRight.y, corners.topLeft.x, corners.topLeft.y };
+		for (int i = 0; i < 8; i++) {
+			header.corners[i] = cornerValues[i];
+		}
+
+		header.markerSize = markerProperties.GetMarkerSize();
+		header.distanceToStripes = markerProperties.GetDistanceToStripes();
+		header.markerHeight = markerProperties.GetMarkerHeight();
+		header.stripeHeight = stripeProperties.GetStripeHeight();
+		header.stripeCount = stripeProperties.GetStripeCount();
+		header.stripePixelHeight = stripePixelHeight;
+		header.rotation = rotation;
+		header.level = level;
+		header.status = status;
+
+		this->index.push_back(this->offset);
+		this->Write(&header, sizeof(header));
+		this->Pad();
+		for (int row = 0; row < image.rows; row++) {
+			this->Write(image.ptr(row), rowSize);
+		}
+
+		this->Pad();
+		return this->IsOpen();
+	}
+
+	/// <summary>
+	/// Write the index and close the recording, frames recorded afterwards are ignored
+	/// </summary>
+	void FrameRecorder::Close() {
+		if (!this->IsOpen()) {
+			return;
+		}
+
+		RecordingFormat::Footer footer;
+		footer.indexOffset = this->offset;
+		footer.count = (uint32_t)this->index.size();
+		footer.magic = RecordingFormat::FooterMagic;
+		if (!this->index.empty()) {
+			this->Write(&this->index[0], this->index.size() * sizeof(uint64_t));
+		}
+
+		this->Write(&footer, sizeof(footer));
+		this->file.close();
+	}
+
+	/// <summary>
+	/// Gets whether the recording is open for writing
+	/// </summary>
+	bool FrameRecorder::IsOpen() {
+		return this->file.is_open() && this->file.good();
+	}
+
+	/// <summary>
+	/// Gets what is recorded of every frame
+	/// </summary>
+	RecordContent FrameRecorder::GetContent() {
+		return this->content;
+	}
+
+	/// <summary>
+	/// Gets the amount of recorded frames
+	/// </summary>
+	long long FrameRecorder::GetCount() {
+		return (long long)this->index.size();
+	}
+
+	/// <summary>
+	/// Append bytes to the recording
+	/// </summary>
+	/// <param name="data">The bytes</param>
+	/// <param name="size">The amount of bytes</param>
+	void FrameRecorder::Write(const void *data, uint64_t size) {
+		this->file.write((const char*)data, (std::streamsize)size);
+		this->offset += size;
+	}
+
+	/// <summary>
+	/// Append zeros up to the alignment of the records
+	/// </summary>
+	void FrameRecorder::Pad() {
+		static const char zeros[RecordingFormat::Alignment] = {};
+		this->Write(zeros, RecordingFormat::Align(this->offset) - this->offset);
+	}
+}
\ No newline at end of file
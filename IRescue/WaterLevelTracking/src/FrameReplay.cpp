@@ -0,0 +1,177 @@
+// <copyright file="FrameReplay.cpp" company="Delft University of Technology">
+// Copyright (c) Delft University of Technology. All rights reserved.
+// </copyright>
+
+#include <cstring>
+#include "../include/FrameReplay.h"
+
+namespace waterleveltracking {
+	/// <summary>
+	/// Initializes a new instance of the <see cref="FrameReplay"/> class.
+	/// </summary>
+	FrameReplay::FrameReplay() : data(nullptr), size(0), content(RecordContent::Region) {
+	}
+
+	/// <summary>
+	/// Unmaps the recording.
+	/// </summary>
+	FrameReplay::~FrameReplay() {
+		this->Close();
+	}
+
+	/// <summary>
+	/// Map a recording, the index is read from the footer or rebuilt by walking the records if the recording was not closed
+	/// </summary>
+	/// <param name="path">The path of the recording</param>
+	/// <returns>False if the file cannot be mapped or is not a recording</returns>
+	bool FrameReplay::Open(const std::string &path) {
+		this->Close();
+		if (!this->file.Open(path)) {
+			return false;
+		}
+
+		this->data = this->file.GetData();
+		this->size = this->file.GetSize();
+
+		const RecordingFormat::FileHeader *header = (const RecordingFormat::FileHeader*)this->data;
+		if (this->size < sizeof(RecordingFormat::FileHeader) || header->magic != RecordingFormat::FileMagic || header->version != RecordingFormat::Version || !this->ReadIndex()) {
+			this->Close();
+			return false;
+		}
+
+		this->content = (RecordContent)header->content;
+		return true;
+	}
+
+	/// <summary>
+	/// Unmap the recording, the images of the frames become invalid
+	/// </summary>
+	void FrameReplay::Close() {
+		this->file.Close();
+		this->data = nullptr;
+		this->size = 0;
+		this->offsets.clear();
+	}
+
+	/// <summary>
+	/// Gets a recorded frame
+	/// </summary>
+	/// <param name="index">The index of the frame</param>
+	/// <param name="frame">The frame</param>
+	/// <returns>False if the index is out of range</returns>
+	bool FrameReplay::GetFrame(int index, ReplayFrame &frame) {
+		if (index < 0 || index >= (int)this->offsets.size()) {
+			return false;
+		}
+
+		const uint8_t *record = this->data + this->offsets[index];
+		const RecordingFormat::RecordHeader &header = *(const RecordingFormat::RecordHeader*)record;
+		const uint8_t *pixels = record + RecordingFormat::Align(sizeof(RecordingFormat::RecordHeader));
+
+		// The mapping is read only, the tracker never writes to the frames it is handed
+		frame.image = header.width == 0 || header.height == 0 ? Mat() : Mat(header.height, header.width, header.type, (void*)pixels, (size_t)header.step);
+		frame.sequence = header.sequence;
+		for (int i = 0; i < 8; i++) {
+			frame.corners[i] = header.corners[i];
+		}
+
+		frame.markerSize = header.markerSize;
+		frame.distanceToStripes = header.distanceToStripes;
+		frame.markerHeight = header.markerHeight;
+		frame.stripeHeight = header.stripeHeight;
+		frame.stripeCount = header.stripeCount;
+		frame.stripePixelHeight = header.stripePixelHeight;
+		frame.rotation = header.rotation;
+		frame.level = header.level;
+		frame.status = header.status;
+		return true;
+	}
+
+	/// <summary>
+	/// Feed a recorded frame through the tracker, a stripe region skips the straightening
+	/// A rejected or held frame recorded without a stripe region is rejected again, a recorded whole frame is tracked as it was
+	/// </summary>
+	/// <param name="index">The index of the frame</param>
+	/// <param name="tracker">The tracker</param>
+	/// <returns>The height of the water in meters, -1 if the index is out of range</returns>
+	double FrameReplay::Replay(int index, WaterLevelTracker &tracker) {
+		ReplayFrame frame;
+		if (!this->GetFrame(index, frame)) {
+			return -1;
+		}
+
+		MarkerProperties markerProperties(frame.corners, frame.markerSize, frame.distanceToStripes, frame.markerHeight);
+		StripeProperties stripeProperties(markerProperties, frame.stripeHeight, frame.stripeCount);
+		if (this->content == RecordContent::Frame) {
+			return tracker.Track(frame.image, markerProperties, stripeProperties, frame.rotation);
+		}
+
+		stripeProperties.SetStripePixelHeight(frame.stripePixelHeight);
+		return tracker.TrackRegion(frame.image, stripeProperties);
+	}
+
+	/// <summary>
+	/// Gets the amount of recorded frames
+	/// </summary>
+	int FrameReplay::GetCount() {
+		return (int)this->offsets.size();
+	}
+
+	/// <summary>
+	/// Gets what was recorded of every frame
+	/// </summary>
+	RecordContent FrameReplay::GetContent() {
+		return this->content;
+	}
+
+	/// <summary>
+	/// Read the index from the footer, or rebuild it by walking the records
+	/// </summary>
+	/// <returns>False if the index in the footer points at damaged records</returns>
+	bool FrameReplay::ReadIndex() {
+		uint64_t first = sizeof(RecordingFormat::FileHeader);
+		if (this->size >= first + sizeof(RecordingFormat::Footer)) {
+			RecordingFormat::Footer footer;
+			memcpy(&footer, this->data + this->size - sizeof(footer), sizeof(footer));
+			uint64_t indexSize = (uint64_t)footer.count * sizeof(uint64_t);
+			if (footer.magic == RecordingFormat::FooterMagic && footer.indexOffset >= first && footer.indexOffset + indexSize + sizeof(footer) == this->size) {
+				this->offsets.resize(footer.count);
+				if (footer.count > 0) {
+					memcpy(&this->offsets[0], this->data + footer.indexOffset, indexSize);
+				}
+
+				for (size_t i = 0; i < this->offsets.size(); i++) {
+					if (!this->IsRecord(this->offsets[i])) {
+						this->offsets.clear();
+						return false;
+					}
+				}
+
+				return true;
+			}
+		}
+
+		// The recording was not closed, every complete record up to the first damaged one is kept
+		for (uint64_t offset = first; this->IsRecord(offset); offset += ((const RecordingFormat::RecordHeader*)(this->data + offset))->size) {
+			this->offsets.push_back(offset);
+		}
+
+		return true;
+	}
+
+	/// <summary>
+	/// Check whether a complete record starts at an offset
+	/// </summary>
+	/// <param name="offset">The offset in bytes</param>
+	/// <returns>True if the record is complete</returns>
+	bool FrameReplay::IsRecord(uint64_t offset) {
+		uint64_t headerSize = RecordingFormat::Align(sizeof(RecordingFormat::RecordHeader));
+		if (offset % RecordingFormat::Alignment != 0 || offset + headerSize > this->size) {
+			return false;
+		}
+
+		const RecordingFormat::RecordHeader &header = *(const RecordingFormat::RecordHeader*)(this->data + offset);
+		return header.magic == RecordingFormat::RecordMagic && header.width >= 0 && header.height >= 0 && header.step >= (int64_t)header.width * CV_ELEM_SIZE(header.type)
+			&& header.size >= headerSize + (uint64_t)header.step * header.height && header.size <= this->size - offset;
+	}
+}
\ No newline at end of file
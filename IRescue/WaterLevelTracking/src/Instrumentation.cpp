@@ -0,0 +1,536 @@
+// <copyright file="Instrumentation.cpp" company="Delft University of Technology">
+// Copyright (c) Delft University of Technology. All rights reserved.
+// </copyright>
+
+#include <algorithm>
+#include <chrono>
+#include <fstream>
+#include <iomanip>
+#include "../include/Instrumentation.h"
+
+namespace waterleveltracking {
+	/// <summary>
+	/// A histogram which only its own thread writes
+	/// </summary>
+	struct Histogram {
+		/// <summary>
+		/// The amount of values per bucket
+		/// </summary>
+		std::atomic<uint64_t> buckets[Instrumentation::BucketCount];
+
+		/// <summary>
+		/// The amount of values
+		/// </summary>
+		std::atomic<uint64_t> count;
+
+		/// <summary>
+		/// The sum of the values
+		/// </summary>
+		std::atomic<uint64_t> total;
+	};
+
+	/// <summary>
+	/// A timed stage kept for the trace
+	/// </summary>
+	struct TraceEvent {
+		/// <summary>
+		/// The start of the stage in nanoseconds
+		/// </summary>
+		std::atomic<uint64_t> start;
+
+		/// <summary>
+		/// The duration of the stage in nanoseconds
+		/// </summary>
+		std::atomic<uint64_t> duration;
+
+		/// <summary>
+		/// The index of the stage
+		/// </summary>
+		std::atomic<int> stage;
+	};
+
+	/// <summary>
+	/// The histograms and trace events of one thread. Records are never freed, so the counts of finished threads stay in the sums.
+	/// The record of a finished thread is taken over by the next thread which starts recording, so the amount of records is bounded by
+	/// the highest amount of threads which recorded at the same time, however many threads the pools start and stop.
+	/// </summary>
+	struct ThreadRecord {
+		/// <summary>
+		/// The duration histogram of every stage
+		/// </summary>
+		Histogram stages[(int)Stage::Count];
+
+		/// <summary>
+		/// The histogram of the region sizes in pixels
+		/// </summary>
+		Histogram regions;
+
+		/// <summary>
+		/// The histogram of the counted stripes
+		/// </summary>
+		Histogram stripes;
+
+		/// <summary>
+		/// The amount of frames per outcome
+		/// </summary>
+		std::atomic<uint64_t> rejections[(int)Rejection::Count];
+
+		/// <summary>
+		/// The summed duration of every stage since the thread last took them, only read by the thread itself
+		/// </summary>
+		uint64_t frameDurations[(int)Stage::Count];
+
+		/// <summary>
+		/// The ring of trace events, allocated when the first event is kept
+		/// </summary>
+		std::atomic<TraceEvent*> trace;
+
+		/// <summary>
+		/// The amount of trace events kept so far
+		/// </summary>
+		std::atomic<uint64_t> traceCount;
+
+		/// <summary>
+		/// The number of the thread in the trace, shared by the threads which took over the record
+		/// </summary>
+		int threadId;
+
+		/// <summary>
+		/// Whether a running thread owns the record
+		/// </summary>
+		std::atomic<bool> owned;
+
+		/// <summary>
+		/// The record of the thread which registered before this one
+		/// </summary>
+		ThreadRecord *next;
+	};
+
+	/// <summary>
+	/// The names of the stages in the trace
+	/// </summary>
+	static const char *StageNames[] = { "Gray", "Warp", "BottomScan", "Blur", "Segment", "StripeCount", "Frame" };
+
+	/// <summary>
+	/// The most recently registered thread record
+	/// </summary>
+	static std::atomic<ThreadRecord*> threadRecords(nullptr);
+
+	/// <summary>
+	/// The amount of registered thread records
+	/// </summary>
+	static std::atomic<int> threadRecordCount(0);
+
+	std::atomic<bool> Instrumentation::traceEnabled(false);
+
+	/// <summary>
+	/// Take over the record of a finished thread, or register a new record if every record is owned
+	/// </summary>
+	/// <returns>The record, owned by the calling thread</returns>
+	static ThreadRecord *AcquireRecord() {
+		for (ThreadRecord *record = threadRecords.load(); record != nullptr; record = record->next) {
+			bool owned = false;
+			if (!record->owned.load(std::memory_order_relaxed) && record->owned.compare_exchange_strong(owned, true, std::memory_order_acquire)) {
+				std::fill(record->frameDurations, record->frameDurations + (int)Stage::Count, 0);
+				return record;
+			}
+		}
+
+		ThreadRecord *record = new ThreadRecord();
+		record->threadId = ++threadRecordCount;
+		record->owned.store(true, std::memory_order_relaxed);
+		ThreadRecord *head = threadRecords.load();
+		do {
+			record->next = head;
+		} while (!threadRecords.compare_exchange_weak(head, record));
+
+		return record;
+	}
+
+	/// <summary>
+	/// Hands the record of a thread back when the thread exits, so another thread can take it over
+	/// </summary>
+	struct RecordOwner {
+		/// <summary>
+		/// The record of the thread, NULL until the thread records for the first time
+		/// </summary>
+		ThreadRecord *record = nullptr;
+
+		/// <summary>
+		/// Release the record of the thread
+		/// </summary>
+		~RecordOwner() {
+			if (this->record != nullptr) {
+				this->record->owned.store(false, std::memory_order_release);
+			}
+		}
+	};
+
+	/// <summary>
+	/// Gets the record of the calling thread, taking one on first use
+	/// </summary>
+	/// <returns>The record of the calling thread</returns>
+	static ThreadRecord &CurrentRecord() {
+		thread_local RecordOwner owner;
+		if (owner.record == nullptr) {
+			owner.record = AcquireRecord();
+		}
+
+		return *owner.record;
+	}
+
+	/// <summary>
+	/// Add a value to a histogram
+	/// </summary>
+	/// <param name="histogram">The histogram</param>
+	/// <param name="bucket">The bucket of the value</param>
+	/// <param name="value">The value</param>
+	static void Add(Histogram &histogram, int bucket, uint64_t value) {
+		histogram.buckets[bucket].fetch_add(1, std::memory_order_relaxed);
+		histogram.count.fetch_add(1, std::memory_order_relaxed);
+		histogram.total.fetch_add(value, std::memory_order_relaxed);
+	}
+
+	/// <summary>
+	/// Sum a histogram over all threads
+	/// </summary>
+	/// <param name="select">Selects the histogram of a thread record</param>
+	/// <param name="buckets">Receives the summed buckets</param>
+	/// <param name="total">Receives the summed total</param>
+	/// <returns>The summed amount of values</returns>
+	template<typename Select>
+	static uint64_t Sum(Select select, uint64_t buckets[], uint64_t &total) {
+		std::fill(buckets, buckets + Instrumentation::BucketCount, 0);
+		uint64_t count = 0;
+		total = 0;
+		for (ThreadRecord *record = threadRecords.load(); record != nullptr; record = record->next) {
+			Histogram &histogram = select(*record);
+			for (int i = 0; i < Instrumentation::BucketCount; i++) {
+				buckets[i] += histogram.buckets[i].load(std::memory_order_relaxed);
+			}
+
+			count += histogram.count.load(std::memory_order_relaxed);
+			total += histogram.total.load(std::memory_order_relaxed);
+		}
+
+		return count;
+	}
+
+	/// <summary>
+	/// Clear a histogram
+	/// </summary>
+	/// <param name="histogram">The histogram</param>
+	static void Clear(Histogram &histogram) {
+		for (int i = 0; i < Instrumentation::BucketCount; i++) {
+			histogram.buckets[i].store(0, std::memory_order_relaxed);
+		}
+
+		histogram.count.store(0, std::memory_order_relaxed);
+		histogram.total.store(0, std::memory_order_relaxed);
+	}
+
+	/// <summary>
+	/// Gets the current time in nanoseconds of a monotonic clock
+	/// </summary>
+	uint64_t Instrumentation::Now() {
+		return (uint64_t)std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+	}
+
+	/// <summary>
+	/// Record the duration of a stage
+	/// </summary>
+	/// <param name="stage">The timed stage</param>
+	/// <param name="start">The start of the stage in nanoseconds</param>
+	/// <param name="duration">The duration of the stage in nanoseconds</param>
+	void Instrumentation::RecordStage(Stage stage, uint64_t start, uint64_t duration) {
+		ThreadRecord &record = CurrentRecord();
+		Add(record.stages[(int)stage], Bucket(duration), duration);
+		record.frameDurations[(int)stage] += duration;
+		if (!traceEnabled.load(std::memory_order_relaxed)) {
+			return;
+		}
+
+		TraceEvent *events = record.trace.load(std::memory_order_relaxed);
+		if (events == nullptr) {
+			events = new TraceEvent[TraceCapacity]();
+			record.trace.store(events, std::memory_order_release);
+		}
+
+		// Only this thread writes the ring, the count is published after the event so a reader never sees a half written one
+		uint64_t index = record.traceCount.load(std::memory_order_relaxed);
+		TraceEvent &event = events[index % TraceCapacity];
+		event.start.store(start, std::memory_order_relaxed);
+		event.duration.store(duration, std::memory_order_relaxed);
+		event.stage.store((int)stage, std::memory_order_relaxed);
+		record.traceCount.store(index + 1, std::memory_order_release);
+	}
+
+	/// <summary>
+	/// Record the size of the stripe region
+	/// </summary>
+	/// <param name="width">The width of the region in pixels</param>
+	/// <param name="height">The height of the region in pixels</param>
+	void Instrumentation::RecordRegion(int width, int height) {
+		uint64_t pixels = (uint64_t)std::max(width, 0) * (uint64_t)std::max(height, 0);
+		Add(CurrentRecord().regions, Bucket(pixels), pixels);
+	}
+
+	/// <summary>
+	/// Record the amount of counted stripes
+	/// </summary>
+	/// <param name="count">The amount of stripes above the water</param>
+	void Instrumentation::RecordStripes(int count) {
+		Add(CurrentRecord().stripes, std::min(std::max(count, 0), BucketCount - 1), (uint64_t)std::max(count, 0));
+	}
+
+	/// <summary>
+	/// Record why a frame gave no water level, or that it gave one
+	/// </summary>
+	/// <param name="rejection">The reason</param>
+	void Instrumentation::RecordRejection(Rejection rejection) {
+		CurrentRecord().rejections[(int)rejection].fetch_add(1, std::memory_order_relaxed);
+	}
+
+	/// <summary>
+	/// Take the summed duration of every stage the calling thread ran since its last call, and start summing again
+	/// </summary>
+	/// <param name="durations">Receives the duration in nanoseconds of every stage</param>
+	void Instrumentation::TakeFrameDurations(uint64_t durations[]) {
+		ThreadRecord &record = CurrentRecord();
+		for (int i = 0; i < (int)Stage::Count; i++) {
+			durations[i] = record.frameDurations[i];
+			record.frameDurations[i] = 0;
+		}
+	}
+
+	/// <summary>
+	/// Sum the duration histogram of a stage over all threads
+	/// </summary>
+	/// <param name="stage">The timed stage</param>
+	/// <param name="buckets">Receives BucketCount buckets of durations in nanoseconds</param>
+	/// <param name="total">Receives the summed duration in nanoseconds</param>
+	/// <returns>The amount of recorded durations</returns>
+	uint64_t Instrumentation::GetStageHistogram(Stage stage, uint64_t buckets[], uint64_t &total) {
+		return Sum([stage](ThreadRecord &record) -> Histogram& { return record.stages[(int)stage]; }, buckets, total);
+	}
+
+	/// <summary>
+	/// Sum the histogram of the region sizes in pixels over all threads
+	/// </summary>
+	/// <param name="buckets">Receives BucketCount buckets of region sizes</param>
+	/// <returns>The amount of recorded regions</returns>
+	uint64_t Instrumentation::GetRegionHistogram(uint64_t buckets[]) {
+		uint64_t total;
+		return Sum([](ThreadRecord &record) -> Histogram& { return record.regions; }, buckets, total);
+	}
+
+	/// <summary>
+	/// Sum the histogram of the counted stripes over all threads
+	/// </summary>
+	/// <param name="buckets">Receives BucketCount buckets, bucket i counts the frames with i stripes and the last one every frame with more</param>
+	/// <returns>The amount of recorded counts</returns>
+	uint64_t Instrumentation::GetStripeHistogram(uint64_t buckets[]) {
+		uint64_t total;
+		return Sum([](ThreadRecord &record) -> Histogram& { return record.stripes; }, buckets, total);
+	}
+
+	/// <summary>
+	/// Sum the amount of frames with the given outcome over all threads
+	/// </summary>
+	/// <param name="rejection">The reason</param>
+	/// <returns>The amount of frames</returns>
+	uint64_t Instrumentation::GetRejectionCount(Rejection rejection) {
+		uint64_t count = 0;
+		for (ThreadRecord *record = threadRecords.load(); record != nullptr; record = record->next) {
+			count += record->rejections[(int)rejection].load(std::memory_order_relaxed);
+		}
+
+		return count;
+	}
+
+	/// <summary>
+	/// Clear the histograms of all threads
+	/// </summary>
+	void Instrumentation::Reset() {
+		for (ThreadRecord *record = threadRecords.load(); record != nullptr; record = record->next) {
+			for (int i = 0; i < (int)Stage::Count; i++) {
+				Clear(record->stages[i]);
+			}
+
+			Clear(record->regions);
+			Clear(record->stripes);
+			for (int i = 0; i < (int)Rejection::Count; i++) {
+				record->rejections[i].store(0, std::memory_order_relaxed);
+			}
+		}
+	}
+
+	/// <summary>
+	/// Sets whether the stages are also kept as trace events
+	/// </summary>
+	void Instrumentation::SetTraceEnabled(bool enabled) {
+		traceEnabled.store(enabled);
+	}
+
+	/// <summary>
+	/// Write the kept trace events of all threads as a Chrome trace, which can be opened in chrome://tracing
+	/// </summary>
+	/// <param name="path">The path of the JSON file</param>
+	/// <returns>False if the file could not be written</returns>
+	bool Instrumentation::WriteTrace(const std::string &path) {
+		std::ofstream file(path);
+		if (!file) {
+			return false;
+		}
+
+		file << std::fixed << std::setprecision(3) << "{\"traceEvents\":[";
+		bool first = true;
+		for (ThreadRecord *record = threadRecords.load(); record != nullptr; record = record->next) {
+			uint64_t count = record->traceCount.load(std::memory_order_acquire);
+			TraceEvent *events = record->trace.load(std::memory_order_acquire);
+			if (events == nullptr) {
+				continue;
+			}
+
+			for (uint64_t index = count > TraceCapacity ? count - TraceCapacity : 0; index < count; index++) {
+				TraceEvent &event = events[index % TraceCapacity];
+				file << (first ? "" : ",") << "\n{\"name\":\"" << StageNames[event.stage.load(std::memory_order_relaxed)]
+					<< "\",\"ph\":\"X\",\"pid\":1,\"tid\":" << record->threadId
+					<< ",\"ts\":" << event.start.load(std::memory_order_relaxed) / 1000.0
+					<< ",\"dur\":" << event.duration.load(std::memory_order_relaxed) / 1000.0 << "}";
+				first = false;
+			}
+		}
+
+		file << "\n]}\n";
+		return (bool)file;
+	}
+
+	/// <summary>
+	/// Gets the bucket of a value
+	/// </summary>
+	/// <param name="value">The value</param>
+	/// <returns>The index of the bucket</returns>
+	int Instrumentation::Bucket(uint64_t value) {
+		int bucket = 0;
+		while (value > 0 && bucket < BucketCount - 1) {
+			value >>= 1;
+			bucket++;
+		}
+
+		return bucket;
+	}
+}
+
+using namespace waterleveltracking;
+
+/// <summary>
+/// Copy summed buckets to the buffer of the caller
+/// </summary>
+/// <param name="source">The summed buckets</param>
+/// <param name="buckets">The buffer of the caller, may be NULL</param>
+/// <param name="bucketCount">The size of the buffer</param>
+static void CopyBuckets(const uint64_t source[], unsigned long long *buckets, int bucketCount) {
+	for (int i = 0; buckets != NULL && i < bucketCount; i++) {
+		buckets[i] = i < Instrumentation::BucketCount ? source[i] : 0;
+	}
+}
+
+/// <summary>
+/// Gets whether the library is built with the instrumentation
+/// </summary>
+/// <returns>1 if the pipeline records, 0 if every histogram stays empty</returns>
+int WltIsInstrumentationEnabled() {
+#ifdef WLT_ENABLE_INSTRUMENTATION
+	return 1;
+#else
+	return 0;
+#endif
+}
+
+/// <summary>
+/// Copy the duration histogram of a stage, summed over all threads
+/// </summary>
+/// <param name="stage">The index of the stage in the Stage enum</param>
+/// <param name="buckets">Receives up to bucketCount buckets, bucket i counts the durations in [2^(i-1), 2^i) nanoseconds</param>
+/// <param name="bucketCount">The size of buckets</param>
+/// <param name="totalNanoseconds">Receives the summed duration</param>
+/// <returns>The amount of recorded durations, -1 if the stage does not exist</returns>
+long long WltGetStageHistogram(int stage, unsigned long long *buckets, int bucketCount, unsigned long long *totalNanoseconds) {
+	if (stage < 0 || stage >= (int)Stage::Count) {
+		return -1;
+	}
+
+	uint64_t summed[Instrumentation::BucketCount];
+	uint64_t total;
+	uint64_t count = Instrumentation::GetStageHistogram((Stage)stage, summed, total);
+	CopyBuckets(summed, buckets, bucketCount);
+	if (totalNanoseconds != NULL) {
+		*totalNanoseconds = total;
+	}
+
+	return (long long)count;
+}
+
+/// <summary>
+/// Copy the histogram of the stripe region sizes in pixels, summed over all threads
+/// </summary>
+/// <param name="buckets">Receives up to bucketCount buckets, bucket i counts the sizes in [2^(i-1), 2^i)</param>
+/// <param name="bucketCount">The size of buckets</param>
+/// <returns>The amount of recorded regions</returns>
+long long WltGetRegionHistogram(unsigned long long *buckets, int bucketCount) {
+	uint64_t summed[Instrumentation::BucketCount];
+	uint64_t count = Instrumentation::GetRegionHistogram(summed);
+	CopyBuckets(summed, buckets, bucketCount);
+	return (long long)count;
+}
+
+/// <summary>
+/// Copy the histogram of the counted stripes, summed over all threads
+/// </summary>
+/// <param name="buckets">Receives up to bucketCount buckets, bucket i counts the frames with i stripes</param>
+/// <param name="bucketCount">The size of buckets</param>
+/// <returns>The amount of recorded counts</returns>
+long long WltGetStripeHistogram(unsigned long long *buckets, int bucketCount) {
+	uint64_t summed[Instrumentation::BucketCount];
+	uint64_t count = Instrumentation::GetStripeHistogram(summed);
+	CopyBuckets(summed, buckets, bucketCount);
+	return (long long)count;
+}
+
+/// <summary>
+/// Gets the amount of frames with the given outcome, summed over all threads
+/// </summary>
+/// <param name="rejection">The index of the reason in the Rejection enum</param>
+/// <returns>The amount of frames, -1 if the reason does not exist</returns>
+long long WltGetRejectionCount(int rejection) {
+	if (rejection < 0 || rejection >= (int)Rejection::Count) {
+		return -1;
+	}
+
+	return (long long)Instrumentation::GetRejectionCount((Rejection)rejection);
+}
+
+/// <summary>
+/// Clear all histograms
+/// </summary>
+void WltResetInstrumentation() {
+	Instrumentation::Reset();
+}
+
+/// <summary>
+/// Sets whether the stages are also kept as trace events
+/// </summary>
+/// <param name="enabled">Non zero to keep the events</param>
+void WltSetTraceEnabled(int enabled) {
+	Instrumentation::SetTraceEnabled(enabled != 0);
+}
+
+/// <summary>
+/// Write the kept trace events as a Chrome trace
+/// </summary>
+/// <param name="path">The path of the JSON file</param>
+/// <returns>1 if the file was written, 0 otherwise</returns>
+int WltWriteTrace(const char *path) {
+	return path != NULL && Instrumentation::WriteTrace(path) ? 1 : 0;
+}
\ No newline at end of file
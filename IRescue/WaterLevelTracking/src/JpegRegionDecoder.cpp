@@ -0,0 +1,200 @@
+// <copyright file="JpegRegionDecoder.cpp" company="Delft University of Technology">
+// Copyright (c) Delft University of Technology. All rights reserved.
+// </copyright>
+
+#include "../include/JpegRegionDecoder.h"
+#ifdef WLT_WITH_LIBJPEG_TURBO
+#include <csetjmp>
+#include <cstdio>
+#include <jpeglib.h>
+#endif
+
+namespace waterleveltracking {
+#ifdef WLT_WITH_LIBJPEG_TURBO
+	/// <summary>
+	/// The decompressor of libjpeg-turbo and its error handler
+	/// </summary>
+	struct JpegRegionDecoder::Context {
+		/// <summary>
+		/// The decompressor
+		/// </summary>
+		jpeg_decompress_struct decompressor;
+
+		/// <summary>
+		/// The error handler, whose fatal errors jump back to the call which started the decompressor
+		/// </summary>
+		jpeg_error_mgr errors;
+
+		/// <summary>
+		/// Where a fatal error of the decompressor continues
+		/// </summary>
+		jmp_buf failure;
+	};
+
+	/// <summary>
+	/// Continue after a fatal error of the decompressor at the call which started it, instead of exiting the process
+	/// </summary>
+	/// <param name="decompressor">The decompressor which failed</param>
+	static void Fail(j_common_ptr decompressor) {
+		longjmp(*static_cast<jmp_buf*>(decompressor->client_data), 1);
+	}
+
+	/// <summary>
+	/// Ignore the warnings of the decompressor, a damaged frame of a camera still decodes as far as it can
+	/// </summary>
+	static void IgnoreMessage(j_common_ptr) {
+	}
+#endif
+
+	/// <summary>
+	/// Initializes a new instance of the <see cref="JpegRegionDecoder"/> class.
+	/// </summary>
+	JpegRegionDecoder::JpegRegionDecoder() {
+		this->context = NULL;
+		this->open = false;
+#ifdef WLT_WITH_LIBJPEG_TURBO
+		this->context = new Context();
+		this->context->decompressor.err = jpeg_std_error(&this->context->errors);
+		this->context->errors.error_exit = Fail;
+		this->context->errors.output_message = IgnoreMessage;
+		jpeg_create_decompress(&this->context->decompressor);
+		this->context->decompressor.client_data = &this->context->failure;
+#endif
+	}
+
+	/// <summary>
+	/// Releases the decompressor.
+	/// </summary>
+	JpegRegionDecoder::~JpegRegionDecoder() {
+#ifdef WLT_WITH_LIBJPEG_TURBO
+		jpeg_destroy_decompress(&this->context->decompressor);
+		delete this->context;
+#endif
+	}
+
+	/// <summary>
+	/// Read the header of a JPEG image, the bytes must stay valid until the image is decoded
+	/// </summary>
+	/// <param name="data">The compressed image</param>
+	/// <param name="size">The size of the compressed image in bytes</param>
+	/// <param name="frameSize">Receives the size of the image</param>
+	/// <returns>False if the bytes are not a JPEG image or the library is built without libjpeg-turbo</returns>
+	bool JpegRegionDecoder::Open(const unsigned char *data, size_t size, Size &frameSize) {
+#ifdef WLT_WITH_LIBJPEG_TURBO
+		jpeg_decompress_struct &decompressor = this->context->decompressor;
+		jpeg_abort_decompress(&decompressor);
+		this->open = false;
+		if (data == NULL || size == 0) {
+			return false;
+		}
+
+		if (setjmp(this->context->failure)) {
+			jpeg_abort_decompress(&decompressor);
+			return false;
+		}
+
+		jpeg_mem_src(&decompressor, data, (unsigned long)size);
+		if (jpeg_read_header(&decompressor, TRUE) != JPEG_HEADER_OK) {
+			jpeg_abort_decompress(&decompressor);
+			return false;
+		}
+
+		frameSize = Size((int)decompressor.image_width, (int)decompressor.image_height);
+		this->open = true;
+		return true;
+#else
+		(void)data;
+		(void)size;
+		(void)frameSize;
+		return false;
+#endif
+	}
+
+	/// <summary>
+	/// Decode the region of the opened image into a grayscale frame of the size of the image.
+	/// The region is widened to whole MCU columns, the pixels outside it are black.
+	/// </summary>
+	/// <param name="region">The region to decode, an empty region decodes nothing</param>
+	/// <param name="frame">Receives the grayscale frame, which shares the scratch buffer of the decoder</param>
+	/// <returns>False if no image is open or the image is corrupt</returns>
+	bool JpegRegionDecoder::Decode(Rect region, Mat &frame) {
+#ifdef WLT_WITH_LIBJPEG_TURBO
+		if (!this->open) {
+			return false;
+		}
+
+		this->open = false;
+		jpeg_decompress_struct &decompressor = this->context->decompressor;
+		Size frameSize((int)decompressor.image_width, (int)decompressor.image_height);
+		if (this->frameBuffer.size() != frameSize || this->frameBuffer.type() != CV_8UC1) {
+			this->frameBuffer.create(frameSize, CV_8UC1);
+			this->frameBuffer = Scalar(0);
+		} else if (this->decodedRegion.width > 0 && this->decodedRegion.height > 0) {
+			// Only the region of the previous image holds pixels, clearing it leaves nothing of that image behind
+			this->frameBuffer(this->decodedRegion) = Scalar(0);
+		}
+
+		frame = this->frameBuffer;
+		region &= Rect(0, 0, frameSize.width, frameSize.height);
+		this->decodedRegion = Rect();
+		if (region.width <= 0 || region.height <= 0) {
+			jpeg_abort_decompress(&decompressor);
+			return true;
+		}
+
+		if (setjmp(this->context->failure)) {
+			jpeg_abort_decompress(&decompressor);
+			return false;
+		}
+
+		// Asking for grayscale output of a color image skips the upsampling and conversion of the chroma
+		decompressor.out_color_space = JCS_GRAYSCALE;
+		jpeg_start_decompress(&decompressor);
+
+		// The crop is widened by libjpeg-turbo to the MCU columns which hold the region
+		JDIMENSION left = (JDIMENSION)region.x;
+		JDIMENSION width = (JDIMENSION)region.width;
+		jpeg_crop_scanline(&decompressor, &left, &width);
+		this->decodedRegion = Rect((int)left, region.y, (int)width, region.height);
+		if (region.y > 0) {
+			jpeg_skip_scanlines(&decompressor, (JDIMENSION)region.y);
+		}
+
+		int bottom = region.y + region.height;
+		while ((int)decompressor.output_scanline < bottom) {
+			JSAMPROW row = this->frameBuffer.ptr<uchar>((int)decompressor.output_scanline) + left;
+			if (jpeg_read_scanlines(&decompressor, &row, 1) != 1) {
+				break;
+			}
+		}
+
+		// The rows below the region are never decoded, a failed image keeps the whole region so the next image clears it
+		int decodedBottom = (int)decompressor.output_scanline;
+		jpeg_abort_decompress(&decompressor);
+		this->decodedRegion = Rect((int)left, region.y, (int)width, decodedBottom - region.y);
+		return true;
+#else
+		(void)region;
+		(void)frame;
+		return false;
+#endif
+	}
+
+	/// <summary>
+	/// Gets the region the last call to Decode decoded, widened to whole MCU columns
+	/// </summary>
+	Rect JpegRegionDecoder::GetDecodedRegion() {
+		return this->decodedRegion;
+	}
+
+	/// <summary>
+	/// Gets whether the library is built with libjpeg-turbo
+	/// </summary>
+	bool JpegRegionDecoder::IsAvailable() {
+#ifdef WLT_WITH_LIBJPEG_TURBO
+		return true;
+#else
+		return false;
+#endif
+	}
+}
\ No newline at end of file
@@ -0,0 +1,165 @@
+// <copyright file="LatencyGovernor.cpp" company="Delft University of Technology">
+// Copyright (c) Delft University of Technology. All rights reserved.
+// </copyright>
+
+#include "../include/LatencyGovernor.h"
+
+namespace waterleveltracking {
+	/// <summary>
+	/// Initializes a new instance of the <see cref="LatencyGovernor"/> class.
+	/// </summary>
+	/// <param name="budget">The time in seconds a frame may cost, 0 to always process at the configured quality</param>
+	/// <param name="smoothing">The weight of the newest cost in the moving average, between 0 and 1</param>
+	LatencyGovernor::LatencyGovernor(double budget, double smoothing) {
+		this->budget = budget;
+		this->smoothing = std::min(std::max(smoothing, 0.01), 1.0);
+		this->skippedCount = 0;
+		this->Reset();
+	}
+
+	/// <summary>
+	/// Decide whether the next frame is processed or skipped at the active quality level
+	/// </summary>
+	/// <returns>True if the frame has to be processed, false if the level of the last processed frame is used</returns>
+	bool LatencyGovernor::Admit() {
+		if (this->framesSinceProcessed < FrameSkip(this->qualityLevel)) {
+			this->framesSinceProcessed++;
+			this->skippedCount++;
+			return false;
+		}
+
+		this->framesSinceProcessed = 0;
+		return true;
+	}
+
+	/// <summary>
+	/// Add the cost of a processed frame to the moving average and step the quality level if the average
+	/// stayed on one side of the budget for long enough
+	/// </summary>
+	/// <param name="cost">The time in seconds the frame took</param>
+	/// <returns>True if the quality level changed, the options have to be applied again</returns>
+	bool LatencyGovernor::Record(double cost) {
+		if (this->budget <= 0) {
+			return false;
+		}
+
+		this->averageCost = this->hasCost ? this->averageCost + this->smoothing * (cost - this->averageCost) : cost;
+		this->hasCost = true;
+
+		// The skipped frames share the cost of the processed one, the finer level skips fewer frames to share it with
+		double frameCost = this->averageCost / (FrameSkip(this->qualityLevel) + 1);
+		double finerFrameCost = this->averageCost / (FrameSkip(std::max(this->qualityLevel - 1, 0)) + 1);
+		if (frameCost > this->budget) {
+			this->overCount++;
+			this->underCount = 0;
+		} else if (finerFrameCost * 100 < this->budget * StepUpPercent) {
+			this->underCount++;
+			this->overCount = 0;
+		} else {
+			this->overCount = 0;
+			this->underCount = 0;
+		}
+
+		if (this->overCount >= StepDownFrames && this->qualityLevel < MaxQualityLevel) {
+			this->Step(this->qualityLevel + 1);
+			return true;
+		}
+
+		if (this->underCount >= StepUpFrames && this->qualityLevel > 0) {
+			this->Step(this->qualityLevel - 1);
+			return true;
+		}
+
+		return false;
+	}
+
+	/// <summary>
+	/// Lower the quality of the configured options to the active quality level
+	/// </summary>
+	/// <param name="options">The options as configured</param>
+	/// <returns>The options to process the frames with</returns>
+	TrackerOptions LatencyGovernor::Apply(TrackerOptions options) {
+		if (this->qualityLevel >= 1) {
+			options.blurSize = std::min(options.blurSize, 3);
+			options.bandCount = std::max(options.bandCount >> (this->qualityLevel >= 3 ? 2 : 1), std::min(options.bandCount, 2));
+
+			// Fewer sampled columns make every stage after the warp cheaper whatever the profile mode
+			options.columnStep = std::max(options.columnStep, 1 << std::min(this->qualityLevel, 2));
+		}
+
+		// A lower minimum stripe height lets the tracker halve the frame more often, outside the FullFrame mode that only samples fewer pixels
+		if (this->qualityLevel >= 2) {
+			int stripePixelHeight = CoarseStripePixelHeight >> (std::min(this->qualityLevel, 3) - 2);
+			options.minStripePixelHeight = options.minStripePixelHeight > 0 ? std::min(options.minStripePixelHeight, stripePixelHeight) : stripePixelHeight;
+		}
+
+		return options;
+	}
+
+	/// <summary>
+	/// Return to the configured quality and forget the measured cost
+	/// </summary>
+	void LatencyGovernor::Reset() {
+		this->Step(0);
+	}
+
+	/// <summary>
+	/// Gets the active quality level, 0 is the configured quality and MaxQualityLevel the coarsest
+	/// </summary>
+	int LatencyGovernor::GetQualityLevel() {
+		return this->qualityLevel;
+	}
+
+	/// <summary>
+	/// Gets the budget
+	/// </summary>
+	double LatencyGovernor::GetBudget() {
+		return this->budget;
+	}
+
+	/// <summary>
+	/// Sets the budget, 0 returns to the configured quality
+	/// </summary>
+	void LatencyGovernor::SetBudget(double budget) {
+		this->budget = budget;
+		if (budget <= 0) {
+			this->Reset();
+		}
+	}
+
+	/// <summary>
+	/// Gets the moving average of the cost in seconds of the processed frames at the active quality level
+	/// </summary>
+	double LatencyGovernor::GetAverageCost() {
+		return this->averageCost;
+	}
+
+	/// <summary>
+	/// Gets the amount of frames which were skipped
+	/// </summary>
+	long long LatencyGovernor::GetSkippedCount() {
+		return this->skippedCount;
+	}
+
+	/// <summary>
+	/// Gets the amount of frames skipped after every processed frame at a quality level
+	/// </summary>
+	/// <param name="qualityLevel">The quality level</param>
+	/// <returns>The amount of skipped frames</returns>
+	int LatencyGovernor::FrameSkip(int qualityLevel) {
+		return qualityLevel >= 3 ? (1 << (qualityLevel - 2)) - 1 : 0;
+	}
+
+	/// <summary>
+	/// Move to another quality level and start measuring its cost from scratch
+	/// </summary>
+	/// <param name="qualityLevel">The new quality level</param>
+	void LatencyGovernor::Step(int qualityLevel) {
+		this->qualityLevel = qualityLevel;
+		this->averageCost = 0;
+		this->hasCost = false;
+		this->overCount = 0;
+		this->underCount = 0;
+		this->framesSinceProcessed = 0;
+	}
+}
\ No newline at end of file
@@ -0,0 +1,108 @@
+// <copyright file="LevelBoard.cpp" company="Delft University of Technology">
+// Copyright (c) Delft University of Technology. All rights reserved.
+// </copyright>
+
+#include "../include/LevelBoard.h"
+
+static_assert(WLT_STAGE_COUNT == (int)waterleveltracking::Stage::Count, "A level sample needs a timing for every stage");
+
+namespace waterleveltracking {
+	LevelBoard::Slot LevelBoard::slots[LevelBoard::MarkerCapacity];
+
+	/// <summary>
+	/// Publish the level of a frame with the stage timings the calling thread recorded since it last published
+	/// </summary>
+	/// <param name="marker">The slot of the marker</param>
+	/// <param name="level">The height of the water in meters</param>
+	/// <param name="confidence">How much the level can be trusted, from 0 to 1</param>
+	/// <param name="timestamp">The timestamp of the frame in microseconds</param>
+	/// <returns>False if the slot does not exist</returns>
+	bool LevelBoard::Publish(int marker, double level, double confidence, long long timestamp) {
+		WltLevelSample sample = WltLevelSample();
+		sample.timestamp = timestamp;
+		sample.level = level;
+		sample.confidence = confidence;
+#ifdef WLT_ENABLE_INSTRUMENTATION
+		uint64_t durations[WLT_STAGE_COUNT];
+		Instrumentation::TakeFrameDurations(durations);
+		for (int i = 0; i < WLT_STAGE_COUNT; i++) {
+			sample.stageTimings[i] = durations[i] * 1e-9;
+		}
+#endif
+		return Publish(marker, sample);
+	}
+
+	/// <summary>
+	/// Publish a sample, its sequence number is assigned by the board. Publishers of the same slot take turns
+	/// </summary>
+	/// <param name="marker">The slot of the marker</param>
+	/// <param name="sample">The sample to publish</param>
+	/// <returns>False if the slot does not exist</returns>
+	bool LevelBoard::Publish(int marker, WltLevelSample sample) {
+		if (marker < 0 || marker >= MarkerCapacity) {
+			return false;
+		}
+
+		// Publishers only wait for each other for the copy of one sample, the reader never waits
+		Slot &slot = slots[marker];
+		while (slot.publishing.exchange(true, std::memory_order_acquire)) {
+			std::this_thread::yield();
+		}
+
+		sample.sequence = ++slot.sequence;
+		slot.buffer.Publish(sample);
+		slot.publishing.store(false, std::memory_order_release);
+		return true;
+	}
+
+	/// <summary>
+	/// Read the newest sample of a marker
+	/// </summary>
+	/// <param name="marker">The slot of the marker</param>
+	/// <param name="sample">The newest sample</param>
+	/// <returns>False if the slot does not exist or nothing was published to it yet</returns>
+	bool LevelBoard::Read(int marker, WltLevelSample &sample) {
+		if (marker < 0 || marker >= MarkerCapacity) {
+			return false;
+		}
+
+		return slots[marker].buffer.Read(sample);
+	}
+}
+
+using namespace waterleveltracking;
+
+/// <summary>
+/// Publish the level of a marker for the render thread. The sequence number of the sample is assigned here
+/// </summary>
+/// <param name="marker">The slot of the marker, from 0 to the capacity of the board</param>
+/// <param name="sample">The sample to publish</param>
+/// <returns>1 on success, -1 if the input is wrong</returns>
+int WltPublishLevel(int marker, const WltLevelSample *sample) {
+	if (sample == NULL || !LevelBoard::Publish(marker, *sample)) {
+		return -1;
+	}
+
+	return 1;
+}
+
+/// <summary>
+/// Read the newest level of a marker without waiting, only one thread may read a marker at a time
+/// </summary>
+/// <param name="marker">The slot of the marker, from 0 to the capacity of the board</param>
+/// <param name="sample">Receives the newest sample</param>
+/// <returns>1 if a sample was read, 0 if nothing was published yet, -1 if the input is wrong</returns>
+int WltReadLevel(int marker, WltLevelSample *sample) {
+	if (sample == NULL || marker < 0 || marker >= LevelBoard::MarkerCapacity) {
+		return -1;
+	}
+
+	return LevelBoard::Read(marker, *sample) ? 1 : 0;
+}
+
+/// <summary>
+/// Gets the amount of markers the board has a slot for
+/// </summary>
+int WltGetLevelBoardCapacity() {
+	return LevelBoard::MarkerCapacity;
+}
\ No newline at end of file
@@ -0,0 +1,546 @@
+// <copyright file="LevelHistory.cpp" company="Delft University of Technology">
+// Copyright (c) Delft University of Technology. All rights reserved.
+// </copyright>
+
+#include "../include/LevelHistory.h"
+
+namespace waterleveltracking {
+	/// <summary>
+	/// The height in meters of one step of a stored level
+	/// </summary>
+	const double LevelHistory::LevelStep = 0.001;
+
+	/// <summary>
+	/// The highest level in meters a sample can hold, and the negative of the lowest. A level beyond it is stored as a frame which gave no level
+	/// </summary>
+	const double LevelHistory::MaxLevel = INT32_MAX * LevelHistory::LevelStep;
+
+	/// <summary>
+	/// The windows of a history which is not given any: a minute, an hour and a day
+	/// </summary>
+	static const long long DefaultWindows[] = { 60000000LL, 3600000000LL, 86400000000LL };
+
+	/// <summary>
+	/// Initializes a new instance of the <see cref="LevelHistory"/> class with windows of a minute, an hour and a day.
+	/// </summary>
+	/// <param name="capacity">The amount of samples the ring holds</param>
+	/// <param name="profileRows">The amount of rows a row profile is resampled to before it is stored</param>
+	LevelHistory::LevelHistory(int capacity, int profileRows) {
+		this->Initialize(capacity, profileRows, DefaultWindows, 3);
+	}
+
+	/// <summary>
+	/// Initializes a new instance of the <see cref="LevelHistory"/> class.
+	/// </summary>
+	/// <param name="capacity">The amount of samples the ring holds</param>
+	/// <param name="profileRows">The amount of rows a row profile is resampled to before it is stored</param>
+	/// <param name="windows">The length of every window in microseconds</param>
+	/// <param name="windowCount">The amount of windows, at most MaxWindowCount</param>
+	LevelHistory::LevelHistory(int capacity, int profileRows, const long long windows[], int windowCount) {
+		this->Initialize(capacity, profileRows, windows, windowCount);
+	}
+
+	/// <summary>
+	/// Set up the ring and the windows
+	/// </summary>
+	/// <param name="capacity">The amount of samples the ring holds</param>
+	/// <param name="profileRows">The amount of rows a row profile is resampled to before it is stored</param>
+	/// <param name="windows">The length of every window in microseconds</param>
+	/// <param name="windowCount">The amount of windows</param>
+	void LevelHistory::Initialize(int capacity, int profileRows, const long long windows[], int windowCount) {
+		// Everything is allocated here, adding a sample never allocates
+		capacity = std::max(capacity, 1);
+		this->profileRows = std::max(profileRows, 0);
+		this->profileWords = (this->profileRows + 63) / 64;
+		this->timestamps.assign(capacity, 0);
+		this->levels.assign(capacity, (int32_t)MissingLevel);
+		this->profiles.assign((size_t)capacity * this->profileWords, 0);
+		this->profiled.assign(capacity, false);
+		this->next = 0;
+		this->count = 0;
+		this->windowCount = std::max(std::min(windowCount, (int)MaxWindowCount), 0);
+		for (int i = 0; i < this->windowCount; i++) {
+			// A window is at least one microsecond per bucket long
+			this->windows[i].bucketDuration = std::max(windows[i] / BucketCount, 1LL);
+			this->windows[i].duration = this->windows[i].bucketDuration * BucketCount;
+			Clear(this->windows[i]);
+		}
+	}
+
+	/// <summary>
+	/// Add the level of a frame without a row profile
+	/// </summary>
+	/// <param name="timestamp">The timestamp of the frame in microseconds, not negative and not earlier than that of the previous sample</param>
+	/// <param name="level">The height of the water in meters, ignored if the frame gave no level, kept as no level if it is not finite or beyond 2147483.647 meters up or down</param>
+	/// <param name="valid">Whether the frame gave a level, the status of the frame is WLT_STATUS_OK</param>
+	/// <returns>False if the timestamp is negative or earlier than that of the previous sample</returns>
+	bool LevelHistory::Add(long long timestamp, double level, bool valid) {
+		int position = this->Store(timestamp, level, valid);
+		if (position < 0) {
+			return false;
+		}
+
+		this->profiled[position] = false;
+		return true;
+	}
+
+	/// <summary>
+	/// Add the level of a frame with the row profile it was counted from
+	/// </summary>
+	/// <param name="timestamp">The timestamp of the frame in microseconds, not negative and not earlier than that of the previous sample</param>
+	/// <param name="level">The height of the water in meters, ignored if the frame gave no level, kept as no level if it is not finite or beyond 2147483.647 meters up or down</param>
+	/// <param name="valid">Whether the frame gave a level, the status of the frame is WLT_STATUS_OK</param>
+	/// <param name="profile">The row profile of the stripe region, 255 for every row of a white stripe and 0 for every other row</param>
+	/// <returns>False if the timestamp is negative or earlier than that of the previous sample</returns>
+	bool LevelHistory::Add(long long timestamp, double level, bool valid, const std::vector<unsigned char> &profile) {
+		int position = this->Store(timestamp, level, valid);
+		if (position < 0) {
+			return false;
+		}
+
+		// The profile is resampled to the fixed amount of rows, so every sample takes the same memory whatever the size of the region
+		uint64_t *words = &this->profiles[(size_t)position * this->profileWords];
+		std::fill(words, words + this->profileWords, 0);
+		this->profiled[position] = !profile.empty() && this->profileRows > 0;
+		if (this->profiled[position]) {
+			size_t rows = profile.size();
+			for (int row = 0; row < this->profileRows; row++) {
+				if (profile[(row * rows) / this->profileRows] != 0) {
+					words[row / 64] |= 1ULL << (row % 64);
+				}
+			}
+		}
+
+		return true;
+	}
+
+	/// <summary>
+	/// Store a sample in the ring and add its level to every window
+	/// </summary>
+	/// <param name="timestamp">The timestamp of the frame in microseconds</param>
+	/// <param name="level">The height of the water in meters, ignored if the frame gave no level, stored as no level if it is not finite or beyond MaxLevel</param>
+	/// <param name="valid">Whether the frame gave a level, the status of the frame is WLT_STATUS_OK</param>
+	/// <returns>The position of the sample in the ring, -1 if the timestamp is negative or earlier than that of the previous sample</returns>
+	int LevelHistory::Store(long long timestamp, double level, bool valid) {
+		if (timestamp < 0 || (this->count > 0 && timestamp < this->timestamps[this->Position(0)])) {
+			return -1;
+		}
+
+		// A level the steps cannot hold is flagged as missing instead of being clamped to a wrong level
+		valid = valid && std::isfinite(level) && std::fabs(level) <= MaxLevel;
+		int position = this->next;
+		this->timestamps[position] = timestamp;
+		this->levels[position] = valid ? (int32_t)std::llround(level / LevelStep) : MissingLevel;
+
+		// A frame without a level still moves the windows, they end at the newest sample.
+		// The windows see the stored level, so the statistics agree with the samples which are read back
+		for (int i = 0; i < this->windowCount; i++) {
+			Advance(this->windows[i], timestamp);
+			if (valid) {
+				AddLevel(this->windows[i], timestamp, this->levels[position] * LevelStep);
+			}
+		}
+
+		this->next = (position + 1) % (int)this->timestamps.size();
+		this->count = std::min(this->count + 1, (int)this->timestamps.size());
+		return position;
+	}
+
+	/// <summary>
+	/// Gets a stored sample
+	/// </summary>
+	/// <param name="age">0 for the newest sample, 1 for the one before it and so on</param>
+	/// <param name="timestamp">Receives the timestamp of the sample in microseconds</param>
+	/// <param name="level">Receives the height of the water in meters, NULL if the frame gave no level</param>
+	/// <param name="valid">Receives whether the frame gave a level, a level of 0 is a real level when it did</param>
+	/// <returns>False if there is no sample of this age</returns>
+	bool LevelHistory::GetSample(int age, long long &timestamp, double &level, bool &valid) const {
+		int position = this->Position(age);
+		if (position < 0) {
+			return false;
+		}
+
+		timestamp = this->timestamps[position];
+		valid = this->levels[position] != MissingLevel;
+		level = valid ? this->levels[position] * LevelStep : 0.0;
+		return true;
+	}
+
+	/// <summary>
+	/// Gets the row profile of a stored sample
+	/// </summary>
+	/// <param name="age">0 for the newest sample, 1 for the one before it and so on</param>
+	/// <param name="profile">Receives 255 for every row of a white stripe and 0 for every other row, at least the amount of profile rows</param>
+	/// <returns>The amount of rows written, 0 if the sample has no profile, -1 if there is no sample of this age</returns>
+	int LevelHistory::GetProfile(int age, unsigned char profile[]) const {
+		int position = this->Position(age);
+		if (position < 0) {
+			return -1;
+		}
+
+		if (!this->profiled[position]) {
+			return 0;
+		}
+
+		const uint64_t *words = &this->profiles[(size_t)position * this->profileWords];
+		for (int row = 0; row < this->profileRows; row++) {
+			profile[row] = (words[row / 64] >> (row % 64)) & 1 ? 255 : 0;
+		}
+
+		return this->profileRows;
+	}
+
+	/// <summary>
+	/// Gets the statistics of a window
+	/// </summary>
+	/// <param name="window">The index of the window</param>
+	/// <param name="statistics">Receives the statistics of the window</param>
+	/// <returns>False if the window does not exist</returns>
+	bool LevelHistory::GetStatistics(int window, WltLevelStatistics &statistics) const {
+		if (window < 0 || window >= this->windowCount) {
+			return false;
+		}
+
+		const Window &selected = this->windows[window];
+		const Bucket &total = selected.total;
+		statistics.window = selected.duration;
+		statistics.count = total.count;
+		statistics.minimum = 0;
+		statistics.maximum = 0;
+		statistics.mean = 0;
+		statistics.rateOfRise = 0;
+		if (total.count == 0) {
+			return true;
+		}
+
+		statistics.minimum = selected.buckets[selected.minima[selected.minimaStart] % BucketCount].minimum;
+		statistics.maximum = selected.buckets[selected.maxima[selected.maximaStart] % BucketCount].maximum;
+		statistics.mean = total.sumLevel / total.count;
+
+		// The slope of the least squares line, from the sums of the times and levels
+		double spread = (total.count * total.sumTimeSquared) - (total.sumTime * total.sumTime);
+		if (total.count > 1 && spread > 1e-9 * total.count * total.sumTimeSquared) {
+			statistics.rateOfRise = 3600 * ((total.count * total.sumTimeLevel) - (total.sumTime * total.sumLevel)) / spread;
+		}
+
+		return true;
+	}
+
+	/// <summary>
+	/// Gets the amount of stored samples
+	/// </summary>
+	int LevelHistory::GetCount() const {
+		return this->count;
+	}
+
+	/// <summary>
+	/// Gets the amount of samples the ring holds
+	/// </summary>
+	int LevelHistory::GetCapacity() const {
+		return (int)this->timestamps.size();
+	}
+
+	/// <summary>
+	/// Gets the amount of rows a stored row profile has
+	/// </summary>
+	int LevelHistory::GetProfileRows() const {
+		return this->profileRows;
+	}
+
+	/// <summary>
+	/// Gets the amount of windows
+	/// </summary>
+	int LevelHistory::GetWindowCount() const {
+		return this->windowCount;
+	}
+
+	/// <summary>
+	/// Gets the position in the ring of a stored sample
+	/// </summary>
+	/// <param name="age">0 for the newest sample, 1 for the one before it and so on</param>
+	/// <returns>The position, -1 if there is no sample of this age</returns>
+	int LevelHistory::Position(int age) const {
+		if (age < 0 || age >= this->count) {
+			return -1;
+		}
+
+		int capacity = (int)this->timestamps.size();
+		return (this->next - 1 - age + capacity) % capacity;
+	}
+
+	/// <summary>
+	/// Empty a window
+	/// </summary>
+	/// <param name="window">The window</param>
+	void LevelHistory::Clear(Window &window) {
+		for (int i = 0; i < BucketCount; i++) {
+			window.buckets[i] = Bucket();
+			window.buckets[i].index = -1;
+		}
+
+		window.total = Bucket();
+		window.oldest = -1;
+		window.newest = -1;
+		window.anchor = 0;
+		window.rebuild = 0;
+		window.minimaStart = 0;
+		window.minimaCount = 0;
+		window.maximaStart = 0;
+		window.maximaCount = 0;
+	}
+
+	/// <summary>
+	/// Move the end of a window to a timestamp, removing the buckets which fell out of it
+	/// </summary>
+	/// <param name="window">The window</param>
+	/// <param name="timestamp">The timestamp of the newest sample in microseconds</param>
+	void LevelHistory::Advance(Window &window, long long timestamp) {
+		long long index = timestamp / window.bucketDuration;
+		if (window.newest >= 0 && index - window.newest >= BucketCount) {
+			// Nothing of the window is left after a long gap
+			Clear(window);
+		} else {
+			Expire(window, index - BucketCount);
+		}
+	}
+
+	/// <summary>
+	/// Add a level to a window which was advanced to its timestamp, opening a new bucket when needed
+	/// </summary>
+	/// <param name="window">The window</param>
+	/// <param name="timestamp">The timestamp of the level in microseconds</param>
+	/// <param name="level">The level in meters</param>
+	void LevelHistory::AddLevel(Window &window, long long timestamp, double level) {
+		long long index = timestamp / window.bucketDuration;
+		if (index != window.newest) {
+			Bucket &opened = window.buckets[index % BucketCount];
+			opened = Bucket();
+			opened.index = index;
+			opened.minimum = level;
+			opened.maximum = level;
+			if (window.oldest < 0) {
+				window.oldest = index;
+			}
+
+			window.newest = index;
+			if (window.total.count == 0 || index >= window.rebuild) {
+				Rebuild(window);
+			}
+		}
+
+		Bucket &bucket = window.buckets[index % BucketCount];
+		double time = (double)(timestamp - (index * window.bucketDuration)) / 1e6;
+		double totalTime = (double)(timestamp - window.anchor) / 1e6;
+		bucket.count++;
+		bucket.minimum = std::min(bucket.minimum, level);
+		bucket.maximum = std::max(bucket.maximum, level);
+		bucket.sumLevel += level;
+		bucket.sumTime += time;
+		bucket.sumTimeSquared += time * time;
+		bucket.sumTimeLevel += time * level;
+		window.total.count++;
+		window.total.sumLevel += level;
+		window.total.sumTime += totalTime;
+		window.total.sumTimeSquared += totalTime * totalTime;
+		window.total.sumTimeLevel += totalTime * level;
+
+		// The newest bucket is always the last entry of both queues, it is taken out and put back behind the buckets it does not beat
+		if (window.minimaCount > 0 && window.minima[(window.minimaStart + window.minimaCount - 1) % BucketCount] == index) {
+			window.minimaCount--;
+		}
+
+		while (window.minimaCount > 0 && window.buckets[window.minima[(window.minimaStart + window.minimaCount - 1) % BucketCount] % BucketCount].minimum >= bucket.minimum) {
+			window.minimaCount--;
+		}
+
+		window.minima[(window.minimaStart + window.minimaCount) % BucketCount] = index;
+		window.minimaCount++;
+		if (window.maximaCount > 0 && window.maxima[(window.maximaStart + window.maximaCount - 1) % BucketCount] == index) {
+			window.maximaCount--;
+		}
+
+		while (window.maximaCount > 0 && window.buckets[window.maxima[(window.maximaStart + window.maximaCount - 1) % BucketCount] % BucketCount].maximum <= bucket.maximum) {
+			window.maximaCount--;
+		}
+
+		window.maxima[(window.maximaStart + window.maximaCount) % BucketCount] = index;
+		window.maximaCount++;
+	}
+
+	/// <summary>
+	/// Remove the buckets up to a number from a window
+	/// </summary>
+	/// <param name="window">The window</param>
+	/// <param name="last">The number of the newest bucket to remove</param>
+	void LevelHistory::Expire(Window &window, long long last) {
+		if (window.oldest < 0) {
+			return;
+		}
+
+		// Every bucket is removed once, so this is constant time per bucket
+		for (; window.oldest <= last && window.oldest <= window.newest; window.oldest++) {
+			Bucket &bucket = window.buckets[window.oldest % BucketCount];
+			if (bucket.index == window.oldest && bucket.count > 0) {
+				Accumulate(window, bucket, -1);
+				bucket = Bucket();
+				bucket.index = -1;
+			}
+		}
+
+		while (window.minimaCount > 0 && window.minima[window.minimaStart] <= last) {
+			window.minimaStart = (window.minimaStart + 1) % BucketCount;
+			window.minimaCount--;
+		}
+
+		while (window.maximaCount > 0 && window.maxima[window.maximaStart] <= last) {
+			window.maximaStart = (window.maximaStart + 1) % BucketCount;
+			window.maximaCount--;
+		}
+	}
+
+	/// <summary>
+	/// Add or subtract the sums of a bucket to the totals of a window
+	/// </summary>
+	/// <param name="window">The window</param>
+	/// <param name="bucket">The bucket</param>
+	/// <param name="sign">1 to add the bucket, -1 to subtract it</param>
+	void LevelHistory::Accumulate(Window &window, const Bucket &bucket, double sign) {
+		// Move the times of the bucket from its own start to the anchor of the window
+		double shift = (double)((bucket.index * window.bucketDuration) - window.anchor) / 1e6;
+		window.total.count += (int)sign * bucket.count;
+		window.total.sumLevel += sign * bucket.sumLevel;
+		window.total.sumTime += sign * (bucket.sumTime + (bucket.count * shift));
+		window.total.sumTimeSquared += sign * (bucket.sumTimeSquared + (2 * shift * bucket.sumTime) + (bucket.count * shift * shift));
+		window.total.sumTimeLevel += sign * (bucket.sumTimeLevel + (shift * bucket.sumLevel));
+	}
+
+	/// <summary>
+	/// Sum the totals of a window from its buckets again, measuring the times from the start of its oldest bucket
+	/// </summary>
+	/// <param name="window">The window</param>
+	void LevelHistory::Rebuild(Window &window) {
+		window.anchor = window.oldest * window.bucketDuration;
+		window.rebuild = window.newest + BucketCount;
+		window.total = Bucket();
+		for (long long index = window.oldest; index <= window.newest; index++) {
+			const Bucket &bucket = window.buckets[index % BucketCount];
+			if (bucket.index == index && bucket.count > 0) {
+				Accumulate(window, bucket, 1);
+			}
+		}
+	}
+}
+
+using namespace waterleveltracking;
+
+/// <summary>
+/// Create a history which keeps the recent levels of a single marker and their statistics in memory which is allocated once
+/// </summary>
+/// <param name="capacity">The amount of samples the history holds</param>
+/// <param name="profileRows">The amount of rows a row profile is resampled to before it is stored, 0 to store no row profiles</param>
+/// <param name="windows">The length of every window in microseconds, NULL for windows of a minute, an hour and a day</param>
+/// <param name="windowCount">The amount of windows, at most 4</param>
+/// <returns>The history, NULL if the input is wrong</returns>
+void *WltCreateLevelHistory(int capacity, int profileRows, const long long *windows, int windowCount) {
+	if (capacity <= 0 || profileRows < 0) {
+		return NULL;
+	}
+
+	if (windows == NULL) {
+		return new LevelHistory(capacity, profileRows);
+	}
+
+	if (windowCount < 0 || windowCount > LevelHistory::MaxWindowCount) {
+		return NULL;
+	}
+
+	for (int i = 0; i < windowCount; i++) {
+		if (windows[i] <= 0) {
+			return NULL;
+		}
+	}
+
+	return new LevelHistory(capacity, profileRows, windows, windowCount);
+}
+
+/// <summary>
+/// Destroy a history created by WltCreateLevelHistory
+/// </summary>
+/// <param name="history">The history, may be NULL</param>
+void WltDestroyLevelHistory(void *history) {
+	delete static_cast<LevelHistory*>(history);
+}
+
+/// <summary>
+/// Add the level of a frame to a history, without a row profile
+/// </summary>
+/// <param name="history">The history</param>
+/// <param name="timestamp">The timestamp of the frame in microseconds, not negative and not earlier than that of the previous sample</param>
+/// <param name="level">The height of the water in meters, ignored if the frame gave no level, kept as no level if it is not finite or beyond 2147483.647 meters up or down</param>
+/// <param name="status">The WltStatus of the frame, only a frame with WLT_STATUS_OK adds its level</param>
+/// <returns>1 on success, -1 if the input is wrong</returns>
+int WltAddLevel(void *history, long long timestamp, double level, int status) {
+	if (history == NULL || !static_cast<LevelHistory*>(history)->Add(timestamp, level, status == WLT_STATUS_OK)) {
+		return -1;
+	}
+
+	return 1;
+}
+
+/// <summary>
+/// Read the statistics of a window of a history
+/// </summary>
+/// <param name="history">The history</param>
+/// <param name="window">The index of the window</param>
+/// <param name="statistics">Receives the statistics of the window</param>
+/// <returns>1 on success, 0 if the window holds no level, -1 if the input is wrong</returns>
+int WltGetLevelStatistics(void *history, int window, WltLevelStatistics *statistics) {
+	if (history == NULL || statistics == NULL || !static_cast<LevelHistory*>(history)->GetStatistics(window, *statistics)) {
+		return -1;
+	}
+
+	return statistics->count > 0 ? 1 : 0;
+}
+
+/// <summary>
+/// Read the newest samples of a history, from old to new
+/// </summary>
+/// <param name="history">The history</param>
+/// <param name="timestamps">Receives the timestamp of every sample in microseconds</param>
+/// <param name="levels">Receives the level of every sample in meters, NULL for frames which gave no level</param>
+/// <param name="valid">Receives 1 for every sample with a level and 0 for the frames which gave no level, may be NULL</param>
+/// <param name="capacity">The amount of samples the arrays can hold</param>
+/// <returns>The amount of samples read, -1 if the input is wrong</returns>
+int WltGetLevelSamples(void *history, long long *timestamps, double *levels, int *valid, int capacity) {
+	if (history == NULL || timestamps == NULL || levels == NULL || capacity < 0) {
+		return -1;
+	}
+
+	LevelHistory &selected = *static_cast<LevelHistory*>(history);
+	int count = std::min(selected.GetCount(), capacity);
+	for (int i = 0; i < count; i++) {
+		bool sampled;
+		selected.GetSample(count - 1 - i, timestamps[i], levels[i], sampled);
+		if (valid != NULL) {
+			valid[i] = sampled ? 1 : 0;
+		}
+	}
+
+	return count;
+}
+
+/// <summary>
+/// Read the row profile of a sample of a history
+/// </summary>
+/// <param name="history">The history</param>
+/// <param name="age">0 for the newest sample, 1 for the one before it and so on</param>
+/// <param name="profile">Receives 255 for every row of a white stripe and 0 for every other row</param>
+/// <param name="capacity">The amount of rows the array can hold, at least the amount of profile rows of the history</param>
+/// <returns>The amount of rows read, 0 if the sample has no row profile, -1 if the input is wrong</returns>
+int WltGetLevelProfile(void *history, int age, unsigned char *profile, int capacity) {
+	if (history == NULL || profile == NULL || capacity < static_cast<LevelHistory*>(history)->GetProfileRows()) {
+		return -1;
+	}
+
+	return static_cast<LevelHistory*>(history)->GetProfile(age, profile);
+}
\ No newline at end of file
@@ -0,0 +1,116 @@
+// <copyright file="MappedFile.cpp" company="Delft University of Technology">
+// Copyright (c) Delft University of Technology. All rights reserved.
+// </copyright>
+
+#ifdef _WIN32
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+#include "../include/MappedFile.h"
+
+namespace waterleveltracking {
+	/// <summary>
+	/// Initializes a new instance of the <see cref="MappedFile"/> class.
+	/// </summary>
+	MappedFile::MappedFile() : data(nullptr), size(0), mapping(0) {
+	}
+
+	/// <summary>
+	/// Unmaps the file.
+	/// </summary>
+	MappedFile::~MappedFile() {
+		this->Close();
+	}
+
+	/// <summary>
+	/// Map a file, the file is expected to be read mostly in order
+	/// </summary>
+	/// <param name="path">The path of the file</param>
+	/// <returns>False if the file cannot be mapped or is empty</returns>
+	bool MappedFile::Open(const std::string &path) {
+		this->Close();
+#ifdef _WIN32
+		HANDLE file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, NULL);
+		if (file == INVALID_HANDLE_VALUE) {
+			return false;
+		}
+
+		LARGE_INTEGER fileSize;
+		HANDLE mapping = GetFileSizeEx(file, &fileSize) && fileSize.QuadPart > 0 ? CreateFileMappingA(file, NULL, PAGE_READONLY, 0, 0, NULL) : NULL;
+		CloseHandle(file);
+		if (mapping == NULL) {
+			return false;
+		}
+
+		this->data = (const uint8_t*)MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+		if (this->data == nullptr) {
+			CloseHandle(mapping);
+			return false;
+		}
+
+		this->size = (uint64_t)fileSize.QuadPart;
+		this->mapping = (intptr_t)mapping;
+#else
+		int descriptor = open(path.c_str(), O_RDONLY);
+		struct stat status;
+		if (descriptor < 0 || fstat(descriptor, &status) != 0 || status.st_size <= 0) {
+			if (descriptor >= 0) {
+				close(descriptor);
+			}
+
+			return false;
+		}
+
+		void *mapped = mmap(nullptr, (size_t)status.st_size, PROT_READ, MAP_PRIVATE, descriptor, 0);
+		if (mapped == MAP_FAILED) {
+			close(descriptor);
+			return false;
+		}
+
+		// The file is mostly read in order, so the kernel can read ahead
+		madvise(mapped, (size_t)status.st_size, MADV_SEQUENTIAL);
+		this->data = (const uint8_t*)mapped;
+		this->size = (uint64_t)status.st_size;
+		this->mapping = descriptor;
+#endif
+		return true;
+	}
+
+	/// <summary>
+	/// Unmap the file, the bytes become invalid
+	/// </summary>
+	void MappedFile::Close() {
+		if (this->data != nullptr) {
+#ifdef _WIN32
+			UnmapViewOfFile(this->data);
+			CloseHandle((HANDLE)this->mapping);
+#else
+			munmap((void*)this->data, this->size);
+			close((int)this->mapping);
+#endif
+		}
+
+		this->data = nullptr;
+		this->size = 0;
+		this->mapping = 0;
+	}
+
+	/// <summary>
+	/// Gets the first byte of the file, nullptr if no file is mapped
+	/// </summary>
+	const uint8_t *MappedFile::GetData() {
+		return this->data;
+	}
+
+	/// <summary>
+	/// Gets the size of the file in bytes
+	/// </summary>
+	uint64_t MappedFile::GetSize() {
+		return this->size;
+	}
+}
\ No newline at end of file
@@ -11,14 +11,35 @@ namespace waterleveltracking {
 	/// <param name="markerCornerPixelLocations">Array of size 8 with the 4 x and y pixel positions of the edges in the camera feed [bottom left x, bottom left y, bottom right x, bottom right y, top right x, top right y, top left x, top left y]</param>
 	/// <param name="distanceToStripes">The distance in meters from the center of the marker to the first stripe</param>
 	/// <param name="markerHeight">The height of the center of the marker in meters</param>
-	MarkerProperties::MarkerProperties(int corners[], double markerSize, double distanceToStripes, double markerHeight)
+	MarkerProperties::MarkerProperties(const int corners[], double markerSize, double distanceToStripes, double markerHeight)
 	{
 		this->GetMarkerCenter(corners);
 		this->GetMarkerCorners(corners);
 		this->distanceToStripes = distanceToStripes;
 		this->markerHeight = markerHeight;
 		this->markerSize = markerSize;
-		this->meterToPixelFactor = sqrt(pow(corners[1] - corners[7], 2) + pow(corners[0] - corners[6], 2)) / markerSize;
+		int dx = corners[0] - corners[6];
+		int dy = corners[1] - corners[7];
+		this->meterToPixelFactor = sqrt((double)((dx * dx) + (dy * dy))) / markerSize;
+	}
+
+	/// <summary>
+	/// Initializes a new instance of the <see cref="MarkerProperties"/> class with a center and meter to pixel factor which were calculated before.
+	/// </summary>
+	/// <param name="corners">Array of size 8 with the 4 x and y pixel positions of the edges in the camera feed [bottom left x, bottom left y, bottom right x, bottom right y, top right x, top right y, top left x, top left y]</param>
+	/// <param name="center">The center of the marker in pixels</param>
+	/// <param name="meterToPixelFactor">The factor to convert a meter to a pixel</param>
+	/// <param name="markerSize">The size of the marker in meters</param>
+	/// <param name="distanceToStripes">The distance in meters from the center of the marker to the first stripe</param>
+	/// <param name="markerHeight">The height of the center of the marker in meters</param>
+	MarkerProperties::MarkerProperties(const int corners[], Point center, double meterToPixelFactor, double markerSize, double distanceToStripes, double markerHeight)
+	{
+		this->GetMarkerCorners(corners);
+		this->center = center;
+		this->meterToPixelFactor = meterToPixelFactor;
+		this->distanceToStripes = distanceToStripes;
+		this->markerHeight = markerHeight;
+		this->markerSize = markerSize;
 	}
 
 	/// <summary>
@@ -33,7 +54,7 @@ namespace waterleveltracking {
 	/// <summary>
 	/// Gets the corners
 	/// </summary>
-	Square MarkerProperties::GetCorners() {
+	Square MarkerProperties::GetCorners() const {
 		return this->corners;
 	}
 
@@ -47,7 +68,7 @@ namespace waterleveltracking {
 	/// <summary>
 	/// Gets the marker size
 	/// </summary>
-	double MarkerProperties::GetMarkerSize() {
+	double MarkerProperties::GetMarkerSize() const {
 		return this->markerSize;
 	}
 
@@ -61,7 +82,7 @@ namespace waterleveltracking {
 	/// <summary>
 	/// Gets the meter to pixel factor
 	/// </summary>
-	double MarkerProperties::GetMeterToPixelFactor() {
+	double MarkerProperties::GetMeterToPixelFactor() const {
 		return this->meterToPixelFactor;
 	}
 
@@ -75,7 +96,7 @@ namespace waterleveltracking {
 	/// <summary>
 	/// Gets the marker height
 	/// </summary>
-	double MarkerProperties::GetMarkerHeight() {
+	double MarkerProperties::GetMarkerHeight() const {
 		return this->markerHeight;
 	}
 
@@ -89,7 +110,7 @@ namespace waterleveltracking {
 	/// <summary>
 	/// Gets the distance to stripes
 	/// </summary>
-	double MarkerProperties::GetDistanceToStripes() {
+	double MarkerProperties::GetDistanceToStripes() const {
 		return this->distanceToStripes;
 	}
 
@@ -103,7 +124,7 @@ namespace waterleveltracking {
 	/// <summary>
 	/// Gets the center
 	/// </summary>
-	cv::Point MarkerProperties::GetCenter() {
+	cv::Point MarkerProperties::GetCenter() const {
 		return this->center;
 	}
 
@@ -118,7 +139,7 @@ namespace waterleveltracking {
 	/// Calculate the center of the marker
 	/// </summary>
 	/// <param name="markerCornerPixelLocations">Array of size 8 with the 4 x and y pixel positions of the edges in the camera feed [bottom left x, bottom left y, bottom right x, bottom right y, top right x, top right y, top left x, top left y]</param>
-	void MarkerProperties::GetMarkerCenter(int markerCornerPixelLocations[])
+	void MarkerProperties::GetMarkerCenter(const int markerCornerPixelLocations[])
 	{
 		this->center = Point((markerCornerPixelLocations[0] + markerCornerPixelLocations[2] + markerCornerPixelLocations[4] + markerCornerPixelLocations[6]) / 4,
 			(markerCornerPixelLocations[1] + markerCornerPixelLocations[3] + markerCornerPixelLocations[5] + markerCornerPixelLocations[7]) / 4);
@@ -128,7 +149,7 @@ namespace waterleveltracking {
 	/// Calculate the corners of the marker
 	/// </summary>
 	/// <param name="markerCornerPixelLocations">Array of size 8 with the 4 x and y pixel positions of the edges in the camera feed [bottom left x, bottom left y, bottom right x, bottom right y, top right x, top right y, top left x, top left y]</param>
-	void MarkerProperties::GetMarkerCorners(int corners[])
+	void MarkerProperties::GetMarkerCorners(const int corners[])
 	{
 		Square square;
 		square.bottomLeft = Point(corners[0], corners[1]);
@@ -0,0 +1,251 @@
+// <copyright file="MarkerRegistry.cpp" company="Delft University of Technology">
+// Copyright (c) Delft University of Technology. All rights reserved.
+// </copyright>
+
+#include "../include/MarkerRegistry.h"
+
+namespace waterleveltracking {
+	/// <summary>
+	/// Register a marker, or replace the configuration of a marker which was registered before
+	/// </summary>
+	/// <param name="id">The id of the marker</param>
+	/// <param name="markerSize">The size of the marker in meters</param>
+	/// <param name="distanceToStripes">The distance in meters from the center of the marker to the first stripe</param>
+	/// <param name="markerHeight">The height of the center of the marker in meters</param>
+	/// <param name="stripeHeight">The height of individual stripes in meters</param>
+	/// <param name="stripeCount">The amount of stripes located under the marker</param>
+	/// <returns>The slot of the marker, -1 if the configuration is wrong</returns>
+	int MarkerRegistry::Register(int id, double markerSize, double distanceToStripes, double markerHeight, double stripeHeight, int stripeCount) {
+		if (markerSize <= 0 || stripeCount <= 0) {
+			return -1;
+		}
+
+		int slot = this->Find(id);
+		if (slot < 0) {
+			slot = (int)this->ids.size();
+			this->slots[id] = slot;
+			this->ids.push_back(id);
+			this->markerSizes.push_back(markerSize);
+			this->distancesToStripes.push_back(distanceToStripes);
+			this->markerHeights.push_back(markerHeight);
+			this->stripeHeights.push_back(stripeHeight);
+			this->stripeCounts.push_back(stripeCount);
+			this->corners.resize(this->corners.size() + 8, 0);
+			this->centers.push_back(Point());
+			this->meterToPixelFactors.push_back(0);
+			this->located.push_back(0);
+			this->calibrations.resize(this->calibrations.size() + CalibrationLevels);
+			this->motionGates.push_back(MotionGate());
+			this->governors.push_back(LatencyGovernor());
+			this->states.push_back(TrackingState());
+			this->results.push_back(WltTrackingResult());
+			this->ResetState(slot);
+			return slot;
+		}
+
+		this->markerSizes[slot] = markerSize;
+		this->distancesToStripes[slot] = distanceToStripes;
+		this->markerHeights[slot] = markerHeight;
+		this->stripeHeights[slot] = stripeHeight;
+		this->stripeCounts[slot] = stripeCount;
+
+		// The tracked state belongs to the old configuration
+		this->ResetState(slot);
+		if (this->located[slot]) {
+			this->Locate(slot);
+		}
+
+		return slot;
+	}
+
+	/// <summary>
+	/// Find the slot of a marker
+	/// </summary>
+	/// <param name="id">The id of the marker</param>
+	/// <returns>The slot of the marker, -1 if it is not registered</returns>
+	int MarkerRegistry::Find(int id) const {
+		std::unordered_map<int, int>::const_iterator slot = this->slots.find(id);
+		return slot == this->slots.end() ? -1 : slot->second;
+	}
+
+	/// <summary>
+	/// Update the corners of a marker in the current frame
+	/// </summary>
+	/// <param name="slot">The slot of the marker</param>
+	/// <param name="corners">Array of size 8 with the 4 x and y pixel positions of the edges in the camera feed [bottom left x, bottom left y, bottom right x, bottom right y, top right x, top right y, top left x, top left y]</param>
+	/// <returns>False if the slot does not exist</returns>
+	bool MarkerRegistry::UpdateCorners(int slot, const int corners[]) {
+		if (!this->IsSlot(slot) || corners == NULL) {
+			return false;
+		}
+
+		std::copy(corners, corners + 8, this->corners.begin() + (slot * 8));
+		this->Locate(slot);
+		this->located[slot] = 1;
+		return true;
+	}
+
+	/// <summary>
+	/// Forget the corners of a marker, for instance when it is no longer detected
+	/// </summary>
+	/// <param name="slot">The slot of the marker</param>
+	void MarkerRegistry::ClearCorners(int slot) {
+		if (this->IsSlot(slot)) {
+			this->located[slot] = 0;
+		}
+	}
+
+	/// <summary>
+	/// Gets whether the corners of a marker are known
+	/// </summary>
+	/// <param name="slot">The slot of the marker</param>
+	bool MarkerRegistry::HasCorners(int slot) const {
+		return this->IsSlot(slot) && this->located[slot] != 0;
+	}
+
+	/// <summary>
+	/// Gets the properties of a marker with its current corners, the slot must have corners
+	/// </summary>
+	/// <param name="slot">The slot of the marker</param>
+	/// <returns>The properties of the marker</returns>
+	MarkerProperties MarkerRegistry::GetMarkerProperties(int slot) const {
+		return MarkerProperties(&this->corners[slot * 8], this->centers[slot], this->meterToPixelFactors[slot], this->markerSizes[slot], this->distancesToStripes[slot], this->markerHeights[slot]);
+	}
+
+	/// <summary>
+	/// Gets the properties of the stripes underneath a marker
+	/// </summary>
+	/// <param name="slot">The slot of the marker</param>
+	/// <param name="markerProperties">The properties of the marker with its current corners</param>
+	/// <returns>The properties of the stripes</returns>
+	StripeProperties MarkerRegistry::GetStripeProperties(int slot, const MarkerProperties &markerProperties) const {
+		return StripeProperties(markerProperties, this->stripeHeights[slot], this->stripeCounts[slot]);
+	}
+
+	/// <summary>
+	/// Predict the height of the water level at a marker with its current corners.
+	/// Return NULL if the the water level cannot be derived from the information or the corners are unknown
+	/// Return -1 if the slot does not exist
+	/// </summary>
+	/// <param name="tracker">The tracker the marker is tracked with, the state of the marker is kept by the registry</param>
+	/// <param name="slot">The slot of the marker</param>
+	/// <param name="frame">The captured frame of the video feed</param>
+	/// <param name="rotation">Angle in degrees of the rotation of the marker</param>
+	/// <returns>The height of the water in meters</returns>
+	double MarkerRegistry::Track(WaterLevelTracker &tracker, int slot, const Mat &frame, double rotation) {
+		if (!this->IsSlot(slot)) {
+			return -1;
+		}
+
+		if (!this->located[slot]) {
+			return 0.0;
+		}
+
+		// The state of the marker is lent to the tracker for this frame and handed back afterwards, the state of the tracker is restored
+		MarkerProperties markerProperties = this->GetMarkerProperties(slot);
+		StripeProperties stripeProperties = this->GetStripeProperties(slot, markerProperties);
+		RegionCalibration *calibrations = &this->calibrations[slot * CalibrationLevels];
+		tracker.SwapMarkerState(calibrations, this->motionGates[slot], this->governors[slot]);
+		double level = tracker.Track(frame, markerProperties, stripeProperties, rotation, this->states[slot]);
+		tracker.SwapMarkerState(calibrations, this->motionGates[slot], this->governors[slot]);
+		this->results[slot] = tracker.GetLastResult();
+		return level;
+	}
+
+	/// <summary>
+	/// Predict the height of the water level at every marker
+	/// </summary>
+	/// <param name="tracker">The tracker the markers are tracked with, the state of every marker is kept by the registry</param>
+	/// <param name="frame">The captured frame of the video feed</param>
+	/// <param name="rotation">Angle in degrees of the rotation of the markers</param>
+	/// <param name="levels">Receives the level of every slot, NULL for the markers which gave no level</param>
+	/// <param name="statuses">Receives the WltStatus of every slot, may be NULL</param>
+	/// <returns>The amount of markers which were tracked</returns>
+	int MarkerRegistry::TrackAll(WaterLevelTracker &tracker, const Mat &frame, double rotation, double levels[], int statuses[]) {
+		int tracked = 0;
+		for (int slot = 0; slot < (int)this->ids.size(); slot++) {
+			levels[slot] = this->Track(tracker, slot, frame, rotation);
+			if (statuses != NULL) {
+				statuses[slot] = this->GetResult(slot).status;
+			}
+
+			if (this->located[slot]) {
+				tracked++;
+			}
+		}
+
+		return tracked;
+	}
+
+	/// <summary>
+	/// Gets the result of the last frame of a marker, WLT_STATUS_MARKER_NOT_FOUND while its corners are unknown
+	/// </summary>
+	/// <param name="slot">The slot of the marker</param>
+	WltTrackingResult MarkerRegistry::GetResult(int slot) {
+		if (!this->HasCorners(slot)) {
+			WltTrackingResult missing = { this->IsSlot(slot) ? WLT_STATUS_MARKER_NOT_FOUND : WLT_STATUS_INVALID_INPUT, 0, 0, 0 };
+			return missing;
+		}
+
+		return this->results[slot];
+	}
+
+	/// <summary>
+	/// Gets the amount of frames of a marker which returned the level of its last processed frame, because its stripe region did
+	/// not change or the latency budget skipped them
+	/// </summary>
+	/// <param name="slot">The slot of the marker</param>
+	long long MarkerRegistry::GetSkippedCount(int slot) {
+		return this->IsSlot(slot) ? this->motionGates[slot].GetSkippedCount() + this->governors[slot].GetSkippedCount() : 0;
+	}
+
+	/// <summary>
+	/// Gets the amount of registered markers
+	/// </summary>
+	int MarkerRegistry::GetCount() const {
+		return (int)this->ids.size();
+	}
+
+	/// <summary>
+	/// Gets the id of the marker in a slot
+	/// </summary>
+	/// <param name="slot">The slot of the marker</param>
+	int MarkerRegistry::GetId(int slot) const {
+		return this->IsSlot(slot) ? this->ids[slot] : -1;
+	}
+
+	/// <summary>
+	/// Check whether a slot exists
+	/// </summary>
+	/// <param name="slot">The slot of the marker</param>
+	/// <returns>True if the slot exists</returns>
+	bool MarkerRegistry::IsSlot(int slot) const {
+		return slot >= 0 && slot < (int)this->ids.size();
+	}
+
+	/// <summary>
+	/// Calculate the center and the meter to pixel factor of a marker from its stored corners
+	/// </summary>
+	/// <param name="slot">The slot of the marker</param>
+	void MarkerRegistry::Locate(int slot) {
+		// The same center and factor the constructor of MarkerProperties calculates, once per update instead of once per use
+		const int *stored = &this->corners[slot * 8];
+		this->centers[slot] = Point((stored[0] + stored[2] + stored[4] + stored[6]) / 4, (stored[1] + stored[3] + stored[5] + stored[7]) / 4);
+		int dx = stored[0] - stored[6];
+		int dy = stored[1] - stored[7];
+		this->meterToPixelFactors[slot] = sqrt((double)((dx * dx) + (dy * dy))) / this->markerSizes[slot];
+	}
+
+	/// <summary>
+	/// Forget the tracked state of a marker
+	/// </summary>
+	/// <param name="slot">The slot of the marker</param>
+	void MarkerRegistry::ResetState(int slot) {
+		std::fill(this->calibrations.begin() + (slot * CalibrationLevels), this->calibrations.begin() + ((slot + 1) * CalibrationLevels), RegionCalibration());
+		this->motionGates[slot] = MotionGate();
+		this->governors[slot] = LatencyGovernor();
+		this->states[slot].Reset();
+		WltTrackingResult unknown = { WLT_STATUS_INVALID_INPUT, 0, 0, 0 };
+		this->results[slot] = unknown;
+	}
+}
\ No newline at end of file
@@ -0,0 +1,154 @@
+// <copyright file="MotionGate.cpp" company="Delft University of Technology">
+// Copyright (c) Delft University of Technology. All rights reserved.
+// </copyright>
+
+#include "../include/MotionGate.h"
+
+namespace waterleveltracking {
+	/// <summary>
+	/// Initializes a new instance of the <see cref="MotionGate"/> class.
+	/// </summary>
+	/// <param name="threshold">The mean absolute difference per signature value above which the region changed</param>
+	/// <param name="forceInterval">The amount of frames after which a frame is processed even if nothing changed, 0 to never force</param>
+	/// <param name="regionTolerance">The amount of pixels the bounds of the stripe region may move while the region counts as the same</param>
+	MotionGate::MotionGate(double threshold, int forceInterval, int regionTolerance) {
+		this->threshold = threshold;
+		this->forceInterval = forceInterval;
+		this->regionTolerance = regionTolerance;
+		this->skippedCount = 0;
+		this->Reset();
+	}
+
+	/// <summary>
+	/// Compare the stripe region of the frame with the one of the last processed frame.
+	/// If the frame has to be processed its signature becomes the one to compare against.
+	/// </summary>
+	/// <param name="frame">The captured frame of the video feed</param>
+	/// <param name="region">The bounds of the stripe region in the frame</param>
+	/// <returns>True if the frame has to be processed, false if the stored level still holds</returns>
+	bool MotionGate::Check(const Mat &frame, Rect region) {
+		region &= Rect(0, 0, frame.cols, frame.rows);
+		if (region.area() == 0) {
+			this->hasProcessed = false;
+			return true;
+		}
+
+		// Averaging blocks of the region keeps the signature insensitive to sensor noise
+		cv::resize(frame(region), this->signature, Size(SignatureWidth, SignatureHeight), 0, 0, INTER_AREA);
+		bool process = !this->hasProcessed || !this->SameRegion(region, this->processedRegion) || this->signature.type() != this->processedSignature.type()
+			|| (this->forceInterval > 0 && this->framesSinceProcessed + 1 >= this->forceInterval);
+		if (!process) {
+			double difference = cv::norm(this->signature, this->processedSignature, NORM_L1) / (double)(this->signature.total() * this->signature.channels());
+			process = difference > this->threshold;
+		}
+
+		if (!process) {
+			this->framesSinceProcessed++;
+			this->skippedCount++;
+			return false;
+		}
+
+		std::swap(this->signature, this->processedSignature);
+		this->processedRegion = region;
+		this->hasProcessed = true;
+		this->framesSinceProcessed = 0;
+		return true;
+	}
+
+	/// <summary>
+	/// Store the result of the processed frame with the bounds of its stripe region, it is returned for the skipped frames of that region
+	/// </summary>
+	/// <param name="result">The result of the frame</param>
+	/// <param name="region">The bounds of the stripe region in the frame</param>
+	void MotionGate::Store(const WltTrackingResult &result, Rect region) {
+		this->result = result;
+		this->resultRegion = region;
+		this->hasResult = true;
+	}
+
+	/// <summary>
+	/// Gets whether the stored result belongs to a stripe region, a frame of another region has to be processed
+	/// </summary>
+	/// <param name="region">The bounds of the stripe region in the frame</param>
+	/// <returns>True if a result is stored for the region</returns>
+	bool MotionGate::Holds(Rect region) {
+		return this->hasResult && this->SameRegion(region, this->resultRegion);
+	}
+
+	/// <summary>
+	/// Forget the last processed frame, so the next frame is processed
+	/// </summary>
+	void MotionGate::Reset() {
+		this->hasProcessed = false;
+		this->result = WltTrackingResult();
+		this->hasResult = false;
+		this->framesSinceProcessed = 0;
+	}
+
+	/// <summary>
+	/// Gets the result of the last processed frame
+	/// </summary>
+	WltTrackingResult MotionGate::GetResult() {
+		return this->result;
+	}
+
+	/// <summary>
+	/// Gets the threshold
+	/// </summary>
+	double MotionGate::GetThreshold() {
+		return this->threshold;
+	}
+
+	/// <summary>
+	/// Sets the threshold
+	/// </summary>
+	void MotionGate::SetThreshold(double threshold) {
+		this->threshold = threshold;
+	}
+
+	/// <summary>
+	/// Gets the force interval
+	/// </summary>
+	int MotionGate::GetForceInterval() {
+		return this->forceInterval;
+	}
+
+	/// <summary>
+	/// Sets the force interval
+	/// </summary>
+	void MotionGate::SetForceInterval(int forceInterval) {
+		this->forceInterval = forceInterval;
+	}
+
+	/// <summary>
+	/// Gets the region tolerance
+	/// </summary>
+	int MotionGate::GetRegionTolerance() {
+		return this->regionTolerance;
+	}
+
+	/// <summary>
+	/// Sets the region tolerance
+	/// </summary>
+	void MotionGate::SetRegionTolerance(int regionTolerance) {
+		this->regionTolerance = regionTolerance;
+	}
+
+	/// <summary>
+	/// Gets the amount of frames which were skipped
+	/// </summary>
+	long long MotionGate::GetSkippedCount() {
+		return this->skippedCount;
+	}
+
+	/// <summary>
+	/// Check whether the bounds of a stripe region lie within the tolerance of the ones of a processed frame
+	/// </summary>
+	/// <param name="region">The bounds of the stripe region in the frame</param>
+	/// <param name="processed">The bounds of the stripe region of the processed frame</param>
+	/// <returns>True if the region counts as the same</returns>
+	bool MotionGate::SameRegion(Rect region, Rect processed) {
+		return abs(region.x - processed.x) <= this->regionTolerance && abs(region.y - processed.y) <= this->regionTolerance
+			&& abs(region.br().x - processed.br().x) <= this->regionTolerance && abs(region.br().y - processed.br().y) <= this->regionTolerance;
+	}
+}
\ No newline at end of file
@@ -0,0 +1,364 @@
+// <copyright file="NativeApi.cpp" company="Delft University of Technology">
+// Copyright (c) Delft University of Technology. All rights reserved.
+// </copyright>
+
+#include "../include/NativeApi.h"
+#include "../include/JpegRegionDecoder.h"
+#include "../include/LevelHistory.h"
+#include "../include/MarkerRegistry.h"
+#include "../include/WaterLevelTracker.h"
+
+using namespace waterleveltracking;
+
+/// <summary>
+/// Wrap a pixel buffer of the caller in a frame without copying it
+/// </summary>
+/// <param name="pixels">The first pixel of the frame</param>
+/// <param name="width">The width of the frame in pixels</param>
+/// <param name="height">The height of the frame in pixels</param>
+/// <param name="stride">The amount of bytes between the starts of two rows</param>
+/// <param name="pixelFormat">The layout of the buffer</param>
+/// <param name="frame">Receives the frame, which shares the buffer</param>
+/// <param name="channelOrder">Receives the order of the color channels of the frame</param>
+/// <returns>False if the buffer description is wrong</returns>
+static bool WrapFrame(const unsigned char *pixels, int width, int height, int stride, int pixelFormat, Mat &frame, ChannelOrder &channelOrder) {
+	int type;
+	int pixelSize;
+	channelOrder = ChannelOrder::Rgb;
+	switch (pixelFormat) {
+	case WLT_PIXEL_FORMAT_RGBA32:
+		type = CV_8UC4;
+		pixelSize = 4;
+		break;
+	case WLT_PIXEL_FORMAT_BGRA32:
+		type = CV_8UC4;
+		pixelSize = 4;
+		channelOrder = ChannelOrder::Bgr;
+		break;
+	case WLT_PIXEL_FORMAT_RGB24:
+		type = CV_8UC3;
+		pixelSize = 3;
+		break;
+	case WLT_PIXEL_FORMAT_GRAY8:
+	case WLT_PIXEL_FORMAT_NV12:
+	case WLT_PIXEL_FORMAT_I420:
+		// The Y plane comes first and already is the grayscale frame
+		type = CV_8UC1;
+		pixelSize = 1;
+		break;
+	default:
+		return false;
+	}
+
+	if (pixels == NULL || width <= 0 || height <= 0 || stride < width * pixelSize) {
+		return false;
+	}
+
+	// The tracker takes the frame as const and never writes to it, so the const of the buffer can be dropped
+	frame = Mat(height, width, type, const_cast<unsigned char*>(pixels), (size_t)stride);
+	return true;
+}
+
+/// <summary>
+/// Gets the tracker a call should use
+/// </summary>
+/// <param name="tracker">The tracker of the caller, NULL to use a tracker of the calling thread</param>
+/// <returns>The tracker</returns>
+static WaterLevelTracker &SelectTracker(void *tracker) {
+	thread_local WaterLevelTracker threadTracker;
+	return tracker != NULL ? *static_cast<WaterLevelTracker*>(tracker) : threadTracker;
+}
+
+/// <summary>
+/// Gets the tracker a call should use and make it read the channel order of the frame
+/// </summary>
+/// <param name="tracker">The tracker of the caller, NULL to use a tracker of the calling thread</param>
+/// <param name="channelOrder">The order of the color channels of the frame</param>
+/// <returns>The tracker</returns>
+static WaterLevelTracker &SelectTracker(void *tracker, ChannelOrder channelOrder) {
+	WaterLevelTracker &selected = SelectTracker(tracker);
+	TrackerOptions options = selected.GetOptions();
+	if (options.channelOrder != channelOrder) {
+		options.channelOrder = channelOrder;
+		selected.SetOptions(options);
+	}
+
+	return selected;
+}
+
+/// <summary>
+/// Create a tracker which keeps its scratch buffers between frames
+/// </summary>
+/// <param name="regionMode">The index of the region mode in the RegionMode enum</param>
+/// <param name="profileMode">The index of the profile mode in the ProfileMode enum</param>
+/// <returns>The tracker, NULL if a mode does not exist</returns>
+void *WltCreateTracker(int regionMode, int profileMode) {
+	if (regionMode < (int)RegionMode::FullFrame || regionMode > (int)RegionMode::FixedCamera
+		|| profileMode < (int)ProfileMode::Region || profileMode > (int)ProfileMode::BandVote) {
+		return NULL;
+	}
+
+	TrackerOptions options;
+	options.regionMode = (RegionMode)regionMode;
+	options.profileMode = (ProfileMode)profileMode;
+	return new WaterLevelTracker(options);
+}
+
+/// <summary>
+/// Destroy a tracker created by WltCreateTracker
+/// </summary>
+/// <param name="tracker">The tracker, may be NULL</param>
+void WltDestroyTracker(void *tracker) {
+	delete static_cast<WaterLevelTracker*>(tracker);
+}
+
+/// <summary>
+/// Set the time in seconds processing a frame may cost. While the measured cost exceeds it the tracker processes coarser,
+/// with a smaller blur, fewer bands, a lower resolution and finally skipped frames, and it returns to full quality once the cost allows
+/// </summary>
+/// <param name="tracker">The tracker, NULL to use the tracker of the calling thread</param>
+/// <param name="budget">The budget in seconds, 0 to always process frames as configured</param>
+/// <returns>1 on success, -1 if the budget is negative</returns>
+int WltSetLatencyBudget(void *tracker, double budget) {
+	if (budget < 0) {
+		return -1;
+	}
+
+	WaterLevelTracker &selected = SelectTracker(tracker);
+	TrackerOptions options = selected.GetOptions();
+	options.latencyBudget = budget;
+	selected.SetOptions(options);
+	return 1;
+}
+
+/// <summary>
+/// Gets the quality level the latency budget currently allows
+/// </summary>
+/// <param name="tracker">The tracker, NULL to use the tracker of the calling thread</param>
+/// <returns>0 when frames are processed as configured, up to 4 when only every fourth frame is processed at the coarsest settings</returns>
+int WltGetQualityLevel(void *tracker) {
+	return SelectTracker(tracker).GetQualityLevel();
+}
+
+/// <summary>
+/// Predict the height of the water level from a pixel buffer of the caller. The buffer is wrapped without copying and
+/// is never modified; YUV buffers are read through their Y plane, so they need no color conversion.
+/// Return NULL if the the water level cannot be derived from the information, -1 if the input is wrong
+/// </summary>
+/// <param name="tracker">The tracker, NULL to use a tracker of the calling thread</param>
+/// <param name="pixels">The first pixel of the frame</param>
+/// <param name="width">The width of the frame in pixels</param>
+/// <param name="height">The height of the frame in pixels</param>
+/// <param name="stride">The amount of bytes between the starts of two rows, of the Y plane for YUV buffers</param>
+/// <param name="pixelFormat">The layout of the buffer, a WltPixelFormat</param>
+/// <param name="corners">The pixel locations of the marker corners in the order bottom left, bottom right, top right, top left</param>
+/// <param name="markerSize">The size of the marker in meters</param>
+/// <param name="distanceToStripes">The distance from the center of the marker to the highest stripe in meters</param>
+/// <param name="markerHeight">The height of the center of the marker in meters</param>
+/// <param name="stripeHeight">The height of a stripe in meters</param>
+/// <param name="stripeCount">The amount of stripes underneath the marker</param>
+/// <param name="rotation">Angle in degrees of the rotation of the marker</param>
+/// <returns>The height of the water in meters</returns>
+double WltCalculateWaterLevel(void *tracker, const unsigned char *pixels, int width, int height, int stride, int pixelFormat,
+	const int corners[8], double markerSize, double distanceToStripes, double markerHeight, double stripeHeight, int stripeCount, double rotation) {
+	Mat frame;
+	ChannelOrder channelOrder;
+	if (corners == NULL || markerSize <= 0 || stripeCount <= 0 || !WrapFrame(pixels, width, height, stride, pixelFormat, frame, channelOrder)) {
+		return -1;
+	}
+
+	MarkerProperties markerProperties(corners, markerSize, distanceToStripes, markerHeight);
+	StripeProperties stripeProperties(markerProperties, stripeHeight, stripeCount);
+	return SelectTracker(tracker, channelOrder).Track(frame, markerProperties, stripeProperties, rotation);
+}
+
+/// <summary>
+/// Predict the height of the water level from a pixel buffer of the caller and tell why the frame did or did not give one.
+/// The stripe region is validated from the corners before any pixel is touched, and nothing is thrown
+/// </summary>
+/// <param name="tracker">The tracker, NULL to use a tracker of the calling thread</param>
+/// <param name="pixels">The first pixel of the frame</param>
+/// <param name="width">The width of the frame in pixels</param>
+/// <param name="height">The height of the frame in pixels</param>
+/// <param name="stride">The amount of bytes between the starts of two rows, of the Y plane for YUV buffers</param>
+/// <param name="pixelFormat">The layout of the buffer, a WltPixelFormat</param>
+/// <param name="corners">The pixel locations of the marker corners in the order bottom left, bottom right, top right, top left</param>
+/// <param name="markerSize">The size of the marker in meters</param>
+/// <param name="distanceToStripes">The distance from the center of the marker to the highest stripe in meters</param>
+/// <param name="markerHeight">The height of the center of the marker in meters</param>
+/// <param name="stripeHeight">The height of a stripe in meters</param>
+/// <param name="stripeCount">The amount of stripes underneath the marker</param>
+/// <param name="rotation">Angle in degrees of the rotation of the marker</param>
+/// <param name="result">Receives the status, level, confidence and stripe count of the frame</param>
+/// <returns>The status of the frame, a WltStatus</returns>
+int WltMeasureWaterLevel(void *tracker, const unsigned char *pixels, int width, int height, int stride, int pixelFormat,
+	const int corners[8], double markerSize, double distanceToStripes, double markerHeight, double stripeHeight, int stripeCount, double rotation, WltTrackingResult *result) {
+	Mat frame;
+	ChannelOrder channelOrder;
+	if (result == NULL) {
+		return WLT_STATUS_INVALID_INPUT;
+	}
+
+	if (corners == NULL || markerSize <= 0 || stripeCount <= 0 || !WrapFrame(pixels, width, height, stride, pixelFormat, frame, channelOrder)) {
+		WltTrackingResult invalid = { WLT_STATUS_INVALID_INPUT, 0, 0, 0 };
+		*result = invalid;
+		return WLT_STATUS_INVALID_INPUT;
+	}
+
+	MarkerProperties markerProperties(corners, markerSize, distanceToStripes, markerHeight);
+	StripeProperties stripeProperties(markerProperties, stripeHeight, stripeCount);
+	*result = SelectTracker(tracker, channelOrder).Measure(frame, markerProperties, stripeProperties, rotation);
+	return result->status;
+}
+
+/// <summary>
+/// Predict the height of the water level from a JPEG image, for instance a frame of an MJPEG stream. Only the luma of the rows and
+/// MCU columns which hold the stripe region of the marker and a margin for the blur is decoded, the region is worked out from the corners before decoding.
+/// Return NULL if the the water level cannot be derived from the information, -1 if the input is wrong or the library is built without libjpeg-turbo
+/// </summary>
+/// <param name="tracker">The tracker, NULL to use a tracker of the calling thread</param>
+/// <param name="data">The compressed image</param>
+/// <param name="size">The size of the compressed image in bytes</param>
+/// <param name="corners">The pixel locations of the marker corners in the order bottom left, bottom right, top right, top left</param>
+/// <param name="markerSize">The size of the marker in meters</param>
+/// <param name="distanceToStripes">The distance from the center of the marker to the highest stripe in meters</param>
+/// <param name="markerHeight">The height of the center of the marker in meters</param>
+/// <param name="stripeHeight">The height of a stripe in meters</param>
+/// <param name="stripeCount">The amount of stripes underneath the marker</param>
+/// <param name="rotation">Angle in degrees of the rotation of the marker</param>
+/// <returns>The height of the water in meters</returns>
+double WltCalculateWaterLevelJpeg(void *tracker, const unsigned char *data, int size,
+	const int corners[8], double markerSize, double distanceToStripes, double markerHeight, double stripeHeight, int stripeCount, double rotation) {
+	thread_local JpegRegionDecoder decoder;
+	Size frameSize;
+	if (corners == NULL || markerSize <= 0 || stripeCount <= 0 || size <= 0 || !decoder.Open(data, (size_t)size, frameSize)) {
+		return -1;
+	}
+
+	// A region outside the frame decodes nothing, the tracker then rejects the frame from the corners alone
+	MarkerProperties markerProperties(corners, markerSize, distanceToStripes, markerHeight);
+	StripeProperties stripeProperties(markerProperties, stripeHeight, stripeCount);
+	WaterLevelTracker &selected = SelectTracker(tracker);
+	Rect bounds;
+	if (selected.Validate(frameSize, rotation, markerProperties, stripeProperties, bounds) == WLT_STATUS_OK) {
+		// The blur and the interpolation of the warp read pixels just outside the stripe region, the decoder clips the margin to the image
+		int margin = selected.GetOptions().blurSize / 2 + 1;
+		bounds = Rect(bounds.x - margin, bounds.y - margin, bounds.width + (2 * margin), bounds.height + (2 * margin));
+	}
+
+	Mat frame;
+	if (!decoder.Decode(bounds, frame)) {
+		return -1;
+	}
+
+	return selected.Track(frame, markerProperties, stripeProperties, rotation);
+}
+
+/// <summary>
+/// Gets whether the library is built with libjpeg-turbo
+/// </summary>
+/// <returns>1 if WltCalculateWaterLevelJpeg decodes images, 0 if it always returns -1</returns>
+int WltIsJpegDecodingEnabled() {
+	return JpegRegionDecoder::IsAvailable() ? 1 : 0;
+}
+
+/// <summary>
+/// Create a registry which holds the fixed configuration of the markers of a site
+/// </summary>
+/// <returns>The registry</returns>
+void *WltCreateMarkerRegistry() {
+	return new MarkerRegistry();
+}
+
+/// <summary>
+/// Destroy a registry created by WltCreateMarkerRegistry
+/// </summary>
+/// <param name="registry">The registry, may be NULL</param>
+void WltDestroyMarkerRegistry(void *registry) {
+	delete static_cast<MarkerRegistry*>(registry);
+}
+
+/// <summary>
+/// Register a marker once, or replace the configuration of a marker which was registered before
+/// </summary>
+/// <param name="registry">The registry</param>
+/// <param name="id">The id of the marker</param>
+/// <param name="markerSize">The size of the marker in meters</param>
+/// <param name="distanceToStripes">The distance from the center of the marker to the highest stripe in meters</param>
+/// <param name="markerHeight">The height of the center of the marker in meters</param>
+/// <param name="stripeHeight">The height of a stripe in meters</param>
+/// <param name="stripeCount">The amount of stripes underneath the marker</param>
+/// <returns>The slot of the marker, -1 if the input is wrong</returns>
+int WltRegisterMarker(void *registry, int id, double markerSize, double distanceToStripes, double markerHeight, double stripeHeight, int stripeCount) {
+	if (registry == NULL) {
+		return -1;
+	}
+
+	return static_cast<MarkerRegistry*>(registry)->Register(id, markerSize, distanceToStripes, markerHeight, stripeHeight, stripeCount);
+}
+
+/// <summary>
+/// Update the corners of a marker in the current frame, NULL corners mark the marker as not detected
+/// </summary>
+/// <param name="registry">The registry</param>
+/// <param name="slot">The slot of the marker</param>
+/// <param name="corners">The pixel locations of the marker corners in the order bottom left, bottom right, top right, top left</param>
+/// <returns>1 on success, -1 if the input is wrong</returns>
+int WltUpdateMarkerCorners(void *registry, int slot, const int corners[8]) {
+	MarkerRegistry *markers = static_cast<MarkerRegistry*>(registry);
+	if (markers == NULL || slot < 0 || slot >= markers->GetCount()) {
+		return -1;
+	}
+
+	if (corners == NULL) {
+		markers->ClearCorners(slot);
+		return 1;
+	}
+
+	return markers->UpdateCorners(slot, corners) ? 1 : -1;
+}
+
+/// <summary>
+/// Predict the height of the water level at every registered marker with known corners from a pixel buffer of the caller.
+/// The buffer is wrapped without copying like in WltCalculateWaterLevel. Every marker keeps its own tracking state in the registry
+/// </summary>
+/// <param name="registry">The registry</param>
+/// <param name="tracker">The tracker whose options the markers are tracked with, NULL to use a tracker of the calling thread</param>
+/// <param name="pixels">The first pixel of the frame</param>
+/// <param name="width">The width of the frame in pixels</param>
+/// <param name="height">The height of the frame in pixels</param>
+/// <param name="stride">The amount of bytes between the starts of two rows, of the Y plane for YUV buffers</param>
+/// <param name="pixelFormat">The layout of the buffer, a WltPixelFormat</param>
+/// <param name="rotation">Angle in degrees of the rotation of the markers</param>
+/// <param name="levels">Receives the level of every slot, NULL for the markers which gave no level</param>
+/// <param name="statuses">Receives the WltStatus of every slot, WLT_STATUS_MARKER_NOT_FOUND for the markers whose corners are unknown, may be NULL</param>
+/// <param name="capacity">The amount of levels and statuses the arrays can hold, at least the amount of registered markers</param>
+/// <returns>The amount of markers which were tracked, -1 if the input is wrong</returns>
+int WltTrackMarkers(void *registry, void *tracker, const unsigned char *pixels, int width, int height, int stride, int pixelFormat,
+	double rotation, double *levels, int *statuses, int capacity) {
+	MarkerRegistry *markers = static_cast<MarkerRegistry*>(registry);
+	Mat frame;
+	ChannelOrder channelOrder;
+	if (markers == NULL || levels == NULL || capacity < markers->GetCount() || !WrapFrame(pixels, width, height, stride, pixelFormat, frame, channelOrder)) {
+		return -1;
+	}
+
+	return markers->TrackAll(SelectTracker(tracker, channelOrder), frame, rotation, levels, statuses);
+}
+
+/// <summary>
+/// Add the result of the last frame a tracker processed to a history, with the row profile its stripes were counted from
+/// </summary>
+/// <param name="history">The history</param>
+/// <param name="tracker">The tracker, NULL to use the tracker of the calling thread</param>
+/// <param name="timestamp">The timestamp of the frame in microseconds, not negative and not earlier than that of the previous sample</param>
+/// <returns>1 on success, -1 if the input is wrong</returns>
+int WltAddTrackedLevel(void *history, void *tracker, long long timestamp) {
+	if (history == NULL) {
+		return -1;
+	}
+
+	WaterLevelTracker &selected = SelectTracker(tracker);
+	WltTrackingResult result = selected.GetLastResult();
+	return static_cast<LevelHistory*>(history)->Add(timestamp, result.level, result.status == WLT_STATUS_OK, selected.GetLastProfile()) ? 1 : -1;
+}
\ No newline at end of file
@@ -0,0 +1,199 @@
+// <copyright file="RowProfile.cpp" company="Delft University of Technology">
+// Copyright (c) Delft University of Technology. All rights reserved.
+// </copyright>
+
+#include "../include/RowProfile.h"
+
+namespace waterleveltracking {
+	/// <summary>
+	/// The smallest difference in intensity between a stripe and the water at which the water line is refined
+	/// </summary>
+	static const float MinimumContrast = 16;
+
+	/// <summary>
+	/// Average a range of the profile
+	/// </summary>
+	/// <param name="intensity">The profile</param>
+	/// <param name="from">The first row</param>
+	/// <param name="to">The row after the last row, larger than the first</param>
+	/// <returns>The mean intensity of the rows</returns>
+	static float Average(const std::vector<float> &intensity, int from, int to) {
+		float sum = 0;
+		for (int row = from; row < to; row++) {
+			sum += intensity[row];
+		}
+
+		return sum / (to - from);
+	}
+
+	/// <summary>
+	/// Find the strongest change of the profile in one direction to a fraction of a row, by fitting a parabola through the gradient around it
+	/// </summary>
+	/// <param name="intensity">The smoothed profile</param>
+	/// <param name="from">The first row to search</param>
+	/// <param name="to">The last row to search</param>
+	/// <param name="sign">1 to find a change to brighter rows, -1 to find a change to darker rows</param>
+	/// <param name="minimum">The smallest change over two rows which counts as an edge</param>
+	/// <returns>The edge in rows from the top of the profile, where row r covers [r, r + 1), -1 if there is none</returns>
+	static double Edge(const std::vector<float> &intensity, int from, int to, float sign, float minimum) {
+		int rows = (int)intensity.size();
+		int peak = -1;
+		float strongest = minimum;
+		for (int row = std::max(from, 1); row <= std::min(to, rows - 2); row++) {
+			float gradient = sign * (intensity[row + 1] - intensity[row - 1]);
+			if (gradient > strongest) {
+				strongest = gradient;
+				peak = row;
+			}
+		}
+
+		if (peak < 0) {
+			return -1;
+		}
+
+		double offset = 0;
+		if (peak >= 2 && peak <= rows - 3) {
+			double before = sign * (intensity[peak] - intensity[peak - 2]);
+			double after = sign * (intensity[peak + 2] - intensity[peak]);
+			double curvature = before - (2 * strongest) + after;
+			if (curvature < 0) {
+				offset = std::max(std::min(0.5 * (before - after) / curvature, 0.5), -0.5);
+			}
+		}
+
+		// The gradient peaks halfway between the last row before the edge and the first row after it
+		return peak + offset + 0.5;
+	}
+
+	/// <summary>
+	/// Collapse every row of the region to its mean intensity
+	/// </summary>
+	/// <param name="region">The 8 bit grayscale stripe region</param>
+	/// <param name="intensity">Receives the mean intensity of every row</param>
+	void RowProfile::Mean(const Mat &region, std::vector<float> &intensity) {
+		intensity.resize(region.rows);
+		for (int row = 0; row < region.rows; row++) {
+			const uchar *pixels = region.ptr<uchar>(row);
+			int sum = 0;
+			for (int col = 0; col < region.cols; col++) {
+				sum += pixels[col];
+			}
+
+			intensity[row] = (float)sum / region.cols;
+		}
+	}
+
+	/// <summary>
+	/// Collapse every row of the region to the mean intensity of its middle half, which ignores glare and dark spots
+	/// </summary>
+	/// <param name="region">The 8 bit grayscale stripe region</param>
+	/// <param name="intensity">Receives the trimmed mean intensity of every row</param>
+	/// <param name="scratch">Scratch buffer for the pixels of a row</param>
+	void RowProfile::TrimmedMean(const Mat &region, std::vector<float> &intensity, std::vector<uchar> &scratch) {
+		intensity.resize(region.rows);
+		scratch.resize(region.cols);
+		int low = region.cols / 4;
+		int high = region.cols - low;
+		for (int row = 0; row < region.rows; row++) {
+			const uchar *pixels = region.ptr<uchar>(row);
+			std::copy(pixels, pixels + region.cols, scratch.begin());
+			std::nth_element(scratch.begin(), scratch.begin() + low, scratch.end());
+			std::nth_element(scratch.begin() + low, scratch.begin() + high - 1, scratch.end());
+			int sum = 0;
+			for (int col = low; col < high; col++) {
+				sum += scratch[col];
+			}
+
+			intensity[row] = (float)sum / (high - low);
+		}
+	}
+
+	/// <summary>
+	/// Smooth the profile with the same 5 tap Gaussian kernel GaussianBlur uses for a 5x5 window
+	/// </summary>
+	/// <param name="intensity">The profile to smooth</param>
+	/// <param name="smoothed">Receives the smoothed profile</param>
+	void RowProfile::Blur(const std::vector<float> &intensity, std::vector<float> &smoothed) {
+		static const float kernel[] = { 1 / 16.0f, 4 / 16.0f, 6 / 16.0f, 4 / 16.0f, 1 / 16.0f };
+		int rows = (int)intensity.size();
+		smoothed.resize(rows);
+		for (int row = 0; row < rows; row++) {
+			float sum = 0;
+			for (int k = -2; k <= 2; k++) {
+				// Mirror around the first and last row like the default border of GaussianBlur
+				int index = std::abs(row + k);
+				if (index >= rows) {
+					index = std::max((2 * rows) - index - 2, 0);
+				}
+
+				sum += kernel[k + 2] * intensity[index];
+			}
+
+			smoothed[row] = sum;
+		}
+	}
+
+	/// <summary>
+	/// Decide per row whether it belongs to a white stripe
+	/// </summary>
+	/// <param name="intensity">The smoothed profile</param>
+	/// <param name="threshold">Rows brighter than this value belong to a white stripe</param>
+	/// <param name="profile">Receives 255 for every row of a white stripe and 0 for every other row</param>
+	void RowProfile::Threshold(const std::vector<float> &intensity, float threshold, std::vector<uchar> &profile) {
+		profile.resize(intensity.size());
+		for (size_t row = 0; row < intensity.size(); row++) {
+			profile[row] = intensity[row] > threshold ? 255 : 0;
+		}
+	}
+
+	/// <summary>
+	/// Find the part of the partially submerged stripe above the water. The edges of the stripe and of the stripe above it give
+	/// the height of a stripe, the water line is the strongest change from the stripe to the water below its top edge.
+	/// The intensity of the stripe is taken from the stripe of the same color above it and that of the water from the rows below the stripe.
+	/// </summary>
+	/// <param name="intensity">The smoothed profile</param>
+	/// <param name="stripeStart">The first row of the partially submerged stripe</param>
+	/// <param name="stripeHeight">The height of a stripe in rows</param>
+	/// <returns>The part of the stripe above the water from 0 to 1, -1 if it cannot be found</returns>
+	double RowProfile::StripeAboveWater(const std::vector<float> &intensity, int stripeStart, int stripeHeight) {
+		int rows = (int)intensity.size();
+		int height = std::max(stripeHeight, 4);
+		int waterStart = stripeStart + height + (height / 4);
+		int waterEnd = std::min(stripeStart + (2 * height), rows);
+		if (stripeStart - (2 * height) < 0 || waterStart >= waterEnd) {
+			return -1;
+		}
+
+		// Only the middle of the reference stripes is used, their edges are smoothed into the neighbouring stripes
+		float stripe = Average(intensity, stripeStart - (2 * height) + (height / 4), stripeStart - height - (height / 4));
+		float other = Average(intensity, stripeStart - height + (height / 4), stripeStart - (height / 4));
+		float water = Average(intensity, waterStart, waterEnd);
+		if (std::abs(stripe - other) < MinimumContrast || std::abs(water - stripe) < MinimumContrast) {
+			return -1;
+		}
+
+		float sign = stripe > other ? 1.0f : -1.0f;
+		double top = Edge(intensity, stripeStart - (height / 2), stripeStart + (height / 2), sign, std::abs(stripe - other) / 4);
+		if (top < 0) {
+			return -1;
+		}
+
+		double previousTop = Edge(intensity, (int)top - height - (height / 2), (int)top - (height / 2), -sign, std::abs(stripe - other) / 4);
+		double pixelsPerStripe = top - previousTop;
+		if (previousTop < 0 || pixelsPerStripe < 2) {
+			return -1;
+		}
+
+		// The top edge of the stripe changes the other way, so only changes towards the water are considered
+		int first = (int)top + 1;
+		int last = std::min((int)(top + pixelsPerStripe), rows - 1);
+		double waterLine = Edge(intensity, first, last, water > stripe ? 1.0f : -1.0f, std::abs(water - stripe) / 4);
+		if (waterLine < 0) {
+			// Without an edge the stripe is either completely under water or completely above it
+			float inside = Average(intensity, first, std::max(last, first + 1));
+			return std::abs(inside - water) < std::abs(inside - stripe) ? 0 : 1;
+		}
+
+		return std::max(std::min((waterLine - top) / pixelsPerStripe, 1.0), 0.0);
+	}
+}
\ No newline at end of file
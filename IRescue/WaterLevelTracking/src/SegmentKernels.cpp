@@ -0,0 +1,175 @@
+// <copyright file="SegmentKernels.cpp" company="Delft University of Technology">
+// Copyright (c) Delft University of Technology. All rights reserved.
+// </copyright>
+
+#include "../include/SegmentKernels.h"
+
+#if defined(_M_X64) || defined(_M_IX86) || defined(__x86_64__) || defined(__i386__)
+#define WLT_X86 1
+#include <immintrin.h>
+#ifdef _MSC_VER
+#include <intrin.h>
+#define WLT_TARGET_AVX2
+#else
+#define WLT_TARGET_AVX2 __attribute__((target("avx2")))
+#endif
+#endif
+
+namespace waterleveltracking {
+	/// <summary>
+	/// Threshold every pixel of the region and count the foreground pixels of each row in a single pass.
+	/// A row is foreground when at least 45% of its pixels are brighter than the threshold.
+	/// </summary>
+	/// <param name="data">The first pixel of the 8 bit grayscale region</param>
+	/// <param name="step">The amount of bytes between the starts of two rows</param>
+	/// <param name="rows">The amount of rows of the region</param>
+	/// <param name="cols">The amount of columns of the region</param>
+	/// <param name="threshold">Pixels brighter than this value are foreground</param>
+	/// <param name="profile">Receives 255 for every foreground row and 0 for every other row</param>
+	void SegmentKernels::ThresholdRowProjection(const unsigned char *data, size_t step, int rows, int cols, unsigned char threshold, unsigned char *profile) {
+		static const InstructionSet supported = GetSupportedInstructionSet();
+		ThresholdRowProjection(supported, data, step, rows, cols, threshold, profile);
+	}
+
+	/// <summary>
+	/// Threshold and project the region with a specific instruction set, falling back to plain C++ if it is not supported
+	/// </summary>
+	/// <param name="instructionSet">The instruction set to use</param>
+	/// <param name="data">The first pixel of the 8 bit grayscale region</param>
+	/// <param name="step">The amount of bytes between the starts of two rows</param>
+	/// <param name="rows">The amount of rows of the region</param>
+	/// <param name="cols">The amount of columns of the region</param>
+	/// <param name="threshold">Pixels brighter than this value are foreground</param>
+	/// <param name="profile">Receives 255 for every foreground row and 0 for every other row</param>
+	void SegmentKernels::ThresholdRowProjection(InstructionSet instructionSet, const unsigned char *data, size_t step, int rows, int cols, unsigned char threshold, unsigned char *profile) {
+		if (instructionSet > GetSupportedInstructionSet()) {
+			instructionSet = Scalar;
+		}
+
+		int (*count)(const unsigned char *, int, unsigned char) = instructionSet == Avx2 ? CountAvx2 : instructionSet == Sse2 ? CountSse2 : CountScalar;
+		for (int row = 0; row < rows; row++) {
+			// Integer form of count >= cols * 0.45, which gives the same verdict for every width
+			profile[row] = count(data + (row * step), cols, threshold) * 20 >= cols * 9 ? 255 : 0;
+		}
+	}
+
+	/// <summary>
+	/// Gets the widest instruction set supported by the processor
+	/// </summary>
+	SegmentKernels::InstructionSet SegmentKernels::GetSupportedInstructionSet() {
+#if defined(WLT_X86) && defined(_MSC_VER)
+		int info[4];
+		__cpuid(info, 0);
+		int maxLeaf = info[0];
+		__cpuid(info, 1);
+		bool osSavesAvx = (info[2] & (1 << 27)) != 0 && (info[2] & (1 << 28)) != 0 && (_xgetbv(0) & 6) == 6;
+		if (osSavesAvx && maxLeaf >= 7) {
+			__cpuidex(info, 7, 0);
+			if ((info[1] & (1 << 5)) != 0) {
+				return Avx2;
+			}
+		}
+
+		return Sse2;
+#elif defined(WLT_X86)
+		__builtin_cpu_init();
+		if (__builtin_cpu_supports("avx2")) {
+			return Avx2;
+		}
+
+		return __builtin_cpu_supports("sse2") ? Sse2 : Scalar;
+#else
+		return Scalar;
+#endif
+	}
+
+	/// <summary>
+	/// Count the pixels of a row which are brighter than the threshold, in plain C++
+	/// </summary>
+	/// <param name="row">The first pixel of the row</param>
+	/// <param name="cols">The amount of pixels in the row</param>
+	/// <param name="threshold">Pixels brighter than this value are counted</param>
+	/// <returns>The amount of pixels brighter than the threshold</returns>
+	int SegmentKernels::CountScalar(const unsigned char *row, int cols, unsigned char threshold) {
+		int count = 0;
+		for (int col = 0; col < cols; col++) {
+			count += row[col] > threshold;
+		}
+
+		return count;
+	}
+
+#ifdef WLT_X86
+	/// <summary>
+	/// Count the pixels of a row which are brighter than the threshold, using SSE2
+	/// </summary>
+	/// <param name="row">The first pixel of the row</param>
+	/// <param name="cols">The amount of pixels in the row</param>
+	/// <param name="threshold">Pixels brighter than this value are counted</param>
+	/// <returns>The amount of pixels brighter than the threshold</returns>
+	int SegmentKernels::CountSse2(const unsigned char *row, int cols, unsigned char threshold) {
+		// SSE2 only compares signed bytes, so both sides are shifted into the signed range
+		const __m128i bias = _mm_set1_epi8((char)0x80);
+		const __m128i limit = _mm_set1_epi8((char)(threshold ^ 0x80));
+		const __m128i one = _mm_set1_epi8(1);
+		const __m128i zero = _mm_setzero_si128();
+		__m128i sums = _mm_setzero_si128();
+		int col = 0;
+		for (; col + 16 <= cols; col += 16) {
+			__m128i pixels = _mm_xor_si128(_mm_loadu_si128((const __m128i *)(row + col)), bias);
+			__m128i bright = _mm_and_si128(_mm_cmpgt_epi8(pixels, limit), one);
+			sums = _mm_add_epi64(sums, _mm_sad_epu8(bright, zero));
+		}
+
+		int count = _mm_cvtsi128_si32(sums) + _mm_cvtsi128_si32(_mm_srli_si128(sums, 8));
+		return count + CountScalar(row + col, cols - col, threshold);
+	}
+
+	/// <summary>
+	/// Count the pixels of a row which are brighter than the threshold, using AVX2
+	/// </summary>
+	/// <param name="row">The first pixel of the row</param>
+	/// <param name="cols">The amount of pixels in the row</param>
+	/// <param name="threshold">Pixels brighter than this value are counted</param>
+	/// <returns>The amount of pixels brighter than the threshold</returns>
+	WLT_TARGET_AVX2 int SegmentKernels::CountAvx2(const unsigned char *row, int cols, unsigned char threshold) {
+		const __m256i bias = _mm256_set1_epi8((char)0x80);
+		const __m256i limit = _mm256_set1_epi8((char)(threshold ^ 0x80));
+		const __m256i one = _mm256_set1_epi8(1);
+		const __m256i zero = _mm256_setzero_si256();
+		__m256i sums = _mm256_setzero_si256();
+		int col = 0;
+		for (; col + 32 <= cols; col += 32) {
+			__m256i pixels = _mm256_xor_si256(_mm256_loadu_si256((const __m256i *)(row + col)), bias);
+			__m256i bright = _mm256_and_si256(_mm256_cmpgt_epi8(pixels, limit), one);
+			sums = _mm256_add_epi64(sums, _mm256_sad_epu8(bright, zero));
+		}
+
+		__m128i halves = _mm_add_epi64(_mm256_castsi256_si128(sums), _mm256_extracti128_si256(sums, 1));
+		int count = _mm_cvtsi128_si32(halves) + _mm_cvtsi128_si32(_mm_srli_si128(halves, 8));
+		return count + CountSse2(row + col, cols - col, threshold);
+	}
+#else
+	/// <summary>
+	/// Count the pixels of a row which are brighter than the threshold, SSE2 is not available so plain C++ is used
+	/// </summary>
+	/// <param name="row">The first pixel of the row</param>
+	/// <param name="cols">The amount of pixels in the row</param>
+	/// <param name="threshold">Pixels brighter than this value are counted</param>
+	/// <returns>The amount of pixels brighter than the threshold</returns>
+	int SegmentKernels::CountSse2(const unsigned char *row, int cols, unsigned char threshold) {
+		return CountScalar(row, cols, threshold);
+	}
+
+	/// <summary>
+	/// Count the pixels of a row which are brighter than the threshold, AVX2 is not available so plain C++ is used
+	/// </summary>
+	/// <param name="row">The first pixel of the row</param>
+	/// <param name="cols">The amount of pixels in the row</param>
+	/// <param name="threshold">Pixels brighter than this value are counted</param>
+	/// <returns>The amount of pixels brighter than the threshold</returns>
+	int SegmentKernels::CountAvx2(const unsigned char *row, int cols, unsigned char threshold) {
+		return CountScalar(row, cols, threshold);
+	}
+#endif
+}
\ No newline at end of file
@@ -0,0 +1,342 @@
+// <copyright file="StreamEngine.cpp" company="Delft University of Technology">
+// Copyright (c) Delft University of Technology. All rights reserved.
+// </copyright>
+
+#include "../include/StreamEngine.h"
+
+namespace waterleveltracking {
+	/// <summary>
+	/// Initializes a new instance of the <see cref="StreamEngine"/> class and starts the threads.
+	/// </summary>
+	/// <param name="options">The options which select how frames are processed</param>
+	/// <param name="threadCount">The amount of threads in the pool, 0 to use one per hardware thread</param>
+	StreamEngine::StreamEngine(TrackerOptions options, int threadCount)
+		: options(options), running(true), queuedCount(0), nextQueue(0), stealCount(0), outstandingCount(0) {
+		if (threadCount <= 0) {
+			threadCount = std::max((int)std::thread::hardware_concurrency(), 1);
+		}
+
+		for (int i = 0; i < threadCount; i++) {
+			this->queues.push_back(std::unique_ptr<WorkerQueue>(new WorkerQueue()));
+		}
+
+		for (int i = 0; i < threadCount; i++) {
+			this->workers.push_back(std::thread(&StreamEngine::Run, this, i));
+		}
+	}
+
+	/// <summary>
+	/// Stops the threads and waits for them to finish, frames which were not processed yet are discarded.
+	/// </summary>
+	StreamEngine::~StreamEngine() {
+		{
+			std::lock_guard<std::mutex> lock(this->sleepMutex);
+			this->running = false;
+		}
+
+		this->wake.notify_all();
+		for (size_t i = 0; i < this->workers.size(); i++) {
+			this->workers[i].join();
+		}
+	}
+
+	/// <summary>
+	/// Register a stream
+	/// </summary>
+	/// <param name="markerProperties">Properties of the measured marker</param>
+	/// <param name="stripeProperties">Properties of the striped underneath the measured marker</param>
+	/// <param name="latencyBudget">The time in seconds a frame may wait before it is skipped in favour of a newer frame, 0 to process every frame</param>
+	/// <param name="callback">Receives the results of the stream, when empty they are put on the completion queue</param>
+	/// <param name="boardSlot">The slot of the level board the levels of the stream are published to, -1 to not publish them</param>
+	/// <returns>The identifier of the stream</returns>
+	int StreamEngine::AddStream(const MarkerProperties &markerProperties, const StripeProperties &stripeProperties, double latencyBudget, ResultCallback callback, int boardSlot) {
+		std::lock_guard<std::mutex> lock(this->streamsMutex);
+		int id = (int)this->streams.size();
+		this->streams.push_back(std::unique_ptr<Stream>(new Stream(id, markerProperties, stripeProperties, latencyBudget, callback, boardSlot, this->options)));
+		return id;
+	}
+
+	/// <summary>
+	/// Submit a frame to a stream, the marker is where it was registered.
+	/// The frame is copied, so the caller can reuse it right away.
+	/// </summary>
+	/// <param name="stream">The identifier of the stream</param>
+	/// <param name="frame">The captured frame of the video feed</param>
+	/// <param name="rotation">Angle in degrees of the rotation of the marker</param>
+	/// <returns>False if the stream does not exist</returns>
+	bool StreamEngine::Submit(int stream, const Mat &frame, double rotation) {
+		Stream *target = this->Find(stream);
+		return target != nullptr && this->Submit(stream, frame, target->markerProperties, rotation);
+	}
+
+	/// <summary>
+	/// Submit a frame to a stream with the marker where it was found in this frame.
+	/// The frame is copied, so the caller can reuse it right away.
+	/// </summary>
+	/// <param name="stream">The identifier of the stream</param>
+	/// <param name="frame">The captured frame of the video feed</param>
+	/// <param name="markerProperties">Properties of the measured marker in this frame</param>
+	/// <param name="rotation">Angle in degrees of the rotation of the marker</param>
+	/// <returns>False if the stream does not exist</returns>
+	bool StreamEngine::Submit(int stream, const Mat &frame, const MarkerProperties &markerProperties, double rotation) {
+		Stream *target = this->Find(stream);
+		if (target == nullptr) {
+			return false;
+		}
+
+		PendingFrame pending(markerProperties);
+		pending.submitTicks = getTickCount();
+		pending.rotation = rotation;
+		frame.copyTo(pending.frame);
+		{
+			std::lock_guard<std::mutex> lock(this->idleMutex);
+			this->outstandingCount++;
+		}
+
+		bool schedule;
+		{
+			std::lock_guard<std::mutex> lock(target->mutex);
+			pending.sequence = target->nextSequence++;
+			target->pending.push_back(std::move(pending));
+			target->statistics.submitted++;
+			schedule = !target->scheduled;
+			target->scheduled = true;
+		}
+
+		// A stream which is already scheduled picks the frame up on its next turn
+		if (schedule) {
+			this->Schedule(this->nextQueue++ % this->queues.size(), target);
+		}
+
+		return true;
+	}
+
+	/// <summary>
+	/// Take the oldest result from the completion queue, which holds the results of the streams without a callback
+	/// </summary>
+	/// <param name="result">The oldest result</param>
+	/// <returns>False if the completion queue is empty</returns>
+	bool StreamEngine::TryGetResult(EngineResult &result) {
+		std::lock_guard<std::mutex> lock(this->completionsMutex);
+		if (this->completions.empty()) {
+			return false;
+		}
+
+		result = this->completions.front();
+		this->completions.pop_front();
+		return true;
+	}
+
+	/// <summary>
+	/// Block until every submitted frame has a result
+	/// </summary>
+	void StreamEngine::Wait() {
+		std::unique_lock<std::mutex> lock(this->idleMutex);
+		this->idle.wait(lock, [this] { return this->outstandingCount == 0; });
+	}
+
+	/// <summary>
+	/// Gets the counters of a stream
+	/// </summary>
+	/// <param name="stream">The identifier of the stream</param>
+	StreamStatistics StreamEngine::GetStatistics(int stream) {
+		Stream *target = this->Find(stream);
+		if (target == nullptr) {
+			return StreamStatistics();
+		}
+
+		std::lock_guard<std::mutex> lock(target->mutex);
+		return target->statistics;
+	}
+
+	/// <summary>
+	/// Gets the amount of streams
+	/// </summary>
+	int StreamEngine::GetStreamCount() {
+		std::lock_guard<std::mutex> lock(this->streamsMutex);
+		return (int)this->streams.size();
+	}
+
+	/// <summary>
+	/// Gets the amount of times a thread took a stream from the queue of another thread
+	/// </summary>
+	long long StreamEngine::GetStealCount() {
+		return this->stealCount;
+	}
+
+	/// <summary>
+	/// Gets a registered stream
+	/// </summary>
+	/// <param name="stream">The identifier of the stream</param>
+	/// <returns>The stream or nullptr if it does not exist</returns>
+	StreamEngine::Stream *StreamEngine::Find(int stream) {
+		std::lock_guard<std::mutex> lock(this->streamsMutex);
+		return stream >= 0 && stream < (int)this->streams.size() ? this->streams[stream].get() : nullptr;
+	}
+
+	/// <summary>
+	/// Put a stream in a queue of the pool and wake a thread for it
+	/// </summary>
+	/// <param name="queue">The index of the queue</param>
+	/// <param name="stream">The stream to schedule</param>
+	void StreamEngine::Schedule(int queue, Stream *stream) {
+		{
+			std::lock_guard<std::mutex> lock(this->queues[queue]->mutex);
+			this->queues[queue]->streams.push_back(stream);
+		}
+
+		// Taking the sleep mutex orders the count against a thread which is about to go to sleep
+		{
+			std::lock_guard<std::mutex> lock(this->sleepMutex);
+			this->queuedCount++;
+		}
+
+		this->wake.notify_one();
+	}
+
+	/// <summary>
+	/// Take a stream from the own queue, or from the queue of another thread if it is empty
+	/// </summary>
+	/// <param name="worker">The index of the thread</param>
+	/// <returns>The stream or nullptr if every queue is empty</returns>
+	StreamEngine::Stream *StreamEngine::Take(int worker) {
+		int count = (int)this->queues.size();
+		for (int i = 0; i < count; i++) {
+			WorkerQueue &queue = *this->queues[(worker + i) % count];
+			std::lock_guard<std::mutex> lock(queue.mutex);
+			if (queue.streams.empty()) {
+				continue;
+			}
+
+			// The owner keeps its streams in turn order, a thief takes the stream which waited the shortest
+			Stream *stream;
+			if (i == 0) {
+				stream = queue.streams.front();
+				queue.streams.pop_front();
+			} else {
+				stream = queue.streams.back();
+				queue.streams.pop_back();
+				this->stealCount++;
+			}
+
+			this->queuedCount--;
+			return stream;
+		}
+
+		return nullptr;
+	}
+
+	/// <summary>
+	/// Run a thread of the pool until the engine is stopped
+	/// </summary>
+	/// <param name="worker">The index of the thread</param>
+	void StreamEngine::Run(int worker) {
+		while (this->running) {
+			Stream *stream = this->Take(worker);
+			if (stream != nullptr) {
+				this->Process(worker, *stream);
+				continue;
+			}
+
+			std::unique_lock<std::mutex> lock(this->sleepMutex);
+			this->wake.wait_for(lock, std::chrono::milliseconds(10), [this] { return !this->running || this->queuedCount > 0; });
+		}
+	}
+
+	/// <summary>
+	/// Process the oldest frame of a stream, skipping the frames that outlived the latency budget, and schedule the stream again if frames are left
+	/// </summary>
+	/// <param name="worker">The index of the thread</param>
+	/// <param name="stream">The stream to process</param>
+	void StreamEngine::Process(int worker, Stream &stream) {
+		std::vector<EngineResult> expired;
+		std::unique_lock<std::mutex> lock(stream.mutex);
+		int64 now = getTickCount();
+		double frequency = getTickFrequency();
+
+		// A frame which outlived the budget is only skipped if a newer frame can take its place
+		if (stream.latencyBudget > 0) {
+			int64 budget = (int64)(stream.latencyBudget * frequency);
+			while (stream.pending.size() > 1 && now - stream.pending.front().submitTicks > budget) {
+				EngineResult result = { stream.id, stream.pending.front().sequence, 0, (now - stream.pending.front().submitTicks) / frequency, true };
+				expired.push_back(result);
+				stream.pending.pop_front();
+				stream.statistics.expired++;
+			}
+		}
+
+		PendingFrame frame = std::move(stream.pending.front());
+		stream.pending.pop_front();
+		lock.unlock();
+
+		for (size_t i = 0; i < expired.size(); i++) {
+			this->Deliver(stream, expired[i]);
+		}
+
+#ifdef WLT_ENABLE_INSTRUMENTATION
+		// Drop the stage timings of the frames this thread processed for other streams, so the board only gets the ones of this frame
+		if (stream.boardSlot >= 0) {
+			uint64_t durations[(int)Stage::Count];
+			Instrumentation::TakeFrameDurations(durations);
+		}
+#endif
+
+		MarkerProperties markerProperties = frame.markerProperties;
+		StripeProperties stripeProperties = stream.stripeProperties;
+		int64 start = getTickCount();
+		double level = stream.tracker.Track(frame.frame, markerProperties, stripeProperties, frame.rotation);
+		int64 end = getTickCount();
+		EngineResult result = { stream.id, frame.sequence, level, (end - frame.submitTicks) / frequency, false };
+		if (stream.boardSlot >= 0) {
+			LevelBoard::Publish(stream.boardSlot, level, stream.tracker.GetLastResult().confidence, (long long)(frame.submitTicks * (1e6 / frequency)));
+		}
+
+		lock.lock();
+		stream.statistics.processed++;
+		stream.statistics.totalLatency += result.latency;
+		stream.statistics.maxLatency = std::max(stream.statistics.maxLatency, result.latency);
+		stream.statistics.totalProcessing += (end - start) / frequency;
+		lock.unlock();
+
+		// The result is delivered before the stream is released, so the results of a stream never overtake each other
+		this->Deliver(stream, result);
+		lock.lock();
+		bool reschedule = !stream.pending.empty();
+		stream.scheduled = reschedule;
+		lock.unlock();
+
+		// Going to the back of the own queue gives the other streams their turn first
+		if (reschedule) {
+			this->Schedule(worker, &stream);
+		}
+
+		this->Complete((int)expired.size() + 1);
+	}
+
+	/// <summary>
+	/// Hand a result to the callback of its stream or to the completion queue
+	/// </summary>
+	/// <param name="stream">The stream of the result</param>
+	/// <param name="result">The result</param>
+	void StreamEngine::Deliver(Stream &stream, const EngineResult &result) {
+		if (stream.callback) {
+			stream.callback(result);
+			return;
+		}
+
+		std::lock_guard<std::mutex> lock(this->completionsMutex);
+		this->completions.push_back(result);
+	}
+
+	/// <summary>
+	/// Count frames as done and wake the waiting threads when no frame is left
+	/// </summary>
+	/// <param name="count">The amount of frames which got a result</param>
+	void StreamEngine::Complete(int count) {
+		std::lock_guard<std::mutex> lock(this->idleMutex);
+		this->outstandingCount -= count;
+		if (this->outstandingCount == 0) {
+			this->idle.notify_all();
+		}
+	}
+}
\ No newline at end of file
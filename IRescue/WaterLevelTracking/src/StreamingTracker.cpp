@@ -0,0 +1,214 @@
+// <copyright file="StreamingTracker.cpp" company="Delft University of Technology">
+// Copyright (c) Delft University of Technology. All rights reserved.
+// </copyright>
+
+#include "../include/StreamingTracker.h"
+
+namespace waterleveltracking {
+	/// <summary>
+	/// Initializes a new instance of the <see cref="StreamingTracker"/> class and starts the stages.
+	/// </summary>
+	/// <param name="markerProperties">Properties of the measured marker</param>
+	/// <param name="stripeProperties">Properties of the striped underneath the measured marker</param>
+	/// <param name="options">The options which select how frames are processed</param>
+	/// <param name="queueCapacity">The amount of frames which can wait in front of each stage</param>
+	StreamingTracker::StreamingTracker(const MarkerProperties &markerProperties, const StripeProperties &stripeProperties, TrackerOptions options, int queueCapacity)
+		: running(true), droppedCount(0), nextSequence(0) {
+		// Every queue can be full while every stage holds a job, the producer holds one and the consumer holds two
+		int jobCount = ((StageCount + 1) * queueCapacity) + StageCount + 3;
+		for (int i = 0; i < jobCount; i++) {
+			this->jobs.push_back(std::unique_ptr<Job>(new Job(markerProperties, stripeProperties)));
+		}
+
+		for (int i = 0; i <= StageCount; i++) {
+			this->queues.push_back(std::unique_ptr<DropOldestQueue<Job>>(new DropOldestQueue<Job>(queueCapacity)));
+		}
+
+		for (int i = 0; i < StageCount; i++) {
+			this->trackers.push_back(WaterLevelTracker(options));
+		}
+
+		for (int i = 0; i < StageCount; i++) {
+			this->workers.push_back(std::thread(&StreamingTracker::Run, this, i));
+		}
+	}
+
+	/// <summary>
+	/// Stops the stages and waits for them to finish.
+	/// </summary>
+	StreamingTracker::~StreamingTracker() {
+		this->running = false;
+		for (size_t i = 0; i < this->workers.size(); i++) {
+			this->workers[i].join();
+		}
+	}
+
+	/// <summary>
+	/// Submit a frame to the pipeline. The frame is copied, so the caller can reuse it right away.
+	/// Must always be called from the same thread.
+	/// </summary>
+	/// <param name="frame">The captured frame of the video feed</param>
+	/// <param name="markerProperties">Properties of the measured marker in this frame</param>
+	/// <param name="stripeProperties">Properties of the striped underneath the measured marker</param>
+	/// <param name="rotation">Angle in degrees of the rotation of the marker</param>
+	void StreamingTracker::Submit(const Mat &frame, const MarkerProperties &markerProperties, const StripeProperties &stripeProperties, double rotation) {
+		Job *job = this->Acquire();
+		job->sequence = this->nextSequence++;
+		job->submitTicks = getTickCount();
+		job->rotation = rotation;
+		job->valid = true;
+		job->markerProperties = markerProperties;
+		job->stripeProperties = stripeProperties;
+		frame.copyTo(job->frame);
+		this->Forward(0, job);
+	}
+
+	/// <summary>
+	/// Take the newest calculated water level, older results which were not taken yet are dropped.
+	/// Must always be called from the same thread.
+	/// </summary>
+	/// <param name="result">The newest result</param>
+	/// <returns>False if no new result was available</returns>
+	bool StreamingTracker::TryGetResult(StreamResult &result) {
+		Job *newest = nullptr;
+		for (Job *job = this->queues[StageCount]->Pop(); job != nullptr; job = this->queues[StageCount]->Pop()) {
+			if (newest != nullptr) {
+				this->droppedCount++;
+				this->Release(newest);
+			}
+
+			newest = job;
+		}
+
+		if (newest == nullptr) {
+			return false;
+		}
+
+		result.sequence = newest->sequence;
+		result.level = newest->level;
+		result.latency = (getTickCount() - newest->submitTicks) / getTickFrequency();
+		this->Release(newest);
+		return true;
+	}
+
+	/// <summary>
+	/// Gets the amount of frames which were dropped because a stage or the consumer fell behind
+	/// </summary>
+	long long StreamingTracker::GetDroppedCount() {
+		return this->droppedCount;
+	}
+
+	/// <summary>
+	/// Run a stage until the pipeline is stopped
+	/// </summary>
+	/// <param name="stage">The index of the stage</param>
+	void StreamingTracker::Run(int stage) {
+		int idle = 0;
+		while (this->running) {
+			Job *job = this->queues[stage]->Pop();
+			if (job == nullptr) {
+				// Back off from spinning to sleeping while the stage in front has nothing to hand over
+				if (++idle < 64) {
+					std::this_thread::yield();
+				} else {
+					std::this_thread::sleep_for(std::chrono::microseconds(200));
+				}
+
+				continue;
+			}
+
+			idle = 0;
+			this->Process(stage, *job);
+			this->Forward(stage + 1, job);
+		}
+	}
+
+	/// <summary>
+	/// Perform the work of a stage on a job
+	/// </summary>
+	/// <param name="stage">The index of the stage</param>
+	/// <param name="job">The job to work on</param>
+	void StreamingTracker::Process(int stage, Job &job) {
+		if (!job.valid) {
+			return;
+		}
+
+		switch (stage) {
+		case 0:
+			this->trackers[stage].ConvertToGray(job.frame).copyTo(job.gray);
+			break;
+		case 1: {
+			Mat region = this->trackers[stage].ExtractRegion(job.gray, 360 - job.rotation, job.markerProperties, job.stripeProperties);
+			job.valid = !region.empty();
+			region.copyTo(job.region);
+			break;
+		}
+		case 2:
+			if (this->trackers[stage].GetOptions().profileMode == ProfileMode::BandVote) {
+				this->trackers[stage].SegmentBands(job.region, job.profile);
+			} else {
+				this->trackers[stage].SegmentRegion(job.region, job.profile);
+			}
+
+			break;
+		default:
+			if (this->trackers[stage].GetOptions().profileMode == ProfileMode::BandVote) {
+				// The profile holds the bands one after the other, each with one verdict per row of the region
+				int bandCount = job.region.rows > 0 ? (int)(job.profile.size() / job.region.rows) : 1;
+				job.level = WaterLevelTracker::StripeCount(job.profile, bandCount, job.stripeProperties);
+			} else {
+				job.level = WaterLevelTracker::StripeCount(job.profile, job.stripeProperties);
+			}
+
+			break;
+		}
+
+		if (!job.valid) {
+			job.level = 0.0;
+		}
+	}
+
+	/// <summary>
+	/// Hand a job to the queue behind a stage, releasing the job it dropped if any
+	/// </summary>
+	/// <param name="queue">The index of the queue</param>
+	/// <param name="job">The job to hand over</param>
+	void StreamingTracker::Forward(int queue, Job *job) {
+		Job *dropped = this->queues[queue]->Push(job);
+		if (dropped != nullptr) {
+			this->droppedCount++;
+			this->Release(dropped);
+		}
+	}
+
+	/// <summary>
+	/// Take a job which is not in the pipeline
+	/// </summary>
+	/// <returns>The free job</returns>
+	StreamingTracker::Job *StreamingTracker::Acquire() {
+		int idle = 0;
+		while (true) {
+			for (size_t i = 0; i < this->jobs.size(); i++) {
+				bool expected = false;
+				if (this->jobs[i]->inUse.compare_exchange_strong(expected, true, std::memory_order_acquire)) {
+					return this->jobs[i].get();
+				}
+			}
+
+			// Back off from spinning to sleeping while every job is still held by a stage or the consumer
+			if (++idle < 64) {
+				std::this_thread::yield();
+			} else {
+				std::this_thread::sleep_for(std::chrono::microseconds(200));
+			}
+		}
+	}
+
+	/// <summary>
+	/// Return a job so it can be reused
+	/// </summary>
+	/// <param name="job">The job to return</param>
+	void StreamingTracker::Release(Job *job) {
+		job->inUse.store(false, std::memory_order_release);
+	}
+}
\ No newline at end of file
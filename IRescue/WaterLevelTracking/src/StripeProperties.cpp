@@ -11,7 +11,7 @@ namespace waterleveltracking {
 	/// <param name="markerProperties">The properties of the marker which is currently visible</param>
 	/// <param name="stripeHeight">The height of individual stripes in meters</param>
 	/// <param name="stripeCount">The amount of stripes located under the marker</param>
-	StripeProperties::StripeProperties(MarkerProperties markerProperties, double stripeHeight, int stripeCount) {
+	StripeProperties::StripeProperties(const MarkerProperties &markerProperties, double stripeHeight, int stripeCount) {
 		this->stripeHeight = stripeHeight;
 		this->stripeStart = markerProperties.GetMarkerHeight() - markerProperties.GetDistanceToStripes();
 		this->stripeCount = stripeCount;
@@ -29,7 +29,7 @@ namespace waterleveltracking {
 	/// <summary>
 	/// Gets the stripe height
 	/// </summary>
-	double StripeProperties::GetStripeHeight() {
+	double StripeProperties::GetStripeHeight() const {
 		return this->stripeHeight;
 	}
 
@@ -43,7 +43,7 @@ namespace waterleveltracking {
 	/// <summary>
 	/// Gets the stripe stripe start
 	/// </summary>
-	double StripeProperties::GetStripeStart() {
+	double StripeProperties::GetStripeStart() const {
 		return this->stripeStart;
 	}
 
@@ -57,7 +57,7 @@ namespace waterleveltracking {
 	/// <summary>
 	/// Gets the stripe stripe count
 	/// </summary>
-	int StripeProperties::GetStripeCount() {
+	int StripeProperties::GetStripeCount() const {
 		return this->stripeCount;
 	}
 
@@ -71,7 +71,7 @@ namespace waterleveltracking {
 	/// <summary>
 	/// Gets the stripe stripe pixel height
 	/// </summary>
-	int StripeProperties::GetStripePixelHeight() {
+	int StripeProperties::GetStripePixelHeight() const {
 		return this->stripePixelHeight;
 	}
 
@@ -85,7 +85,7 @@ namespace waterleveltracking {
 	/// <summary>
 	/// Gets the stripe stripe pixel start
 	/// </summary>
-	int StripeProperties::GetStripePixelStart() {
+	int StripeProperties::GetStripePixelStart() const {
 		return this->stripePixelStart;
 	}
 }
\ No newline at end of file
@@ -0,0 +1,111 @@
+// <copyright file="TrackingState.cpp" company="Delft University of Technology">
+// Copyright (c) Delft University of Technology. All rights reserved.
+// </copyright>
+
+#include "../include/TrackingState.h"
+
+namespace waterleveltracking {
+	/// <summary>
+	/// Initializes a new instance of the <see cref="TrackingState"/> class.
+	/// </summary>
+	/// <param name="fullScanInterval">The amount of frames after which the whole stripe region is scanned again</param>
+	/// <param name="smoothing">The weight of a new level in the filtered level, between 0 and 1</param>
+	TrackingState::TrackingState(int fullScanInterval, double smoothing) {
+		this->fullScanInterval = fullScanInterval;
+		this->smoothing = smoothing;
+		this->filtered = false;
+		this->filteredLevel = 0;
+		this->imageBottom = -1;
+		this->Reset();
+	}
+
+	/// <summary>
+	/// Forget the water line, so the next frame is scanned completely
+	/// </summary>
+	void TrackingState::Reset() {
+		this->locked = false;
+		this->boundaryRow = -1;
+		this->stripePixelHeight = 0;
+		this->framesSinceFullScan = 0;
+	}
+
+	/// <summary>
+	/// Whether a water line is known and the next frame may be checked around it only
+	/// </summary>
+	/// <param name="rows">The amount of rows of the stripe region of the next frame</param>
+	/// <returns>True if the rows around the previous water line can be checked</returns>
+	bool TrackingState::CanTrack(int rows) {
+		return this->locked && this->framesSinceFullScan < this->fullScanInterval && (int)this->profile.size() == rows;
+	}
+
+	/// <summary>
+	/// Remember the water line found in a frame
+	/// </summary>
+	/// <param name="profile">The row profile of the segmented stripe region</param>
+	/// <param name="boundaryRow">The last row of the lowest accepted stripe</param>
+	/// <param name="stripePixelHeight">The height in pixels of the lowest accepted stripe</param>
+	/// <param name="fullScan">Whether the whole stripe region was scanned</param>
+	void TrackingState::Update(const std::vector<uchar> &profile, int boundaryRow, int stripePixelHeight, bool fullScan) {
+		this->profile.assign(profile.begin(), profile.end());
+		this->boundaryRow = boundaryRow;
+		this->stripePixelHeight = stripePixelHeight;
+		this->framesSinceFullScan = fullScan ? 0 : this->framesSinceFullScan + 1;
+		this->locked = true;
+	}
+
+	/// <summary>
+	/// Smooth the reported level, a jump of more than a stripe is followed right away
+	/// </summary>
+	/// <param name="level">The level in meters calculated for the current frame</param>
+	/// <param name="stripeHeight">The height of individual stripes in meters</param>
+	/// <returns>The filtered level in meters</returns>
+	double TrackingState::Filter(double level, double stripeHeight) {
+		if (level == 0) {
+			return level;
+		}
+
+		if (!this->filtered || fabs(level - this->filteredLevel) > stripeHeight) {
+			this->filteredLevel = level;
+			this->filtered = true;
+		} else {
+			this->filteredLevel += this->smoothing * (level - this->filteredLevel);
+		}
+
+		return this->filteredLevel;
+	}
+
+	/// <summary>
+	/// Gets the row profile of the previous frame
+	/// </summary>
+	const std::vector<uchar> &TrackingState::GetProfile() {
+		return this->profile;
+	}
+
+	/// <summary>
+	/// Gets the last row of the lowest accepted stripe in the previous frame
+	/// </summary>
+	int TrackingState::GetBoundaryRow() {
+		return this->boundaryRow;
+	}
+
+	/// <summary>
+	/// Gets the height in pixels of the lowest accepted stripe in the previous frame
+	/// </summary>
+	int TrackingState::GetStripePixelHeight() {
+		return this->stripePixelHeight;
+	}
+
+	/// <summary>
+	/// Gets the bottom row of the image found in the previous frame, -1 if unknown
+	/// </summary>
+	int TrackingState::GetImageBottom() {
+		return this->imageBottom;
+	}
+
+	/// <summary>
+	/// Sets the bottom row of the image found in the current frame
+	/// </summary>
+	void TrackingState::SetImageBottom(int imageBottom) {
+		this->imageBottom = imageBottom;
+	}
+}
\ No newline at end of file
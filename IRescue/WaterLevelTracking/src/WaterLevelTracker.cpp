@@ -5,6 +5,28 @@
 #include "../include/WaterLevelTracker.h"
 
 namespace waterleveltracking {
+	/// <summary>
+	/// Initializes a new instance of the <see cref="WaterLevelTracker"/> class.
+	/// </summary>
+	/// <param name="options">The options which select how frames are processed</param>
+	WaterLevelTracker::WaterLevelTracker(TrackerOptions options) {
+		this->options = options;
+		this->configuredOptions = options;
+		this->allocationCount = 0;
+		this->imageBottom = -1;
+		this->bottomHint = -1;
+		this->calibrationCount = 0;
+		this->pyramidLevel = 0;
+		this->recorder = NULL;
+		this->recordedStripePixelHeight = 0;
+		this->motionGate = MotionGate(options.motionThreshold, options.motionInterval, options.cornerTolerance);
+		this->governor = LatencyGovernor(options.latencyBudget);
+		this->result.status = WLT_STATUS_INVALID_INPUT;
+		this->result.level = 0.0;
+		this->result.confidence = 0;
+		this->result.stripeCount = 0;
+	}
+
 	/// <summary>
 	/// Predict the height of the water level using markers.
 	/// Return NULL or 0 if the the water level cannot be derived from the information
@@ -16,21 +38,565 @@ namespace waterleveltracking {
 	/// <param name="rotation">Angle in degrees of the rotation of the marker</param>
 	/// <returns>The height of the water in meters</returns>
 	double WaterLevelTracker::CalculateWaterLevel(Mat &frame, MarkerProperties &markerProperties, StripeProperties &stripeProperties, double rotation) {
-		cvtColor(frame, frame, CV_RGB2GRAY);
-		int imageBottom = Rotate(frame, 360 - rotation, markerProperties);
+		return CalculateWaterLevel(frame, markerProperties, stripeProperties, rotation, TrackerOptions());
+	}
+
+	/// <summary>
+	/// Predict the height of the water level using markers, processing the frame as selected by the options.
+	/// Return NULL if the the water level cannot be derived from the information
+	/// </summary>
+	/// <param name="frame">The captured frame of the video feed</param>
+	/// <param name="markerProperties">Properties of the measured marker</param>
+	/// <param name="stripeProperties">Properties of the striped underneath the measured marker</param>
+	/// <param name="rotation">Angle in degrees of the rotation of the marker</param>
+	/// <param name="options">The options which select how the frame is processed</param>
+	/// <returns>The height of the water in meters</returns>
+	double WaterLevelTracker::CalculateWaterLevel(Mat &frame, MarkerProperties &markerProperties, StripeProperties &stripeProperties, double rotation, TrackerOptions options) {
+		WaterLevelTracker tracker(options);
+		return tracker.Track(frame, markerProperties, stripeProperties, rotation);
+	}
+
+	/// <summary>
+	/// Predict the height of the water level using markers and tell why the frame did or did not give one, without throwing.
+	/// The stripe region is validated from the corners before any pixel is touched
+	/// </summary>
+	/// <param name="frame">The captured frame of the video feed</param>
+	/// <param name="markerProperties">Properties of the measured marker</param>
+	/// <param name="stripeProperties">Properties of the striped underneath the measured marker</param>
+	/// <param name="rotation">Angle in degrees of the rotation of the marker</param>
+	/// <param name="options">The options which select how the frame is processed</param>
+	/// <returns>The status, level, confidence and stripe count of the frame</returns>
+	WltTrackingResult WaterLevelTracker::MeasureWaterLevel(const Mat &frame, MarkerProperties &markerProperties, StripeProperties &stripeProperties, double rotation, TrackerOptions options) {
+		WaterLevelTracker tracker(options);
+		return tracker.Measure(frame, markerProperties, stripeProperties, rotation);
+	}
+
+	/// <summary>
+	/// Predict the height of the water level using markers, reusing the scratch buffers of this tracker.
+	/// The frame itself is not modified.
+	/// Return NULL if the the water level cannot be derived from the information
+	/// </summary>
+	/// <param name="frame">The captured frame of the video feed</param>
+	/// <param name="markerProperties">Properties of the measured marker</param>
+	/// <param name="stripeProperties">Properties of the striped underneath the measured marker</param>
+	/// <param name="rotation">Angle in degrees of the rotation of the marker</param>
+	/// <returns>The height of the water in meters</returns>
+	double WaterLevelTracker::Track(const Mat &frame, MarkerProperties &markerProperties, StripeProperties &stripeProperties, double rotation) {
+		return this->TrackScaled(frame, markerProperties, stripeProperties, rotation, NULL);
+	}
+
+	/// <summary>
+	/// Predict the height of the water level using markers, checking the rows around the water line of the previous frame first.
+	/// The whole stripe region is only scanned when that check fails. The returned level is filtered over the frames.
+	/// Return NULL if the the water level cannot be derived from the information
+	/// </summary>
+	/// <param name="frame">The captured frame of the video feed</param>
+	/// <param name="markerProperties">Properties of the measured marker</param>
+	/// <param name="stripeProperties">Properties of the striped underneath the measured marker</param>
+	/// <param name="rotation">Angle in degrees of the rotation of the marker</param>
+	/// <param name="state">The tracking state of the marker, updated with this frame</param>
+	/// <returns>The filtered height of the water in meters</returns>
+	double WaterLevelTracker::Track(const Mat &frame, MarkerProperties &markerProperties, StripeProperties &stripeProperties, double rotation, TrackingState &state) {
+		return this->TrackScaled(frame, markerProperties, stripeProperties, rotation, &state);
+	}
+
+	/// <summary>
+	/// Predict the height of the water level using markers and tell why the frame did or did not give one, reusing the scratch buffers of this tracker
+	/// </summary>
+	/// <param name="frame">The captured frame of the video feed</param>
+	/// <param name="markerProperties">Properties of the measured marker</param>
+	/// <param name="stripeProperties">Properties of the striped underneath the measured marker</param>
+	/// <param name="rotation">Angle in degrees of the rotation of the marker</param>
+	/// <returns>The status, level, confidence and stripe count of the frame</returns>
+	WltTrackingResult WaterLevelTracker::Measure(const Mat &frame, MarkerProperties &markerProperties, StripeProperties &stripeProperties, double rotation) {
+		this->TrackScaled(frame, markerProperties, stripeProperties, rotation, NULL);
+		return this->result;
+	}
+
+	/// <summary>
+	/// Predict the height of the water level using markers with the tracking state of the marker and tell why the frame did or did not give one
+	/// </summary>
+	/// <param name="frame">The captured frame of the video feed</param>
+	/// <param name="markerProperties">Properties of the measured marker</param>
+	/// <param name="stripeProperties">Properties of the striped underneath the measured marker</param>
+	/// <param name="rotation">Angle in degrees of the rotation of the marker</param>
+	/// <param name="state">The tracking state of the marker, updated with this frame</param>
+	/// <returns>The status, filtered level, confidence and stripe count of the frame</returns>
+	WltTrackingResult WaterLevelTracker::Measure(const Mat &frame, MarkerProperties &markerProperties, StripeProperties &stripeProperties, double rotation, TrackingState &state) {
+		this->TrackScaled(frame, markerProperties, stripeProperties, rotation, &state);
+		return this->result;
+	}
+
+	/// <summary>
+	/// Predict the height of the water level from a stripe region which was already straightened, for instance a recorded one.
+	/// Return NULL if the the water level cannot be derived from the information
+	/// </summary>
+	/// <param name="region">The grayscale stripe region</param>
+	/// <param name="stripeProperties">Properties of the striped underneath the measured marker, with the stripe height in pixels of the region</param>
+	/// <returns>The height of the water in meters</returns>
+	double WaterLevelTracker::TrackRegion(const Mat &region, StripeProperties &stripeProperties) {
+		if (region.empty()) {
+			return this->Reject(WLT_STATUS_OUTSIDE_FRAME);
+		}
+
+		return this->Conclude(region, this->ScanRegion(region, stripeProperties.GetStripePixelHeight()), stripeProperties);
+	}
+
+	/// <summary>
+	/// Reject hopeless frames from their corners and predict the height of the water level of the others with <see cref="TrackPyramid"/>.
+	/// When the motion threshold is set and the stripe region did not change, the level of the last processed frame is returned instead.
+	/// When the latency budget is set, the cost of the frame steers the quality of the following frames.
+	/// Every frame is handed to the recorder with the status it ended with, rejected and held frames included.
+	/// </summary>
+	/// <param name="frame">The captured frame of the video feed</param>
+	/// <param name="markerProperties">Properties of the measured marker</param>
+	/// <param name="stripeProperties">Properties of the striped underneath the measured marker</param>
+	/// <param name="rotation">Angle in degrees of the rotation of the marker</param>
+	/// <param name="state">The tracking state of the marker, NULL to track the frame on its own</param>
+	/// <returns>The height of the water in meters</returns>
+	double WaterLevelTracker::TrackScaled(const Mat &frame, MarkerProperties &markerProperties, StripeProperties &stripeProperties, double rotation, TrackingState *state) {
+		int64 start = getTickCount();
+		Square corners = markerProperties.GetCorners();
+		this->recordedRegion = Mat();
+
+		// Hopeless frames are rejected from the corners alone, before the frame is converted or warped
+		Rect bounds;
+		double waterLevel;
+		int status = this->Validate(frame.size(), rotation, markerProperties, stripeProperties, bounds);
+		if (status != WLT_STATUS_OK) {
+			if (state != NULL) {
+				state->Reset();
+			}
+
+			waterLevel = this->Reject(status);
+		} else if (this->options.latencyBudget > 0 && this->motionGate.Holds(bounds) && !this->governor.Admit()) {
+			// Only a frame of the region the held result was measured in may be skipped, a tracker shared by several markers processes the others
+			waterLevel = this->Hold();
+		} else if (this->options.motionThreshold > 0 && !this->motionGate.Check(frame, bounds)) {
+			waterLevel = this->Hold();
+		} else {
+			waterLevel = this->TrackPyramid(frame, markerProperties, stripeProperties, rotation, state);
+			this->result.level = waterLevel;
+			this->motionGate.Store(this->result, bounds);
+			if (this->options.latencyBudget > 0 && this->governor.Record((getTickCount() - start) / getTickFrequency())) {
+				this->options = this->governor.Apply(this->configuredOptions);
+			}
+		}
+
+		// Rejected and held frames are recorded as well, without a stripe region as none was extracted for them
+		if (this->recorder != NULL) {
+			const Mat &image = this->recorder->GetContent() == RecordContent::Region ? this->recordedRegion : frame;
+			int stripePixelHeight = this->recorder->GetContent() == RecordContent::Region && !this->recordedRegion.empty() ? this->recordedStripePixelHeight : stripeProperties.GetStripePixelHeight();
+			this->recorder->Record(image, corners, markerProperties, stripeProperties, stripePixelHeight, rotation, waterLevel, this->result.status);
+		}
+
+		return waterLevel;
+	}
+
+	/// <summary>
+	/// Predict the height of the water level at the coarsest pyramid level which keeps the stripes tall enough.
+	/// The OrientedRegion and FixedCamera modes fold the downscale into the resampling of the stripe region, so a coarser level only
+	/// samples fewer pixels. The geometry written to the properties is scaled back to the resolution of the frame
+	/// </summary>
+	/// <param name="frame">The captured frame of the video feed</param>
+	/// <param name="markerProperties">Properties of the measured marker</param>
+	/// <param name="stripeProperties">Properties of the striped underneath the measured marker</param>
+	/// <param name="rotation">Angle in degrees of the rotation of the marker</param>
+	/// <param name="state">The tracking state of the marker, NULL to track the frame on its own</param>
+	/// <returns>The height of the water in meters</returns>
+	double WaterLevelTracker::TrackPyramid(const Mat &frame, MarkerProperties &markerProperties, StripeProperties &stripeProperties, double rotation, TrackingState *state) {
+		int level = this->PyramidLevel(stripeProperties);
+		if (level == 0) {
+			return state == NULL ? this->TrackFrame(frame, markerProperties, stripeProperties, rotation) : this->TrackFrame(frame, markerProperties, stripeProperties, rotation, *state);
+		}
+
+		// The scale factors are restored exactly afterwards, rounding them twice would change the properties of the caller
+		double meterToPixelFactor = markerProperties.GetMeterToPixelFactor();
+		int stripePixelHeight = stripeProperties.GetStripePixelHeight();
+		ScaleGeometry(markerProperties, stripeProperties, 1.0 / (1 << level));
+		bool fullFrame = this->options.regionMode == RegionMode::FullFrame;
+		Mat scaled = fullFrame ? this->Downscale(frame, level) : frame;
+		this->pyramidLevel = fullFrame ? 0 : level;
+		double waterLevel = state == NULL ? this->TrackFrame(scaled, markerProperties, stripeProperties, rotation) : this->TrackFrame(scaled, markerProperties, stripeProperties, rotation, *state);
+		this->pyramidLevel = 0;
+		ScaleGeometry(markerProperties, stripeProperties, 1 << level);
+		markerProperties.SetMeterToPixelFactor(meterToPixelFactor);
+		stripeProperties.SetStripePixelHeight(stripePixelHeight);
+		return waterLevel;
+	}
+
+	/// <summary>
+	/// Calculate the bounds of the stripe region in the unrotated frame, without touching the pixels
+	/// </summary>
+	/// <param name="frameSize">The size of the frame</param>
+	/// <param name="rotation">Angle in degrees of the rotation of the frame</param>
+	/// <param name="markerProperties">A copy of the properties of the measured marker</param>
+	/// <param name="wide">Whether the stripe region is the wider one of the BandVote profile mode</param>
+	/// <returns>The bounds of the stripe region, empty if it lies outside the frame</returns>
+	Rect WaterLevelTracker::StripeBounds(Size frameSize, double rotation, MarkerProperties markerProperties, bool wide) {
+		Matx23d mRotation = RotationMatrix(frameSize, rotation);
+		MapRotation(markerProperties, mRotation);
+		markerProperties.ResetCenter();
+
+		// The same region ExtractOrientedRegion resamples, mapped back onto the unrotated frame
+		int left, right;
+		StripeColumns(markerProperties.GetCorners().bottomLeft.x, markerProperties.GetCorners().bottomRight.x, wide, left, right);
+		int top = markerProperties.GetCenter().y + (int)(markerProperties.GetDistanceToStripes() * markerProperties.GetMeterToPixelFactor());
+		if (right <= left || top < 0 || top >= frameSize.height) {
+			return Rect();
+		}
+
+		Matx23d inverse;
+		invertAffineTransform(mRotation, inverse);
+		Point2d corners[4] = { Point2d(left, top), Point2d(right, top), Point2d(right, frameSize.height), Point2d(left, frameSize.height) };
+		double minX = frameSize.width, minY = frameSize.height, maxX = 0, maxY = 0;
+		for (int i = 0; i < 4; i++) {
+			double x = inverse(0, 0) * corners[i].x + inverse(0, 1) * corners[i].y + inverse(0, 2);
+			double y = inverse(1, 0) * corners[i].x + inverse(1, 1) * corners[i].y + inverse(1, 2);
+			minX = std::min(minX, x);
+			minY = std::min(minY, y);
+			maxX = std::max(maxX, x);
+			maxY = std::max(maxY, y);
+		}
+
+		Rect bounds((int)floor(minX), (int)floor(minY), (int)ceil(maxX) - (int)floor(minX), (int)ceil(maxY) - (int)floor(minY));
+		return bounds & Rect(0, 0, frameSize.width, frameSize.height);
+	}
+
+	/// <summary>
+	/// Predict the height of the water level at the resolution of the given frame.
+	/// Return NULL if the the water level cannot be derived from the information
+	/// </summary>
+	/// <param name="frame">The captured frame of the video feed, possibly downscaled</param>
+	/// <param name="markerProperties">Properties of the measured marker at the resolution of the frame</param>
+	/// <param name="stripeProperties">Properties of the striped underneath the measured marker at the resolution of the frame</param>
+	/// <param name="rotation">Angle in degrees of the rotation of the marker</param>
+	/// <returns>The height of the water in meters</returns>
+	double WaterLevelTracker::TrackFrame(const Mat &frame, MarkerProperties &markerProperties, StripeProperties &stripeProperties, double rotation) {
+		WLT_TIME_STAGE(Frame);
+		Mat region = this->ExtractRegion(frame, 360 - rotation, markerProperties, stripeProperties);
+		WLT_RECORD(RecordRegion(region.cols, region.rows));
+		this->KeepRegion(region, stripeProperties);
+		return this->TrackRegion(region, stripeProperties);
+	}
+
+	/// <summary>
+	/// Predict the height of the water level at the resolution of the given frame, checking the rows around the water line of the previous frame first.
+	/// Return NULL if the the water level cannot be derived from the information
+	/// </summary>
+	/// <param name="frame">The captured frame of the video feed, possibly downscaled</param>
+	/// <param name="markerProperties">Properties of the measured marker at the resolution of the frame</param>
+	/// <param name="stripeProperties">Properties of the striped underneath the measured marker at the resolution of the frame</param>
+	/// <param name="rotation">Angle in degrees of the rotation of the marker</param>
+	/// <param name="state">The tracking state of the marker, updated with this frame</param>
+	/// <returns>The filtered height of the water in meters</returns>
+	double WaterLevelTracker::TrackFrame(const Mat &frame, MarkerProperties &markerProperties, StripeProperties &stripeProperties, double rotation, TrackingState &state) {
+		WLT_TIME_STAGE(Frame);
+		this->bottomHint = state.GetImageBottom();
+		Mat region = this->ExtractRegion(frame, 360 - rotation, markerProperties, stripeProperties);
+		this->bottomHint = -1;
+		state.SetImageBottom(this->imageBottom);
+		WLT_RECORD(RecordRegion(region.cols, region.rows));
+		this->KeepRegion(region, stripeProperties);
+		if (region.empty()) {
+			state.Reset();
+			return this->Reject(WLT_STATUS_OUTSIDE_FRAME);
+		}
+
+		double level;
+		if (!this->TrackBand(region, stripeProperties, state, level)) {
+			StripeScan scan = this->ScanRegion(region, stripeProperties.GetStripePixelHeight());
+			if (scan.valid && scan.reachedWater) {
+				state.Update(this->profileBuffer, scan.boundaryRow, scan.stripePixelHeight, true);
+			} else {
+				state.Reset();
+			}
+
+			level = this->Conclude(region, scan, stripeProperties);
+		}
+
+		return state.Filter(level, stripeProperties.GetStripeHeight());
+	}
+
+	/// <summary>
+	/// Keep the stripe region of the frame for the recorder, it is only a view on the scratch buffers
+	/// </summary>
+	/// <param name="region">The grayscale stripe region</param>
+	/// <param name="stripeProperties">Properties of the striped underneath the measured marker at the resolution of the region</param>
+	void WaterLevelTracker::KeepRegion(const Mat &region, StripeProperties &stripeProperties) {
+		if (this->recorder != NULL) {
+			this->recordedRegion = region;
+			this->recordedStripePixelHeight = stripeProperties.GetStripePixelHeight();
+		}
+	}
+
+	/// <summary>
+	/// Allocate the scratch buffers up front for frames of the given size
+	/// </summary>
+	/// <param name="frameSize">The size of the frames which will be processed</param>
+	void WaterLevelTracker::Reserve(Size frameSize) {
+		this->Scratch(this->blurBuffer, frameSize, CV_8UC1);
+		if (this->options.regionMode == RegionMode::FullFrame) {
+			this->Scratch(this->grayBuffer, frameSize, CV_8UC1);
+			this->Scratch(this->warpBuffer, frameSize, CV_8UC1);
+		} else {
+			this->Scratch(this->warpBuffer, frameSize, CV_8UC3);
+			this->Scratch(this->regionBuffer, frameSize, CV_8UC1);
+		}
+
+		if (this->options.profileMode == ProfileMode::BandVote) {
+			this->Scratch(this->integralBuffer, Size(frameSize.width + 1, frameSize.height + 1), CV_32SC1);
+		}
+	}
+
+	/// <summary>
+	/// Exchange the state this tracker keeps from frame to frame with the state of a marker, so one tracker and its scratch buffers
+	/// track many markers. Exchanging the same state again restores the state of this tracker.
+	/// The motion gate and the governor follow the options of this tracker, the quality level follows the governor of the marker
+	/// </summary>
+	/// <param name="calibrations">The calibration of every pyramid level of the marker</param>
+	/// <param name="motionGate">The motion gate of the marker</param>
+	/// <param name="governor">The latency governor of the marker</param>
+	void WaterLevelTracker::SwapMarkerState(RegionCalibration calibrations[], MotionGate &motionGate, LatencyGovernor &governor) {
+		// Only the headers of the maps and signatures are exchanged, no pixels are copied
+		std::swap_ranges(this->calibrations, this->calibrations + MaxPyramidLevel + 1, calibrations);
+		std::swap(this->motionGate, motionGate);
+		std::swap(this->governor, governor);
+		this->motionGate.SetThreshold(this->configuredOptions.motionThreshold);
+		this->motionGate.SetForceInterval(this->configuredOptions.motionInterval);
+		this->motionGate.SetRegionTolerance(this->configuredOptions.cornerTolerance);
+		if (this->governor.GetBudget() != this->configuredOptions.latencyBudget) {
+			this->governor.SetBudget(this->configuredOptions.latencyBudget);
+		}
+
+		this->options = this->governor.Apply(this->configuredOptions);
+	}
+
+	/// <summary>
+	/// Gets the options
+	/// </summary>
+	TrackerOptions WaterLevelTracker::GetOptions() {
+		return this->configuredOptions;
+	}
+
+	/// <summary>
+	/// Sets the options
+	/// </summary>
+	void WaterLevelTracker::SetOptions(TrackerOptions options) {
+		TrackerOptions previous = this->options;
+		this->configuredOptions = options;
+		this->governor.SetBudget(options.latencyBudget);
+		this->options = this->governor.Apply(options);
+
+		// The calibrated region follows from these options, the FixedCamera mode has to calculate it again when one changes
+		bool wide = this->options.profileMode == ProfileMode::BandVote;
+		if (this->options.regionMode != previous.regionMode || wide != (previous.profileMode == ProfileMode::BandVote)
+			|| this->options.angleStep != previous.angleStep || this->options.cornerTolerance != previous.cornerTolerance) {
+			for (RegionCalibration &calibration : this->calibrations) {
+				calibration.valid = false;
+			}
+		}
+
+		this->motionGate.SetThreshold(options.motionThreshold);
+		this->motionGate.SetForceInterval(options.motionInterval);
+		this->motionGate.SetRegionTolerance(options.cornerTolerance);
+	}
+
+	/// <summary>
+	/// Gets the amount of times a scratch buffer of this tracker had to be allocated.
+	/// Once the buffers fit the frames this stays constant. It only counts the growth of these buffers, OpenCV may still allocate
+	/// temporaries of its own inside the blur, the warp and the color conversion.
+	/// </summary>
+	int WaterLevelTracker::GetAllocationCount() {
+		return this->allocationCount;
+	}
+
+	/// <summary>
+	/// Gets the amount of times the FixedCamera mode had to calculate the geometry of the stripe region
+	/// </summary>
+	int WaterLevelTracker::GetCalibrationCount() {
+		return this->calibrationCount;
+	}
+
+	/// <summary>
+	/// Gets the amount of frames which returned the level of the last processed frame because their stripe region did not change
+	/// </summary>
+	long long WaterLevelTracker::GetSkippedCount() {
+		return this->motionGate.GetSkippedCount();
+	}
+
+	/// <summary>
+	/// Gets the quality level the latency budget currently allows, 0 when frames are processed as configured
+	/// </summary>
+	int WaterLevelTracker::GetQualityLevel() {
+		return this->governor.GetQualityLevel();
+	}
+
+	/// <summary>
+	/// Gets the amount of frames which returned the level of the last processed frame to stay within the latency budget
+	/// </summary>
+	long long WaterLevelTracker::GetBudgetSkippedCount() {
+		return this->governor.GetSkippedCount();
+	}
+
+	/// <summary>
+	/// Sets the recorder every processed frame is appended to, NULL to stop recording. The recorder is not owned by the tracker
+	/// </summary>
+	void WaterLevelTracker::SetRecorder(FrameRecorder *recorder) {
+		this->recorder = recorder;
+		this->recordedRegion = Mat();
+	}
+
+	/// <summary>
+	/// Gets a view of the given size on a scratch buffer, which is only allocated when it is too small.
+	/// The view is a continuous header without a parent, so filters never read the stale pixels of an earlier, larger frame around it.
+	/// </summary>
+	/// <param name="buffer">The scratch buffer</param>
+	/// <param name="size">The size of the view</param>
+	/// <param name="type">The type of the pixels</param>
+	/// <returns>The view on the scratch buffer</returns>
+	Mat WaterLevelTracker::Scratch(Mat &buffer, Size size, int type) {
+		if (buffer.type() != type || buffer.cols < size.width || buffer.rows < size.height) {
+			buffer.create(std::max(buffer.rows, size.height), std::max(buffer.cols, size.width), type);
+			this->allocationCount++;
+		}
+
+		// A ROI of the buffer would let GaussianBlur and the fused kernel read the pixels right of and below it, which were left by an earlier frame
+		return Mat(size, type, buffer.data);
+	}
+
+	/// <summary>
+	/// Gets the amount of times the frame can be halved while the stripes stay at least the minimum height of the options
+	/// </summary>
+	/// <param name="stripeProperties">Properties of the striped underneath the measured marker</param>
+	/// <returns>The pyramid level, 0 for full resolution</returns>
+	int WaterLevelTracker::PyramidLevel(StripeProperties &stripeProperties) {
+		int level = 0;
+		if (this->options.minStripePixelHeight <= 0) {
+			return level;
+		}
+
+		while (level < MaxPyramidLevel && (stripeProperties.GetStripePixelHeight() >> (level + 1)) >= this->options.minStripePixelHeight) {
+			level++;
+		}
+
+		return level;
+	}
+
+	/// <summary>
+	/// Downscale the frame by a power of two, averaging the pixels of every block
+	/// </summary>
+	/// <param name="frame">The captured frame of the video feed</param>
+	/// <param name="level">The pyramid level, the frame is halved this many times</param>
+	/// <returns>The downscaled frame</returns>
+	Mat WaterLevelTracker::Downscale(const Mat &frame, int level) {
+		WLT_TIME_STAGE(Warp);
+		Size size = PyramidSize(frame.size(), level);
+		Mat scaled = this->Scratch(this->pyramidBuffer, size, frame.type());
+		cv::resize(frame, scaled, size, 0, 0, INTER_AREA);
+		return scaled;
+	}
+
+	/// <summary>
+	/// Gets the size of a frame at a pyramid level
+	/// </summary>
+	/// <param name="frameSize">The size of the frame at full resolution</param>
+	/// <param name="level">The pyramid level</param>
+	/// <returns>The size of the downscaled frame</returns>
+	Size WaterLevelTracker::PyramidSize(Size frameSize, int level) {
+		return Size(std::max(frameSize.width >> level, 1), std::max(frameSize.height >> level, 1));
+	}
+
+	/// <summary>
+	/// Gets the step between the sampled columns of a stripe region, the column step of the options as far as the width allows
+	/// </summary>
+	/// <param name="width">The width in pixels of the stripe region</param>
+	/// <returns>The column step</returns>
+	int WaterLevelTracker::RegionColumnStep(int width) {
+		return std::max(std::min(this->options.columnStep, width / MinRegionColumns), 1);
+	}
+
+	/// <summary>
+	/// Scale the pixel geometry of the marker and the stripes
+	/// </summary>
+	/// <param name="markerProperties">Properties of the measured marker</param>
+	/// <param name="stripeProperties">Properties of the striped underneath the measured marker</param>
+	/// <param name="factor">The scale factor</param>
+	void WaterLevelTracker::ScaleGeometry(MarkerProperties &markerProperties, StripeProperties &stripeProperties, double factor) {
+		Square corners = markerProperties.GetCorners();
+		corners.bottomLeft = Point(cvRound(corners.bottomLeft.x * factor), cvRound(corners.bottomLeft.y * factor));
+		corners.bottomRight = Point(cvRound(corners.bottomRight.x * factor), cvRound(corners.bottomRight.y * factor));
+		corners.topRight = Point(cvRound(corners.topRight.x * factor), cvRound(corners.topRight.y * factor));
+		corners.topLeft = Point(cvRound(corners.topLeft.x * factor), cvRound(corners.topLeft.y * factor));
+		markerProperties.SetCorners(corners);
+		markerProperties.SetCenter(Point(cvRound(markerProperties.GetCenter().x * factor), cvRound(markerProperties.GetCenter().y * factor)));
+		markerProperties.SetMeterToPixelFactor(markerProperties.GetMeterToPixelFactor() * factor);
+		stripeProperties.SetStripePixelHeight(cvRound(stripeProperties.GetStripePixelHeight() * factor));
+		stripeProperties.SetStripePixelStart(cvRound(stripeProperties.GetStripePixelStart() * factor));
+	}
+
+	/// <summary>
+	/// Gets the color conversion code which converts frames with the channel order of the options to grayscale
+	/// </summary>
+	/// <param name="options">The options which select how frames are processed</param>
+	/// <returns>The color conversion code</returns>
+	int WaterLevelTracker::GrayConversion(const TrackerOptions &options) {
+		return options.channelOrder == ChannelOrder::Bgr ? COLOR_BGR2GRAY : COLOR_RGB2GRAY;
+	}
+
+	/// <summary>
+	/// Convert the frame to grayscale, a frame which already is grayscale is returned as is
+	/// </summary>
+	/// <param name="frame">The captured frame of the video feed</param>
+	/// <returns>The grayscale frame</returns>
+	Mat WaterLevelTracker::ConvertToGray(const Mat &frame) {
+		if (frame.channels() == 1) {
+			return frame;
+		}
+
+		WLT_TIME_STAGE(Gray);
+		Mat gray = this->Scratch(this->grayBuffer, frame.size(), CV_8UC1);
+		cvtColor(frame, gray, GrayConversion(this->options));
+		return gray;
+	}
+
+	/// <summary>
+	/// Straighten the area underneath the marker that contains the stripes.
+	/// Return an empty region if the stripe region lies outside the frame
+	/// </summary>
+	/// <param name="frame">The captured frame of the video feed</param>
+	/// <param name="rotation">Angle in degrees of the rotation of the marker</param>
+	/// <param name="markerProperties">Properties of the measured marker</param>
+	/// <param name="stripeProperties">Properties of the striped underneath the measured marker</param>
+	/// <returns>The grayscale stripe region</returns>
+	Mat WaterLevelTracker::ExtractRegion(const Mat &frame, double rotation, MarkerProperties &markerProperties, StripeProperties &stripeProperties) {
+		Mat region;
+		if (this->options.regionMode == RegionMode::OrientedRegion) {
+			this->ExtractOrientedRegion(frame, rotation, markerProperties, stripeProperties, region);
+			return region;
+		}
+
+		if (this->options.regionMode == RegionMode::FixedCamera) {
+			this->ExtractCalibratedRegion(frame, rotation, markerProperties, stripeProperties, region);
+			return region;
+		}
+
+		int imageBottom = this->Rotate(this->ConvertToGray(frame), rotation, markerProperties, region);
 		stripeProperties.SetStripePixelStart(markerProperties.GetCenter().y + (int)(markerProperties.GetDistanceToStripes() * markerProperties.GetMeterToPixelFactor()));
-		Crop(frame, markerProperties.GetCorners().bottomLeft.x, markerProperties.GetCorners().bottomRight.x, stripeProperties.GetStripePixelStart(), imageBottom);
-		Blur(frame);
-		Segment(frame);
-		return StripeCount(frame, stripeProperties);
+		Crop(region, markerProperties.GetCorners().bottomLeft.x, markerProperties.GetCorners().bottomRight.x, stripeProperties.GetStripePixelStart(), imageBottom, this->options.profileMode == ProfileMode::BandVote);
+		return region;
 	}
 
 	/// <summary>
 	/// Perform a smoothing on the image using a Gaussian blur.
 	/// </summary>
-	/// <param name="frame">The captured frame of the video feed</param>
-	void WaterLevelTracker::Blur(Mat &frame) {
-		GaussianBlur(frame, frame, Size(5, 5), 0);
+	/// <param name="region">The stripe region</param>
+	/// <returns>The blurred stripe region</returns>
+	Mat WaterLevelTracker::Blur(const Mat &region) {
+		WLT_TIME_STAGE(Blur);
+		Mat blurred = this->Scratch(this->blurBuffer, region.size(), CV_8UC1);
+		GaussianBlur(region, blurred, Size(this->options.blurSize, this->options.blurSize), 0);
+		return blurred;
 	}
 
 	/// <summary>
@@ -41,47 +607,437 @@ namespace waterleveltracking {
 	/// <param name="bottomRightCornerX">The x of the bottom right corner of the marker</param>
 	/// <param name="stripePixelStart">The starting pixel of the highest stripe</param>
 		/// <param name="bottom"> The bottom pixel to crop on</param>
-	void WaterLevelTracker::Crop(Mat &frame, int bottomLeftCornerX, int bottomRightCornerX, int stripePixelStart, int bottom) {
-		int left = bottomLeftCornerX + (bottomRightCornerX - bottomLeftCornerX) / 3;
-		int right = bottomLeftCornerX + ((bottomRightCornerX - bottomLeftCornerX) / 3) * 2;
-		frame = frame(Rect(left, stripePixelStart, right - left, bottom - stripePixelStart));
+	/// <param name="wide">Whether to keep the wider area the BandVote profile mode votes over instead of the middle third</param>
+	void WaterLevelTracker::Crop(Mat &frame, int bottomLeftCornerX, int bottomRightCornerX, int stripePixelStart, int bottom, bool wide) {
+		int left, right;
+		StripeColumns(bottomLeftCornerX, bottomRightCornerX, wide, left, right);
+
+		// Clip to the frame, a marker near the edge would otherwise give a region which partly lies outside it
+		frame = frame(Rect(left, stripePixelStart, right - left, bottom - stripePixelStart) & Rect(0, 0, frame.cols, frame.rows));
 	}
 
 	/// <summary>
-	/// Perform a smoothing on the image using a Gaussian blur.
+	/// Reduce the stripe region to one verdict per row in the way selected by the profile mode of the options
 	/// </summary>
-	/// <param name="frame">The captured frame of the video feed</param>
-	void WaterLevelTracker::Segment(Mat &frame) {
-		cv::threshold(frame, frame, 150, 255, 0);
-		for (int row = 0; row < frame.rows; row++) {
-			int count = 0;
-			for (int col = 0; col < frame.cols; col++) {
-				count += frame.at<uchar>(row, col);
+	/// <param name="region">The grayscale stripe region</param>
+	/// <param name="profile">Receives 255 for every row of a white stripe and 0 for every other row</param>
+	void WaterLevelTracker::SegmentRegion(const Mat &region, std::vector<uchar> &profile) {
+		this->Scratch(profile, region.rows);
+		if (this->options.profileMode == ProfileMode::Region) {
+			if (region.rows > 0) {
+				WLT_TIME_STAGE(Segment);
+				this->Scratch(this->columnBuffer, region.cols + 4);
+				this->columnBuffer.resize(region.cols + 4);
+				profile.resize(region.rows);
+				if (FusedSegment(region, this->options, &profile[0], &this->columnBuffer[0])) {
+					return;
+				}
+			}
+
+			Segment(this->Blur(region), profile, this->options.threshold);
+			return;
+		}
+
+		// Only the reduction touches every pixel, smoothing and thresholding work on one value per row.
+		// The BandVote mode segments its bands with SegmentBands, a single profile of it is the mean of the whole row
+		WLT_TIME_STAGE(Segment);
+		this->Scratch(this->intensityBuffer, region.rows);
+		this->Scratch(this->smoothBuffer, region.rows);
+		if (this->options.profileMode == ProfileMode::RowTrimmedMean) {
+			this->Scratch(this->rowBuffer, region.cols);
+			RowProfile::TrimmedMean(region, this->intensityBuffer, this->rowBuffer);
+		} else {
+			RowProfile::Mean(region, this->intensityBuffer);
+		}
+
+		RowProfile::Blur(this->intensityBuffer, this->smoothBuffer);
+		RowProfile::Threshold(this->smoothBuffer, (float)this->options.threshold, profile);
+	}
+
+	/// <summary>
+	/// Split the stripe region into the vertical bands of the options and decide per row of every band whether it belongs to a white stripe.
+	/// The mean of every band row is taken from one integral image of the region, so a band row costs the same for any band width.
+	/// </summary>
+	/// <param name="region">The grayscale stripe region</param>
+	/// <param name="profiles">Receives the row profiles of the bands one after the other, each with one verdict per row</param>
+	void WaterLevelTracker::SegmentBands(const Mat &region, std::vector<uchar> &profiles) {
+		WLT_TIME_STAGE(Segment);
+		int bandCount = std::max(std::min(std::min(this->options.bandCount, region.cols), (int)MaxBandCount), 1);
+		this->Scratch(profiles, (size_t)bandCount * region.rows);
+		profiles.resize((size_t)bandCount * region.rows);
+		if (region.rows == 0) {
+			return;
+		}
+
+		Mat sums = this->Scratch(this->integralBuffer, Size(region.cols + 1, region.rows + 1), CV_32SC1);
+		integral(region, sums, CV_32S);
+		this->Scratch(this->intensityBuffer, region.rows);
+		this->Scratch(this->smoothBuffer, region.rows);
+		this->Scratch(this->bandBuffer, region.rows);
+		this->intensityBuffer.resize(region.rows);
+		for (int band = 0; band < bandCount; band++) {
+			int left = (band * region.cols) / bandCount;
+			int right = ((band + 1) * region.cols) / bandCount;
+			float width = (float)(right - left);
+			for (int row = 0; row < region.rows; row++) {
+				const int *above = sums.ptr<int>(row);
+				const int *below = sums.ptr<int>(row + 1);
+				this->intensityBuffer[row] = (below[right] - below[left] - above[right] + above[left]) / width;
 			}
 
-			frame.at<uchar>(row, 0) = (count / 255) >= ((frame.cols) * 0.45) ? 255 : 0;
+			RowProfile::Blur(this->intensityBuffer, this->smoothBuffer);
+			RowProfile::Threshold(this->smoothBuffer, (float)this->options.threshold, this->bandBuffer);
+			std::copy(this->bandBuffer.begin(), this->bandBuffer.end(), profiles.begin() + ((size_t)band * region.rows));
+		}
+	}
+
+	/// <summary>
+	/// Threshold the blurred stripe region and decide per row whether it belongs to a white stripe.
+	/// </summary>
+	/// <param name="frame">The blurred stripe region</param>
+	/// <param name="profile">Receives 255 for every row of a white stripe and 0 for every other row</param>
+	/// <param name="threshold">The intensity above which a pixel counts as white</param>
+	void WaterLevelTracker::Segment(const Mat &frame, std::vector<uchar> &profile, int threshold) {
+		WLT_TIME_STAGE(Segment);
+		profile.resize(frame.rows);
+		if (frame.rows > 0) {
+			SegmentKernels::ThresholdRowProjection(frame.data, frame.step, frame.rows, frame.cols, (unsigned char)threshold, &profile[0]);
 		}
 	}
 
 	/// <summary>
 	/// Map the corners of the marker to the new corners in the rotated image
 	/// </summary>
-	/// <param name="frame">The captured frame of the video feed</param>
+	/// <param name="frame">The grayscale frame of the video feed</param>
 	/// <param name="rotation">Angle in degrees of the rotation of the marker</param>
 	/// <param name="markerProperties">Properties of the measured marker</param>
+	/// <param name="rotated">The rotated frame</param>
 	/// <returns>Return the y of the last pixel that should be iterated or the bottom</returns>
-	int WaterLevelTracker::Rotate(Mat &frame, double rotation, MarkerProperties &markerProperties) {
-		Mat mRotation = getRotationMatrix2D(Point((frame.cols / 2) - 1, (frame.rows / 2) - 1), rotation, 1);
-		cv::warpAffine(frame, frame, mRotation, frame.size());
+	int WaterLevelTracker::Rotate(const Mat &frame, double rotation, MarkerProperties &markerProperties, Mat &rotated) {
+		Matx23d mRotation = RotationMatrix(frame.size(), rotation);
+		rotated = this->Scratch(this->warpBuffer, frame.size(), CV_8UC1);
+		{
+			WLT_TIME_STAGE(Warp);
+			cv::warpAffine(frame, rotated, mRotation, frame.size());
+		}
+
+		MapRotation(markerProperties, mRotation);
+		markerProperties.ResetCenter();
+		// A marker at the edge of the frame can have its center outside the rotated frame
+		int column = std::min(std::max(markerProperties.GetCenter().x, 0), rotated.cols - 1);
+		this->imageBottom = FindBottom(rotated, column, this->bottomHint);
+		return this->imageBottom;
+	}
+
+	/// <summary>
+	/// Resample the oriented stripe region underneath the marker straight from the unrotated frame.
+	/// The region is converted to grayscale and ends at the bottom of the image.
+	/// </summary>
+	/// <param name="frame">The captured frame of the video feed</param>
+	/// <param name="rotation">Angle in degrees of the rotation of the marker</param>
+	/// <param name="markerProperties">Properties of the measured marker</param>
+	/// <param name="stripeProperties">Properties of the striped underneath the measured marker</param>
+	/// <param name="region">The grayscale stripe region</param>
+	/// <returns>False if the stripe region lies outside the frame</returns>
+	bool WaterLevelTracker::ExtractOrientedRegion(const Mat &frame, double rotation, MarkerProperties &markerProperties, StripeProperties &stripeProperties, Mat &region) {
+		// The geometry is at the pyramid level, the pixels are sampled from the frame at full resolution
+		Size frameSize = PyramidSize(frame.size(), this->pyramidLevel);
+		Matx23d mRotation = RotationMatrix(frameSize, rotation);
+		MapRotation(markerProperties, mRotation);
+		markerProperties.ResetCenter();
+		stripeProperties.SetStripePixelStart(markerProperties.GetCenter().y + (int)(markerProperties.GetDistanceToStripes() * markerProperties.GetMeterToPixelFactor()));
+
+		// The same region Crop takes out of the rotated frame, in rotated frame coordinates
+		int left, right;
+		StripeColumns(markerProperties.GetCorners().bottomLeft.x, markerProperties.GetCorners().bottomRight.x, this->options.profileMode == ProfileMode::BandVote, left, right);
+		int top = stripeProperties.GetStripePixelStart();
+		if (right <= left || top < 0 || top >= frameSize.height) {
+			return false;
+		}
+
+		// Shift the rotation so the top left of the region lands on the origin and only warp the region
+		mRotation(0, 2) -= left;
+		mRotation(1, 2) -= top;
+		int columnStep = this->RegionColumnStep(right - left);
+		Size regionSize((right - left + columnStep - 1) / columnStep, frameSize.height - top);
+		Mat warped = this->Scratch(this->warpBuffer, regionSize, frame.type());
+		{
+			WLT_TIME_STAGE(Warp);
+			cv::warpAffine(frame, warped, SampleMatrix(mRotation, this->pyramidLevel, columnStep), regionSize);
+		}
+
+		if (warped.channels() == 1) {
+			region = warped;
+		} else {
+			WLT_TIME_STAGE(Gray);
+			region = this->Scratch(this->regionBuffer, regionSize, CV_8UC1);
+			cvtColor(warped, region, GrayConversion(this->options));
+		}
+
+		int column = std::min(std::max((markerProperties.GetCenter().x - left) / columnStep, 0), region.cols - 1);
+		int bottom = FindBottom(region, column, this->bottomHint);
+		this->imageBottom = bottom;
+		if (bottom == 0) {
+			region = Mat();
+			return false;
+		}
+
+		region = region.rowRange(0, bottom);
+		return true;
+	}
+
+	/// <summary>
+	/// Resample the oriented stripe region underneath the marker with the cached calibration, calculating it first if it does not fit the frame.
+	/// The geometry of the marker and the stripes is taken from the calibration.
+	/// </summary>
+	/// <param name="frame">The captured frame of the video feed</param>
+	/// <param name="rotation">Angle in degrees of the rotation of the marker</param>
+	/// <param name="markerProperties">Properties of the measured marker</param>
+	/// <param name="stripeProperties">Properties of the striped underneath the measured marker</param>
+	/// <param name="region">The grayscale stripe region</param>
+	/// <returns>False if the stripe region lies outside the frame</returns>
+	bool WaterLevelTracker::ExtractCalibratedRegion(const Mat &frame, double rotation, MarkerProperties &markerProperties, StripeProperties &stripeProperties, Mat &region) {
+		if (this->options.angleStep > 0) {
+			rotation = std::round(rotation / this->options.angleStep) * this->options.angleStep;
+		}
+
+		if (!this->IsCalibrated(frame.size(), rotation, markerProperties)) {
+			this->Calibrate(frame.size(), rotation, markerProperties);
+		}
+
+		RegionCalibration &calibration = this->calibrations[this->pyramidLevel];
+		markerProperties.SetCorners(calibration.corners);
+		markerProperties.SetCenter(calibration.center);
+		stripeProperties.SetStripePixelStart(calibration.stripePixelStart);
+		this->imageBottom = calibration.bottom;
+		if (calibration.bottom == 0) {
+			region = Mat();
+			return false;
+		}
+
+		Mat remapped = this->Scratch(this->warpBuffer, calibration.map.size(), frame.type());
+		{
+			WLT_TIME_STAGE(Warp);
+			cv::remap(frame, remapped, calibration.map, calibration.mapFraction, INTER_LINEAR);
+		}
+
+		if (remapped.channels() == 1) {
+			region = remapped;
+		} else {
+			WLT_TIME_STAGE(Gray);
+			region = this->Scratch(this->regionBuffer, remapped.size(), CV_8UC1);
+			cvtColor(remapped, region, GrayConversion(this->options));
+		}
+
+		return true;
+	}
+
+	/// <summary>
+	/// Check whether the cached calibration fits the frame size, the rotation and the position of the marker
+	/// </summary>
+	/// <param name="frameSize">The size of the frame</param>
+	/// <param name="rotation">The quantized angle in degrees of the rotation of the marker</param>
+	/// <param name="markerProperties">Properties of the measured marker</param>
+	/// <returns>True if the calibration can be used</returns>
+	bool WaterLevelTracker::IsCalibrated(Size frameSize, double rotation, MarkerProperties &markerProperties) {
+		RegionCalibration &calibration = this->calibrations[this->pyramidLevel];
+		if (!calibration.valid || calibration.frameSize != frameSize || calibration.rotation != rotation || calibration.columnStep != this->options.columnStep
+			|| calibration.wide != (this->options.profileMode == ProfileMode::BandVote)) {
+			return false;
+		}
+
+		Square corners = markerProperties.GetCorners();
+		Point moves[] = {
+			corners.bottomLeft - calibration.sourceCorners.bottomLeft,
+			corners.bottomRight - calibration.sourceCorners.bottomRight,
+			corners.topRight - calibration.sourceCorners.topRight,
+			corners.topLeft - calibration.sourceCorners.topLeft
+		};
+		for (const Point &move : moves) {
+			if (abs(move.x) > this->options.cornerTolerance || abs(move.y) > this->options.cornerTolerance) {
+				return false;
+			}
+		}
+
+		return true;
+	}
+
+	/// <summary>
+	/// Calculate the geometry of the stripe region at the pyramid level and the table which resamples it from the unrotated frame
+	/// at full resolution
+	/// </summary>
+	/// <param name="frameSize">The size of the frame</param>
+	/// <param name="rotation">The quantized angle in degrees of the rotation of the marker</param>
+	/// <param name="markerProperties">Properties of the measured marker</param>
+	void WaterLevelTracker::Calibrate(Size frameSize, double rotation, MarkerProperties &markerProperties) {
+		RegionCalibration &calibration = this->calibrations[this->pyramidLevel];
+		calibration.valid = true;
+		calibration.frameSize = frameSize;
+		calibration.rotation = rotation;
+		calibration.columnStep = this->options.columnStep;
+		calibration.wide = this->options.profileMode == ProfileMode::BandVote;
+		calibration.sourceCorners = markerProperties.GetCorners();
+		calibration.bottom = 0;
+		this->calibrationCount++;
+
+		Size levelSize = PyramidSize(frameSize, this->pyramidLevel);
+		Matx23d mRotation = RotationMatrix(levelSize, rotation);
 		MapRotation(markerProperties, mRotation);
 		markerProperties.ResetCenter();
-		for (int row = frame.rows - 1; row >= 0; row--) {
-			if (frame.at<uchar>(row, markerProperties.GetCenter().x) != 0.0f) {
+		calibration.corners = markerProperties.GetCorners();
+		calibration.center = markerProperties.GetCenter();
+		calibration.stripePixelStart = calibration.center.y + (int)(markerProperties.GetDistanceToStripes() * markerProperties.GetMeterToPixelFactor());
+
+		// The same region as ExtractOrientedRegion resamples
+		int left, right;
+		StripeColumns(calibration.corners.bottomLeft.x, calibration.corners.bottomRight.x, this->options.profileMode == ProfileMode::BandVote, left, right);
+		int top = calibration.stripePixelStart;
+		if (right <= left || top < 0 || top >= levelSize.height) {
+			return;
+		}
+
+		mRotation(0, 2) -= left;
+		mRotation(1, 2) -= top;
+		int columnStep = this->RegionColumnStep(right - left);
+		Matx23d inverse;
+		invertAffineTransform(SampleMatrix(mRotation, this->pyramidLevel, columnStep), inverse);
+
+		// The region ends above the last row where the marker center column still samples inside the frame
+		int width = (right - left + columnStep - 1) / columnStep;
+		int column = std::min(std::max((calibration.center.x - left) / columnStep, 0), width - 1);
+		for (int row = levelSize.height - top - 1; row >= 0; row--) {
+			double x = inverse(0, 0) * column + inverse(0, 1) * row + inverse(0, 2);
+			double y = inverse(1, 0) * column + inverse(1, 1) * row + inverse(1, 2);
+			if (x >= 0 && x <= frameSize.width - 1 && y >= 0 && y <= frameSize.height - 1) {
+				calibration.bottom = row;
+				break;
+			}
+		}
+
+		if (calibration.bottom == 0) {
+			return;
+		}
+
+		Mat sources(calibration.bottom, width, CV_32FC2);
+		for (int row = 0; row < sources.rows; row++) {
+			Vec2f *source = sources.ptr<Vec2f>(row);
+			for (int x = 0; x < width; x++) {
+				source[x] = Vec2f((float)(inverse(0, 0) * x + inverse(0, 1) * row + inverse(0, 2)), (float)(inverse(1, 0) * x + inverse(1, 1) * row + inverse(1, 2)));
+			}
+		}
+
+		convertMaps(sources, noArray(), calibration.map, calibration.mapFraction, CV_16SC2);
+	}
+
+	/// <summary>
+	/// Segment only the rows around the water line of the previous frame and count the stripes with the rows above taken from that frame
+	/// </summary>
+	/// <param name="region">The grayscale stripe region</param>
+	/// <param name="stripeProperties">The properties of the measured striped input</param>
+	/// <param name="state">The tracking state of the marker</param>
+	/// <param name="level">The height of the water in meters if the water line was found around the previous one</param>
+	/// <returns>False if the water line was not found around the previous one</returns>
+	bool WaterLevelTracker::TrackBand(const Mat &region, StripeProperties &stripeProperties, TrackingState &state, double &level) {
+		if (this->options.profileMode == ProfileMode::BandVote || !state.CanTrack(region.rows)) {
+			return false;
+		}
+
+		int stripeHeight = std::max(state.GetStripePixelHeight(), 1);
+		int bandStart = std::max(state.GetBoundaryRow() - (2 * stripeHeight), 0);
+		int bandEnd = std::min(state.GetBoundaryRow() + (3 * stripeHeight), region.rows);
+
+		// Two extra rows on both sides give the band rows the same smoothing as when the whole region is segmented
+		int from = std::max(bandStart - 2, 0);
+		int to = std::min(bandEnd + 2, region.rows);
+		this->SegmentRegion(region.rowRange(from, to), this->bandBuffer);
+		this->Scratch(this->profileBuffer, region.rows);
+		this->profileBuffer.assign(state.GetProfile().begin(), state.GetProfile().end());
+		std::copy(this->bandBuffer.begin() + (bandStart - from), this->bandBuffer.begin() + (bandEnd - from), this->profileBuffer.begin() + bandStart);
+
+		// Only trust the count if the water line is still well inside the band
+		StripeScan scan = ScanStripes(this->profileBuffer, stripeProperties.GetStripePixelHeight());
+		if (!scan.valid || !scan.reachedWater || scan.boundaryRow < bandStart + stripeHeight || scan.boundaryRow >= bandEnd - stripeHeight) {
+			return false;
+		}
+
+		state.Update(this->profileBuffer, scan.boundaryRow, scan.stripePixelHeight, false);
+		level = this->Conclude(region, scan, stripeProperties);
+		return true;
+	}
+
+	/// <summary>
+	/// Find the last row of the image which is not black in the given column.
+	/// The expected row is kept if a run of black rows follows it and the last row is black, so a dark pixel or a noisy row right
+	/// below it does not cut the region short. Otherwise the whole column is scanned
+	/// </summary>
+	/// <param name="image">The grayscale image</param>
+	/// <param name="column">The column to search</param>
+	/// <param name="hint">The expected row, -1 if unknown</param>
+	/// <returns>The last row which is not black, or the amount of rows if every row is black</returns>
+	int WaterLevelTracker::FindBottom(const Mat &image, int column, int hint) {
+		WLT_TIME_STAGE(BottomScan);
+		if (hint >= 0 && hint < image.rows && image.at<uchar>(hint, column) != 0 && (hint == image.rows - 1 || image.at<uchar>(image.rows - 1, column) == 0)) {
+			int end = std::min(hint + BottomRunLength, image.rows - 1);
+			int row = hint + 1;
+			while (row <= end && image.at<uchar>(row, column) == 0) {
+				row++;
+			}
+
+			if (row > end) {
+				return hint;
+			}
+		}
+
+		for (int row = image.rows - 1; row >= 0; row--) {
+			if (image.at<uchar>(row, column) != 0) {
 				return row;
 			}
 		}
 
-		return frame.rows;
+		return image.rows;
+	}
+
+	/// <summary>
+	/// Build the matrix which rotates a frame around its center
+	/// </summary>
+	/// <param name="frameSize">The size of the frame</param>
+	/// <param name="rotation">Angle in degrees of the rotation</param>
+	/// <returns>The 2x3 affine rotation matrix</returns>
+	Matx23d WaterLevelTracker::RotationMatrix(Size frameSize, double rotation) {
+		// Same matrix as getRotationMatrix2D with a scale of 1, without allocating a Mat
+		double centerX = (frameSize.width / 2) - 1;
+		double centerY = (frameSize.height / 2) - 1;
+		double angle = rotation * CV_PI / 180;
+		double alpha = cos(angle);
+		double beta = sin(angle);
+		return Matx23d(
+			alpha, beta, ((1 - alpha) * centerX) - (beta * centerY),
+			-beta, alpha, (beta * centerX) + ((1 - alpha) * centerY));
+	}
+
+	/// <summary>
+	/// Build the matrix which samples the stripe region straight from the frame at full resolution: the pixels of the frame are
+	/// mapped onto the pyramid level, the region matrix maps them into the region and every column step columns of the region
+	/// are merged into one. Every sample lies at the middle of the pixels it stands for
+	/// </summary>
+	/// <param name="regionMatrix">The matrix which maps the frame at the pyramid level onto the stripe region</param>
+	/// <param name="level">The pyramid level</param>
+	/// <param name="columnStep">The step between the sampled columns of the stripe region</param>
+	/// <returns>The 2x3 affine matrix which maps the frame at full resolution onto the sampled stripe region</returns>
+	Matx23d WaterLevelTracker::SampleMatrix(const Matx23d &regionMatrix, int level, int columnStep) {
+		// A downscaled pixel covers a block of the frame and lies at the middle of it, a sampled column at the middle of the merged ones
+		double block = 1 << level;
+		double blockCenter = (block - 1) / 2;
+		Matx23d matrix;
+		for (int row = 0; row < 2; row++) {
+			double scale = row == 0 ? 1.0 / columnStep : 1.0;
+			double stepCenter = row == 0 ? (columnStep - 1) / 2.0 : 0;
+			matrix(row, 0) = scale * regionMatrix(row, 0) / block;
+			matrix(row, 1) = scale * regionMatrix(row, 1) / block;
+			matrix(row, 2) = scale * (regionMatrix(row, 2) - stepCenter - ((regionMatrix(row, 0) + regionMatrix(row, 1)) * blockCenter / block));
+		}
+
+		return matrix;
 	}
 
 	/// <summary>
@@ -89,51 +1045,318 @@ namespace waterleveltracking {
 	/// </summary>
 	/// <param name="corners">The marker corner input</param>
 	/// <param name="rotationMatrix">The rotation matrix used for the entire image</param>
-	void WaterLevelTracker::MapRotation(MarkerProperties &markerProperties, Mat &rotationMatrix) {
-		Mat cornerPoints = rotationMatrix * (Mat_<double>(3, 4) <<
-			markerProperties.GetCorners().bottomLeft.x, markerProperties.GetCorners().bottomRight.x, markerProperties.GetCorners().topRight.x, markerProperties.GetCorners().topLeft.x,
-			markerProperties.GetCorners().bottomLeft.y, markerProperties.GetCorners().bottomRight.y, markerProperties.GetCorners().topRight.y, markerProperties.GetCorners().topLeft.y,
-			1, 1, 1, 1);
-		Square newCorners;
-		newCorners.bottomLeft = Point((int)cornerPoints.at<double>(0, 0), (int)cornerPoints.at<double>(1, 0));
-		newCorners.bottomRight = Point((int)cornerPoints.at<double>(0, 1), (int)cornerPoints.at<double>(1, 1));
-		newCorners.topRight = Point((int)cornerPoints.at<double>(0, 2), (int)cornerPoints.at<double>(1, 2));
-		newCorners.topLeft = Point((int)cornerPoints.at<double>(0, 3), (int)cornerPoints.at<double>(1, 3));
-		markerProperties.SetCorners(newCorners);
+	void WaterLevelTracker::MapRotation(MarkerProperties &markerProperties, const Matx23d &rotationMatrix) {
+		Square corners = markerProperties.GetCorners();
+		Point *points[] = { &corners.bottomLeft, &corners.bottomRight, &corners.topRight, &corners.topLeft };
+		for (int i = 0; i < 4; i++) {
+			double x = points[i]->x;
+			double y = points[i]->y;
+			*points[i] = Point(
+				(int)((rotationMatrix(0, 0) * x) + (rotationMatrix(0, 1) * y) + rotationMatrix(0, 2)),
+				(int)((rotationMatrix(1, 0) * x) + (rotationMatrix(1, 1) * y) + rotationMatrix(1, 2)));
+		}
+
+		markerProperties.SetCorners(corners);
 	}
 
 	/// <summary>
 	/// Count the number of measured striped and return the water level height.
 	/// </summary>
-	/// <param name="frame">The captured frame of the video feed</param>
+	/// <param name="profile">The row profile of the segmented stripe region</param>
 	/// <param name="stripeProperties">The properties of the measured striped input</param>
 	/// <returns>The amount of iterations in which a 0 or 255 were drawe</returns>
-	double WaterLevelTracker::StripeCount(Mat &frame, StripeProperties &stripeProperties) {
-		int previous = -1;
-		int previousStripeHeight = stripeProperties.GetStripePixelHeight();
+	double WaterLevelTracker::StripeCount(const std::vector<uchar> &profile, StripeProperties &stripeProperties) {
+		StripeScan scan = ScanStripes(profile, stripeProperties.GetStripePixelHeight());
+		return scan.valid ? Level(scan.count, stripeProperties) : 0.0;
+	}
+
+	/// <summary>
+	/// Count the stripes of every band and return the water level height of the median count.
+	/// </summary>
+	/// <param name="profiles">The row profiles of the bands one after the other</param>
+	/// <param name="bandCount">The amount of bands</param>
+	/// <param name="stripeProperties">The properties of the measured striped input</param>
+	/// <returns>The height of the water in meters</returns>
+	double WaterLevelTracker::StripeCount(const std::vector<uchar> &profiles, int bandCount, StripeProperties &stripeProperties) {
+		std::vector<uchar> profile;
+		StripeScan scan = VoteStripes(profiles, bandCount, stripeProperties.GetStripePixelHeight(), profile);
+		return scan.valid ? Level(scan.count, stripeProperties) : 0.0;
+	}
+
+	/// <summary>
+	/// Count the stripes of every band and vote on the count. The vote fails when fewer than half of the bands give a valid count,
+	/// otherwise the band with the median of the valid counts is taken
+	/// </summary>
+	/// <param name="profiles">The row profiles of the bands one after the other</param>
+	/// <param name="bandCount">The amount of bands</param>
+	/// <param name="stripePixelHeight">The expected height of the first stripe in pixels</param>
+	/// <param name="profile">Receives the row profile of the band which was taken</param>
+	/// <returns>The counted stripes of the band which was taken and where its count stopped</returns>
+	StripeScan WaterLevelTracker::VoteStripes(const std::vector<uchar> &profiles, int bandCount, int stripePixelHeight, std::vector<uchar> &profile) {
+		size_t rows = bandCount > 0 ? profiles.size() / bandCount : 0;
+		StripeScan scans[MaxBandCount];
+		int bands[MaxBandCount];
+		int validCount = 0;
+		bandCount = std::min(bandCount, (int)MaxBandCount);
+		for (int band = 0; band < bandCount; band++) {
+			profile.assign(profiles.begin() + (band * rows), profiles.begin() + ((band + 1) * rows));
+			scans[band] = ScanStripes(profile, stripePixelHeight);
+			if (scans[band].valid) {
+				bands[validCount++] = band;
+			}
+		}
+
+		if (validCount * 2 < bandCount || validCount == 0) {
+			StripeScan scan = {};
+			scan.valid = false;
+			profile.assign(rows, 0);
+			return scan;
+		}
+
+		// Sort the valid bands on their count, the few bands an occlusion or glare spot changes end up at either end
+		std::sort(bands, bands + validCount, [&scans](int a, int b) { return scans[a].count < scans[b].count; });
+		int median = bands[(validCount - 1) / 2];
+		int agreeing = 0;
+		for (int i = 0; i < validCount; i++) {
+			agreeing += scans[bands[i]].count == scans[median].count ? 1 : 0;
+		}
+
+		profile.assign(profiles.begin() + (median * rows), profiles.begin() + ((median + 1) * rows));
+		StripeScan scan = scans[median];
+		scan.agreement = (double)agreeing / bandCount;
+		return scan;
+	}
+
+	/// <summary>
+	/// Count the stripes in the row profile from the top down until a run differs too much from the stripe above it
+	/// </summary>
+	/// <param name="profile">The row profile of the segmented stripe region</param>
+	/// <param name="stripePixelHeight">The expected height of the first stripe in pixels</param>
+	/// <returns>The counted stripes and where the count stopped</returns>
+	StripeScan WaterLevelTracker::ScanStripes(const std::vector<uchar> &profile, int stripePixelHeight) {
+		WLT_TIME_STAGE(StripeCount);
+		StripeScan scan;
+		scan.valid = true;
+		scan.reachedWater = false;
+		scan.agreement = 1;
+		int rows = (int)profile.size();
+		int previousStripeHeight = stripePixelHeight;
 		int previousStripeEnd = 0;
 		int currentStripeHeight = -1;
 		int count = 0;
-		for (int i = 0; i < frame.rows - 1; i++) {
+		int deviationSum = 0;
+		int heightSum = 0;
+		for (int i = 0; i < rows - 1; i++) {
 			currentStripeHeight = 0;
-			while (i < frame.rows - 1 && frame.at<uchar>(i + 1, 0) == frame.at<uchar>(i, 0)) {
+			while (i < rows - 1 && profile[i + 1] == profile[i]) {
 				currentStripeHeight++;
 				i++;
 			}
 
-			// If the current iterated stripe is almost of equal size of the previous, it is accepted
-			if (abs(previousStripeHeight - currentStripeHeight) < previousStripeHeight * 0.3) {
+			// If the current iterated stripe is almost of equal size of the previous, it is accepted. Integer form of a 30% tolerance
+			if (abs(previousStripeHeight - currentStripeHeight) * 10 < previousStripeHeight * 3) {
+				deviationSum += abs(previousStripeHeight - currentStripeHeight);
+				heightSum += previousStripeHeight;
 				previousStripeHeight = currentStripeHeight;
 				previousStripeEnd = i;
 				count++;
-			} else if (previousStripeEnd + previousStripeHeight < frame.rows) {
+			} else if (previousStripeEnd + previousStripeHeight < rows) {
 				count++;
+				scan.reachedWater = true;
 				break;
 			} else {
-				return NULL;
+				scan.valid = false;
+				break;
 			}
 		}
 
-		return count >= stripeProperties.GetStripeCount() ? NULL : stripeProperties.GetStripeStart() - (stripeProperties.GetStripeHeight() * count);
+		// The mean deviation between neighbouring stripes relative to the 30% tolerance, each accepted deviation stays below it
+		scan.consistency = heightSum > 0 ? 1 - (deviationSum * 10.0) / (heightSum * 3.0) : 0;
+		scan.count = count;
+		scan.boundaryRow = previousStripeEnd;
+		scan.stripePixelHeight = previousStripeHeight;
+		return scan;
+	}
+
+	/// <summary>
+	/// Convert an amount of stripes above the water to the water level height.
+	/// Return NULL if every stripe is above the water
+	/// </summary>
+	/// <param name="count">The amount of stripes above the water</param>
+	/// <param name="stripeProperties">The properties of the measured striped input</param>
+	/// <returns>The height of the water in meters</returns>
+	double WaterLevelTracker::Level(int count, StripeProperties &stripeProperties) {
+		return count >= stripeProperties.GetStripeCount() ? 0.0 : stripeProperties.GetStripeStart() - (stripeProperties.GetStripeHeight() * count);
+	}
+
+	/// <summary>
+	/// Reduce the stripe region to a row profile in the way selected by the profile mode of the options and count its stripes.
+	/// The row profile which was counted is left in the profile buffer
+	/// </summary>
+	/// <param name="region">The grayscale stripe region</param>
+	/// <param name="stripePixelHeight">The expected height of the first stripe in pixels</param>
+	/// <returns>The counted stripes and where the count stopped</returns>
+	StripeScan WaterLevelTracker::ScanRegion(const Mat &region, int stripePixelHeight) {
+		if (this->options.profileMode != ProfileMode::BandVote) {
+			this->SegmentRegion(region, this->profileBuffer);
+			return ScanStripes(this->profileBuffer, stripePixelHeight);
+		}
+
+		this->SegmentBands(region, this->voteBuffer);
+		this->Scratch(this->profileBuffer, region.rows);
+		int bandCount = region.rows > 0 ? (int)(this->voteBuffer.size() / region.rows) : 1;
+		return VoteStripes(this->voteBuffer, bandCount, stripePixelHeight, this->profileBuffer);
+	}
+
+	/// <summary>
+	/// Gets the columns of the stripe region underneath the marker
+	/// </summary>
+	/// <param name="bottomLeftCornerX">The x of the bottom left corner of the marker</param>
+	/// <param name="bottomRightCornerX">The x of the bottom right corner of the marker</param>
+	/// <param name="wide">Whether to take the middle two thirds the BandVote profile mode votes over instead of the middle third</param>
+	/// <param name="left">Receives the first column of the region</param>
+	/// <param name="right">Receives the column after the last column of the region</param>
+	void WaterLevelTracker::StripeColumns(int bottomLeftCornerX, int bottomRightCornerX, bool wide, int &left, int &right) {
+		if (wide) {
+			left = bottomLeftCornerX + (bottomRightCornerX - bottomLeftCornerX) / 6;
+			right = bottomLeftCornerX + ((bottomRightCornerX - bottomLeftCornerX) / 6) * 5;
+			return;
+		}
+
+		left = bottomLeftCornerX + (bottomRightCornerX - bottomLeftCornerX) / 3;
+		right = bottomLeftCornerX + ((bottomRightCornerX - bottomLeftCornerX) / 3) * 2;
+	}
+
+	/// <summary>
+	/// Check the frame and the geometry of the marker and the stripes from the corners alone, without touching a pixel
+	/// </summary>
+	/// <param name="frameSize">The size of the frame</param>
+	/// <param name="rotation">Angle in degrees of the rotation of the marker</param>
+	/// <param name="markerProperties">Properties of the measured marker</param>
+	/// <param name="stripeProperties">Properties of the striped underneath the measured marker</param>
+	/// <param name="bounds">Receives the bounds of the stripe region in the unrotated frame, clipped to the frame</param>
+	/// <returns>WLT_STATUS_OK if the frame can give a water level, otherwise why it cannot</returns>
+	int WaterLevelTracker::Validate(Size frameSize, double rotation, MarkerProperties &markerProperties, StripeProperties &stripeProperties, Rect &bounds) {
+		bounds = Rect();
+		double meterToPixelFactor = markerProperties.GetMeterToPixelFactor();
+		if (frameSize.width <= 0 || frameSize.height <= 0 || !(markerProperties.GetMarkerSize() > 0) || !(meterToPixelFactor > 0) || std::isinf(meterToPixelFactor)
+			|| stripeProperties.GetStripeCount() <= 0 || stripeProperties.GetStripePixelHeight() <= 0) {
+			return WLT_STATUS_INVALID_INPUT;
+		}
+
+		bounds = StripeBounds(frameSize, 360 - rotation, markerProperties, this->options.profileMode == ProfileMode::BandVote);
+		return bounds.width > 0 && bounds.height > 0 ? WLT_STATUS_OK : WLT_STATUS_OUTSIDE_FRAME;
+	}
+
+	/// <summary>
+	/// Gets the result of the last frame which was processed
+	/// </summary>
+	WltTrackingResult WaterLevelTracker::GetLastResult() {
+		return this->result;
+	}
+
+	/// <summary>
+	/// Gets the row profile the stripes of the last processed frame were counted from, empty if the frame was rejected before that
+	/// </summary>
+	const std::vector<uchar> &WaterLevelTracker::GetLastProfile() {
+		return this->profileBuffer;
+	}
+
+	/// <summary>
+	/// Record the outcome of a stripe count in the result of the frame and convert it to the water level height
+	/// </summary>
+	/// <param name="region">The grayscale stripe region the stripes were counted in</param>
+	/// <param name="scan">The counted stripes</param>
+	/// <param name="stripeProperties">The properties of the measured striped input</param>
+	/// <returns>The height of the water in meters, NULL if the count gave no water level</returns>
+	double WaterLevelTracker::Conclude(const Mat &region, const StripeScan &scan, StripeProperties &stripeProperties) {
+		Rejection rejection = Outcome(scan, stripeProperties);
+		WLT_RECORD(RecordStripes(scan.count));
+		WLT_RECORD(RecordRejection(rejection));
+		this->result.status = rejection == Rejection::None ? WLT_STATUS_OK : rejection == Rejection::IrregularStripes ? WLT_STATUS_IRREGULAR_STRIPES : WLT_STATUS_ALL_STRIPES_ABOVE_WATER;
+		this->result.confidence = rejection == Rejection::None ? scan.agreement * scan.consistency : 0;
+		this->result.stripeCount = scan.count;
+		this->result.level = rejection == Rejection::None ? Level(scan.count, stripeProperties) : 0.0;
+		if (this->options.subPixel && rejection == Rejection::None && scan.reachedWater) {
+			this->result.level = this->RefineLevel(region, scan, stripeProperties, this->result.level);
+		}
+
+		return this->result.level;
+	}
+
+	/// <summary>
+	/// Move the water level from the bottom of the partially submerged stripe to the water line inside it.
+	/// Only the rows around that stripe are reduced again, as not every profile mode keeps the intensity of the rows.
+	/// </summary>
+	/// <param name="region">The grayscale stripe region the stripes were counted in</param>
+	/// <param name="scan">The counted stripes, which reached the water</param>
+	/// <param name="stripeProperties">The properties of the measured striped input</param>
+	/// <param name="level">The water level of the stripe count</param>
+	/// <returns>The refined height of the water in meters, the given level if the water line cannot be found</returns>
+	double WaterLevelTracker::RefineLevel(const Mat &region, const StripeScan &scan, StripeProperties &stripeProperties, double level) {
+		// The rows from the stripe of the same color above it down to the water below it, with two extra rows for the smoothing
+		int stripeStart = scan.boundaryRow + 1;
+		int stripeHeight = std::max(scan.stripePixelHeight, 4);
+		int from = std::max(stripeStart - (2 * stripeHeight) - 2, 0);
+		int to = std::min(stripeStart + (2 * stripeHeight) + 2, region.rows);
+		if (stripeStart >= to) {
+			return level;
+		}
+
+		Mat window = region.rowRange(from, to);
+		this->Scratch(this->intensityBuffer, window.rows);
+		this->Scratch(this->smoothBuffer, window.rows);
+		if (this->options.profileMode == ProfileMode::RowTrimmedMean) {
+			this->Scratch(this->rowBuffer, window.cols);
+			RowProfile::TrimmedMean(window, this->intensityBuffer, this->rowBuffer);
+		} else {
+			RowProfile::Mean(window, this->intensityBuffer);
+		}
+
+		RowProfile::Blur(this->intensityBuffer, this->smoothBuffer);
+		double fraction = RowProfile::StripeAboveWater(this->smoothBuffer, stripeStart - from, stripeHeight);
+		if (fraction < 0) {
+			return level;
+		}
+
+		return stripeProperties.GetStripeStart() - (stripeProperties.GetStripeHeight() * (scan.count - 1 + fraction));
+	}
+
+	/// <summary>
+	/// Hand the result of the last processed frame to a frame which is skipped
+	/// </summary>
+	/// <returns>The water level of the last processed frame</returns>
+	double WaterLevelTracker::Hold() {
+		this->result = this->motionGate.GetResult();
+		return this->result.level;
+	}
+
+	/// <summary>
+	/// Record in the result of the frame that it gave no water level before the stripes were counted
+	/// </summary>
+	/// <param name="status">Why the frame gave no water level, a WltStatus</param>
+	/// <returns>NULL, as the water level of the frame</returns>
+	double WaterLevelTracker::Reject(int status) {
+		WLT_RECORD(RecordRejection(status == WLT_STATUS_INVALID_INPUT ? Rejection::InvalidInput : Rejection::EmptyRegion));
+		this->result.status = status;
+		this->result.level = 0.0;
+		this->result.confidence = 0;
+		this->result.stripeCount = 0;
+		this->profileBuffer.clear();
+		return 0.0;
+	}
+
+	/// <summary>
+	/// Classify the outcome of a stripe count for the instrumentation
+	/// </summary>
+	/// <param name="scan">The counted stripes</param>
+	/// <param name="stripeProperties">The properties of the measured striped input</param>
+	/// <returns>The reason the count gave no water level, or None if it gave one</returns>
+	Rejection WaterLevelTracker::Outcome(const StripeScan &scan, StripeProperties &stripeProperties) {
+		if (!scan.valid) {
+			return Rejection::IrregularStripes;
+		}
+
+		return scan.count >= stripeProperties.GetStripeCount() ? Rejection::AllStripesAboveWater : Rejection::None;
 	}
 }
\ No newline at end of file
@@ -0,0 +1,137 @@
+// <copyright file="FrameReplayTest.cpp" company="Delft University of Technology">
+// Copyright (c) Delft University of Technology. All rights reserved.
+// </copyright>
+
+#include <cstdio>
+#include <iostream>
+#include <string>
+#include <opencv2/opencv.hpp>
+#include "FrameRecorder.h"
+#include "FrameReplay.h"
+#include "SyntheticPole.h"
+#include "WaterLevelTracker.h"
+
+using namespace cv;
+using namespace waterleveltracking;
+
+/// <summary>
+/// The path of the temporary recording
+/// </summary>
+static const char *RecordingPath = "FrameReplayTest.wltr";
+
+/// <summary>
+/// Check the status and level of a recorded frame
+/// </summary>
+/// <param name="name">The name of the case in the report</param>
+/// <param name="frame">The recorded frame</param>
+/// <param name="status">The expected status</param>
+/// <param name="level">The expected level</param>
+/// <returns>1 if the frame was recorded with another status or level, otherwise 0</returns>
+static int CheckRecord(const std::string &name, const ReplayFrame &frame, int status, double level) {
+	if (frame.status != status || frame.level != level) {
+		std::cerr << name << ": recorded status " << frame.status << " and level " << frame.level << " instead of " << status << " and " << level << std::endl;
+		return 1;
+	}
+
+	return 0;
+}
+
+/// <summary>
+/// Record a processed, a rejected and a held frame and read them back
+/// </summary>
+/// <param name="content">What is recorded of every frame</param>
+/// <returns>The amount of failed checks</returns>
+static int CheckRecording(RecordContent content) {
+	std::string name = content == RecordContent::Region ? "region" : "frame";
+	SyntheticPole pole(Size(640, 480), 15, 10);
+	MarkerProperties sourceMarker = pole.CreateMarker();
+
+	// Corners far to the right of the frame, like a marker detection which went wrong
+	Square corners = sourceMarker.GetCorners();
+	int shifted[8] = { corners.bottomLeft.x + 5000, corners.bottomLeft.y, corners.bottomRight.x + 5000, corners.bottomRight.y, corners.topRight.x + 5000, corners.topRight.y, corners.topLeft.x + 5000, corners.topLeft.y };
+	TrackerOptions options;
+	options.regionMode = RegionMode::OrientedRegion;
+	options.motionThreshold = 2;
+	double level;
+	{
+		FrameRecorder recorder(RecordingPath, content);
+		WaterLevelTracker tracker(options);
+		tracker.SetRecorder(&recorder);
+		MarkerProperties marker = pole.CreateMarker();
+		StripeProperties stripes = pole.CreateStripes();
+		level = tracker.Track(pole.GetFrame(), marker, stripes, pole.GetRotation());
+		MarkerProperties wrongMarker(shifted, sourceMarker.GetMarkerSize(), sourceMarker.GetDistanceToStripes(), sourceMarker.GetMarkerHeight());
+		StripeProperties wrongStripes(wrongMarker, stripes.GetStripeHeight(), stripes.GetStripeCount());
+		tracker.Track(pole.GetFrame(), wrongMarker, wrongStripes, pole.GetRotation());
+		marker = pole.CreateMarker();
+		stripes = pole.CreateStripes();
+		tracker.Track(pole.GetFrame(), marker, stripes, pole.GetRotation());
+		if (level == 0 || tracker.GetSkippedCount() != 1) {
+			std::cerr << name << ": level " << level << " with " << tracker.GetSkippedCount() << " held frames" << std::endl;
+			return 1;
+		}
+	}
+
+	FrameReplay replay;
+	if (!replay.Open(RecordingPath) || replay.GetCount() != 3) {
+		std::cerr << name << ": the recording does not hold the three frames" << std::endl;
+		return 1;
+	}
+
+	int failures = 0;
+	ReplayFrame frames[3];
+	for (int i = 0; i < 3; i++) {
+		replay.GetFrame(i, frames[i]);
+	}
+
+	failures += CheckRecord(name + " processed", frames[0], WLT_STATUS_OK, level);
+	failures += CheckRecord(name + " rejected", frames[1], WLT_STATUS_OUTSIDE_FRAME, 0);
+	failures += CheckRecord(name + " held", frames[2], WLT_STATUS_OK, level);
+	for (int i = 0; i < 8; i++) {
+		if (frames[1].corners[i] != shifted[i]) {
+			std::cerr << name << ": the rejected frame was recorded with other corners" << std::endl;
+			failures++;
+			break;
+		}
+	}
+
+	if (content == RecordContent::Region) {
+		// No stripe region was extracted for the rejected and held frames
+		if (frames[0].image.empty() || !frames[1].image.empty() || !frames[2].image.empty()) {
+			std::cerr << name << ": only the processed frame should have a stripe region" << std::endl;
+			failures++;
+		}
+	} else {
+		// The rejected frame is recovered from the recording and tracked again with the corners of the marker corrected
+		WaterLevelTracker tracker(options);
+		replay.Replay(1, tracker);
+		if (tracker.GetLastResult().status != WLT_STATUS_OUTSIDE_FRAME) {
+			std::cerr << name << ": replaying the rejected frame gave status " << tracker.GetLastResult().status << std::endl;
+			failures++;
+		}
+
+		MarkerProperties marker = pole.CreateMarker();
+		StripeProperties stripes = pole.CreateStripes();
+		WaterLevelTracker recovery(options);
+		double recovered = recovery.Track(frames[1].image, marker, stripes, frames[1].rotation);
+		if (frames[1].image.size() != pole.GetFrame().size() || norm(frames[1].image, pole.GetFrame(), NORM_INF) != 0 || recovered != level) {
+			std::cerr << name << ": the rejected frame recovered to level " << recovered << " instead of " << level << std::endl;
+			failures++;
+		}
+	}
+
+	replay.Close();
+	std::remove(RecordingPath);
+	return failures;
+}
+
+int main() {
+	int failures = CheckRecording(RecordContent::Frame) + CheckRecording(RecordContent::Region);
+	if (failures > 0) {
+		std::cerr << failures << " recording checks failed" << std::endl;
+		return 1;
+	}
+
+	std::cout << "Every frame is recorded with its status" << std::endl;
+	return 0;
+}
\ No newline at end of file
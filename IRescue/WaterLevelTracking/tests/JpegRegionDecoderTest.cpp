@@ -0,0 +1,138 @@
+// <copyright file="JpegRegionDecoderTest.cpp" company="Delft University of Technology">
+// Copyright (c) Delft University of Technology. All rights reserved.
+// </copyright>
+
+#include <iostream>
+#include <string>
+#include <vector>
+#include <opencv2/opencv.hpp>
+#include "JpegRegionDecoder.h"
+#include "SyntheticPole.h"
+
+using namespace cv;
+using namespace waterleveltracking;
+
+/// <summary>
+/// The blur sizes whose margin around the region is checked, like the margin the native API decodes for the blur of the options
+/// </summary>
+static const int BlurSizes[] = { 3, 5 };
+
+/// <summary>
+/// Compare the frame of the decoder with the fully decoded image: the decoded region covers the requested region, holds the
+/// pixels of the full decode and every pixel outside it is black, so nothing of an earlier image is left behind
+/// </summary>
+/// <param name="name">The name of the case in the report</param>
+/// <param name="frame">The frame the decoder filled</param>
+/// <param name="decoded">The region the decoder reports as decoded</param>
+/// <param name="region">The requested region</param>
+/// <param name="expected">The fully decoded grayscale image</param>
+/// <returns>1 if the frame differs, otherwise 0</returns>
+static int CheckFrame(const std::string &name, const Mat &frame, Rect decoded, Rect region, const Mat &expected) {
+	region &= Rect(0, 0, expected.cols, expected.rows);
+	if (frame.size() != expected.size() || frame.type() != CV_8UC1 || (region.area() > 0 && (decoded & region) != region)) {
+		std::cerr << name << ": decoded " << decoded << " of a " << frame.size() << " frame for " << region << std::endl;
+		return 1;
+	}
+
+	for (int row = 0; row < frame.rows; row++) {
+		for (int col = 0; col < frame.cols; col++) {
+			int value = frame.at<uchar>(row, col);
+			int reference = decoded.contains(Point(col, row)) ? expected.at<uchar>(row, col) : 0;
+			if (value != reference) {
+				std::cerr << name << ": pixel " << Point(col, row) << " is " << value << " instead of " << reference << " for " << region << std::endl;
+				return 1;
+			}
+		}
+	}
+
+	return 0;
+}
+
+/// <summary>
+/// Decode every region of an encoded image one after the other with the same decoder and compare each with the full decode
+/// </summary>
+/// <param name="name">The name of the image in the report</param>
+/// <param name="image">The image to encode</param>
+/// <returns>The amount of regions which differ</returns>
+static int CheckImage(const std::string &name, const Mat &image) {
+	std::vector<uchar> data;
+	imencode(".jpg", image, data, { IMWRITE_JPEG_QUALITY, 90 });
+	Mat expected = imdecode(data, IMREAD_GRAYSCALE);
+	int w = expected.cols;
+	int h = expected.rows;
+
+	// Full, cropped, skipped and bottom regions, regions at odd offsets inside an MCU, single rows, columns and pixels,
+	// regions which stick out of the image and an empty one. A smaller region after a larger one checks the clearing
+	std::vector<Rect> regions = {
+		Rect(0, 0, w, h), Rect(0, 0, w, h / 3), Rect(w / 3, h / 2, w / 4, h / 5), Rect(0, h - 9, w, 9), Rect(5, 7, 1, h - 7),
+		Rect(w - 3, 0, 3, h), Rect(w / 2 + 3, h / 2 + 5, 1, 1), Rect(17, 13, w, h), Rect(-8, -8, 40, 40), Rect(3, 3, 0, 0),
+		Rect(w / 5, 1, w / 2, h - 2)
+	};
+
+	JpegRegionDecoder decoder;
+	int failures = 0;
+	for (Rect region : regions) {
+		Size frameSize;
+		Mat frame;
+		if (!decoder.Open(data.data(), data.size(), frameSize) || frameSize != expected.size() || !decoder.Decode(region, frame)) {
+			std::cerr << name << ": " << region << " could not be decoded" << std::endl;
+			failures++;
+			continue;
+		}
+
+		failures += CheckFrame(name, frame, decoder.GetDecodedRegion(), region, expected);
+	}
+
+	// The blur of the tracker reads around the stripe region, the margin which is decoded for it has to hold the same pixels as
+	// the full decode, so the blurred region matches the blurred full image
+	for (int blurSize : BlurSizes) {
+		Rect bounds(w / 3 + 1, h / 4 + 3, w / 5, h / 2);
+		int margin = blurSize / 2 + 1;
+		Rect region(bounds.x - margin, bounds.y - margin, bounds.width + (2 * margin), bounds.height + (2 * margin));
+		Size frameSize;
+		Mat frame;
+		if (!decoder.Open(data.data(), data.size(), frameSize) || !decoder.Decode(region, frame)) {
+			std::cerr << name << ": the margin of " << bounds << " could not be decoded" << std::endl;
+			failures++;
+			continue;
+		}
+
+		failures += CheckFrame(name + " margin", frame, decoder.GetDecodedRegion(), region, expected);
+		Mat blurred;
+		Mat expectedBlur;
+		GaussianBlur(frame, blurred, Size(blurSize, blurSize), 0);
+		GaussianBlur(expected, expectedBlur, Size(blurSize, blurSize), 0);
+		if (norm(blurred(bounds), expectedBlur(bounds), NORM_INF) != 0) {
+			std::cerr << name << ": the blur of size " << blurSize << " differs inside " << bounds << std::endl;
+			failures++;
+		}
+	}
+
+	return failures;
+}
+
+int main() {
+	if (!JpegRegionDecoder::IsAvailable()) {
+		std::cerr << "The library is built without libjpeg-turbo" << std::endl;
+		return 1;
+	}
+
+	int failures = 0;
+
+	// A color frame, whose chroma is subsampled, and a grayscale one, at sizes which do and do not fill whole MCUs
+	SyntheticPole pole(Size(640, 480), 15, 10.25);
+	failures += CheckImage("color", pole.GetFrame());
+	Mat gray;
+	cvtColor(pole.GetFrame(), gray, COLOR_BGR2GRAY);
+	failures += CheckImage("gray", gray);
+	failures += CheckImage("odd color", pole.GetFrame()(Rect(3, 5, 333, 251)).clone());
+	failures += CheckImage("odd gray", gray(Rect(1, 2, 101, 77)).clone());
+
+	if (failures > 0) {
+		std::cerr << failures << " regions do not match the full decode" << std::endl;
+		return 1;
+	}
+
+	std::cout << "Every region matches the full decode" << std::endl;
+	return 0;
+}
\ No newline at end of file
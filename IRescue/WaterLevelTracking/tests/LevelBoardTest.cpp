@@ -0,0 +1,97 @@
+// <copyright file="LevelBoardTest.cpp" company="Delft University of Technology">
+// Copyright (c) Delft University of Technology. All rights reserved.
+// </copyright>
+
+#include <atomic>
+#include <chrono>
+#include <iostream>
+#include <thread>
+#include <vector>
+#include "LevelBoard.h"
+
+using namespace waterleveltracking;
+
+/// <summary>
+/// The amount of threads which publish to the same slot at the same time, like a stream and a caller of WltPublishLevel
+/// </summary>
+static const int WriterCount = 3;
+
+/// <summary>
+/// Fill a sample whose fields all follow from the timestamp, so a sample mixed from two writes is recognised
+/// </summary>
+/// <param name="timestamp">The timestamp</param>
+/// <returns>The sample</returns>
+static WltLevelSample CreateSample(long long timestamp) {
+	WltLevelSample sample = WltLevelSample();
+	sample.timestamp = timestamp;
+	sample.level = timestamp * 0.5;
+	sample.confidence = (timestamp % 100) / 100.0;
+	for (int i = 0; i < WLT_STAGE_COUNT; i++) {
+		sample.stageTimings[i] = (double)(timestamp + i);
+	}
+
+	return sample;
+}
+
+/// <summary>
+/// Check whether all fields of a sample belong to the same write
+/// </summary>
+/// <param name="sample">The sample</param>
+/// <returns>False if the sample is torn</returns>
+static bool IsConsistent(const WltLevelSample &sample) {
+	bool consistent = sample.level == sample.timestamp * 0.5 && sample.confidence == (sample.timestamp % 100) / 100.0;
+	for (int i = 0; i < WLT_STAGE_COUNT; i++) {
+		consistent = consistent && sample.stageTimings[i] == (double)(sample.timestamp + i);
+	}
+
+	return consistent;
+}
+
+int main() {
+	const int marker = LevelBoard::MarkerCapacity - 1;
+	std::atomic<bool> writing(true);
+	std::atomic<long long> published(0);
+	std::vector<std::thread> writers;
+	for (int writer = 0; writer < WriterCount; writer++) {
+		writers.push_back(std::thread([&writing, &published, writer] {
+			// Every writer publishes its own timestamps, the board orders them by sequence number
+			for (long long timestamp = writer; writing.load(std::memory_order_relaxed); timestamp += WriterCount) {
+				LevelBoard::Publish(marker, CreateSample(timestamp));
+				published.fetch_add(1, std::memory_order_relaxed);
+			}
+		}));
+	}
+
+	long long reads = 0;
+	long long torn = 0;
+	long long outOfOrder = 0;
+	long long lastSequence = 0;
+	std::chrono::steady_clock::time_point end = std::chrono::steady_clock::now() + std::chrono::seconds(2);
+	while (std::chrono::steady_clock::now() < end) {
+		WltLevelSample sample;
+		if (!LevelBoard::Read(marker, sample)) {
+			continue;
+		}
+
+		reads++;
+		torn += IsConsistent(sample) ? 0 : 1;
+		outOfOrder += sample.sequence < lastSequence ? 1 : 0;
+		lastSequence = sample.sequence;
+	}
+
+	writing = false;
+	for (std::thread &writer : writers) {
+		writer.join();
+	}
+
+	// The sequence number of the newest sample counts every publish, a race on the counter would lose some
+	WltLevelSample last;
+	LevelBoard::Read(marker, last);
+	std::cout << reads << " reads of " << published << " samples from " << WriterCount << " writers, " << torn << " torn, " << outOfOrder << " out of order" << std::endl;
+	if (reads == 0 || torn > 0 || outOfOrder > 0 || !IsConsistent(last) || last.sequence != published) {
+		std::cerr << "The level board handed out torn or reordered samples" << std::endl;
+		return 1;
+	}
+
+	return 0;
+}
\ No newline at end of file
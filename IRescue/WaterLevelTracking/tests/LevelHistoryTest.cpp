@@ -0,0 +1,67 @@
+// <copyright file="LevelHistoryTest.cpp" company="Delft University of Technology">
+// Copyright (c) Delft University of Technology. All rights reserved.
+// </copyright>
+
+#include <cmath>
+#include <iostream>
+#include <limits>
+#include "LevelHistory.h"
+
+using namespace waterleveltracking;
+
+/// <summary>
+/// Add a level and check the sample which is read back
+/// </summary>
+/// <param name="history">The history</param>
+/// <param name="timestamp">The timestamp of the sample, later than that of the previous one</param>
+/// <param name="level">The level to add</param>
+/// <param name="kept">Whether the level should be read back, otherwise the sample should have no level</param>
+/// <returns>1 if the sample differs, otherwise 0</returns>
+static int CheckLevel(LevelHistory &history, long long timestamp, double level, bool kept) {
+	history.Add(timestamp, level, true);
+	long long storedTimestamp;
+	double stored;
+	bool valid;
+	if (!history.GetSample(0, storedTimestamp, stored, valid) || storedTimestamp != timestamp || valid != kept
+		|| (kept && std::fabs(stored - level) > LevelHistory::LevelStep / 2) || (!kept && stored != 0.0)) {
+		std::cerr << "level " << level << " is read back as " << stored << (valid ? "" : " without a level") << std::endl;
+		return 1;
+	}
+
+	return 0;
+}
+
+int main() {
+	LevelHistory history(64, 0);
+	int failures = 0;
+	long long timestamp = 0;
+
+	// Around the end of a 16 bit step count, which used to clamp to 32.767 meters
+	for (double level : { 32.766, 32.767, 32.768, -32.767, -32.768, -32.769, 100.25, -4000.5, 0.0 }) {
+		failures += CheckLevel(history, timestamp++, level, true);
+	}
+
+	// Around the end of the steps, the levels beyond it are flagged instead of clamped
+	failures += CheckLevel(history, timestamp++, LevelHistory::MaxLevel, true);
+	failures += CheckLevel(history, timestamp++, -LevelHistory::MaxLevel, true);
+	failures += CheckLevel(history, timestamp++, LevelHistory::MaxLevel + 0.01, false);
+	failures += CheckLevel(history, timestamp++, -LevelHistory::MaxLevel - 0.01, false);
+	failures += CheckLevel(history, timestamp++, std::numeric_limits<double>::infinity(), false);
+	failures += CheckLevel(history, timestamp++, std::numeric_limits<double>::quiet_NaN(), false);
+
+	// The flagged levels do not reach the statistics
+	WltLevelStatistics statistics;
+	history.GetStatistics(0, statistics);
+	if (statistics.count != 11 || statistics.maximum > LevelHistory::MaxLevel || statistics.minimum < -LevelHistory::MaxLevel) {
+		std::cerr << "the statistics hold " << statistics.count << " levels from " << statistics.minimum << " to " << statistics.maximum << std::endl;
+		failures++;
+	}
+
+	if (failures > 0) {
+		std::cerr << failures << " levels were not kept at their step" << std::endl;
+		return 1;
+	}
+
+	std::cout << "Every level was kept at its step or flagged as missing" << std::endl;
+	return 0;
+}
\ No newline at end of file
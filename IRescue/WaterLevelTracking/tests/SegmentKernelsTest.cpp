@@ -0,0 +1,255 @@
+// <copyright file="SegmentKernelsTest.cpp" company="Delft University of Technology">
+// Copyright (c) Delft University of Technology. All rights reserved.
+// </copyright>
+
+#include <algorithm>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+#include <opencv2/opencv.hpp>
+#include "FusedKernels.h"
+#include "SegmentKernels.h"
+#include "SyntheticPole.h"
+
+using namespace cv;
+using namespace waterleveltracking;
+
+/// <summary>
+/// The instruction sets every region is segmented with, the ones the processor lacks fall back to plain C++
+/// </summary>
+static const SegmentKernels::InstructionSet InstructionSets[] = { SegmentKernels::Scalar, SegmentKernels::Sse2, SegmentKernels::Avx2 };
+
+/// <summary>
+/// Segment the region the way the tracker did before the kernels existed: threshold a copy and sum every row with at
+/// </summary>
+/// <param name="region">The 8 bit grayscale region</param>
+/// <param name="profile">Receives 255 for every foreground row and 0 for every other row</param>
+static void BaselineSegment(const Mat &region, std::vector<uchar> &profile) {
+	Mat frame;
+	cv::threshold(region, frame, 150, 255, 0);
+	profile.assign(frame.rows, 0);
+	for (int row = 0; row < frame.rows; row++) {
+		int count = 0;
+		for (int col = 0; col < frame.cols; col++) {
+			count += frame.at<uchar>(row, col);
+		}
+
+		profile[row] = (count / 255) >= ((frame.cols) * 0.45) ? 255 : 0;
+	}
+}
+
+/// <summary>
+/// Segment the region with every instruction set and with the dispatched kernel and compare each profile with the baseline
+/// </summary>
+/// <param name="name">The name of the region in the report</param>
+/// <param name="region">The 8 bit grayscale region, possibly a view into a larger image</param>
+/// <returns>The amount of rows which differ from the baseline</returns>
+static int Compare(const std::string &name, const Mat &region) {
+	std::vector<uchar> expected;
+	BaselineSegment(region, expected);
+	std::vector<uchar> profile(region.rows);
+	int mismatches = 0;
+	for (int kernel = 0; kernel <= 3; kernel++) {
+		if (kernel < 3) {
+			SegmentKernels::ThresholdRowProjection(InstructionSets[kernel], region.data, region.step, region.rows, region.cols, 150, profile.data());
+		} else {
+			SegmentKernels::ThresholdRowProjection(region.data, region.step, region.rows, region.cols, 150, profile.data());
+		}
+
+		for (int row = 0; row < region.rows; row++) {
+			if (profile[row] != expected[row]) {
+				if (mismatches == 0) {
+					std::cerr << name << ": kernel " << kernel << " gives " << (int)profile[row] << " instead of " << (int)expected[row] << " in row " << row << std::endl;
+				}
+
+				mismatches++;
+			}
+		}
+	}
+
+	return mismatches;
+}
+
+/// <summary>
+/// Run one instantiation of the fused kernel and compare its profile with GaussianBlur followed by the baseline segmentation
+/// </summary>
+/// <param name="name">The name of the region in the report</param>
+/// <param name="region">The 8 bit grayscale region, possibly a view into a larger image</param>
+/// <returns>The amount of rows which differ from the reference</returns>
+template<int Radius>
+static int CompareFusedKernel(const std::string &name, const Mat &region) {
+	// The blur reads the pixels around a view the way the fused kernel does
+	Mat blurred;
+	GaussianBlur(region, blurred, Size((2 * Radius) + 1, (2 * Radius) + 1), 0);
+	std::vector<uchar> expected;
+	BaselineSegment(blurred, expected);
+	std::vector<uchar> profile(region.rows);
+	std::vector<ushort> columnSums(region.cols + (2 * Radius));
+	FusedSegmentKernel<Gray8, Radius, RowFraction<150, 9, 20> >::Run(region, profile.data(), columnSums.data());
+
+	// The dispatcher has to pick the same instantiation for the blur size
+	TrackerOptions options;
+	options.blurSize = (2 * Radius) + 1;
+	options.threshold = 150;
+	std::vector<uchar> dispatched(region.rows);
+	std::vector<ushort> dispatchSums(region.cols + 4);
+	bool fused = FusedSegment(region, options, dispatched.data(), dispatchSums.data());
+	int mismatches = fused ? 0 : region.rows;
+	for (int row = 0; row < region.rows; row++) {
+		if (profile[row] != expected[row] || (fused && dispatched[row] != expected[row])) {
+			if (mismatches == 0) {
+				std::cerr << name << ": fused kernel of radius " << Radius << " gives " << (int)profile[row] << " and " << (int)dispatched[row]
+					<< " instead of " << (int)expected[row] << " in row " << row << std::endl;
+			}
+
+			mismatches++;
+		}
+	}
+
+	if (!fused) {
+		std::cerr << name << ": no fused kernel is dispatched for a blur size of " << options.blurSize << std::endl;
+	}
+
+	return mismatches;
+}
+
+/// <summary>
+/// Compare every instantiation of the fused kernel, each blur size with the threshold it is compiled for
+/// </summary>
+/// <param name="name">The name of the region in the report</param>
+/// <param name="region">The 8 bit grayscale region, possibly a view into a larger image</param>
+/// <returns>The amount of rows which differ from the reference</returns>
+static int CompareFused(const std::string &name, const Mat &region) {
+	return CompareFusedKernel<1>(name, region) + CompareFusedKernel<2>(name, region);
+}
+
+/// <summary>
+/// Build a region in which row r has exactly r % (cols + 1) pixels brighter than the threshold, so every count around the 45% boundary occurs
+/// </summary>
+/// <param name="cols">The width of the region</param>
+/// <param name="rows">The height of the region</param>
+/// <param name="generator">Shuffles the bright pixels over the row</param>
+/// <returns>The region</returns>
+static Mat CountRegion(int cols, int rows, std::mt19937 &generator) {
+	Mat region(rows, cols, CV_8UC1);
+	std::vector<uchar> pixels(cols);
+	for (int row = 0; row < rows; row++) {
+		int bright = row % (cols + 1);
+		for (int col = 0; col < cols; col++) {
+			// Values right at the threshold are not brighter than it
+			pixels[col] = col < bright ? (uchar)(151 + (generator() % 105)) : (uchar)(150 - (generator() % 151));
+		}
+
+		std::shuffle(pixels.begin(), pixels.end(), generator);
+		std::copy(pixels.begin(), pixels.end(), region.ptr<uchar>(row));
+	}
+
+	return region;
+}
+
+int main() {
+	std::mt19937 generator(7);
+	int failures = 0;
+
+	// Every width up to twice the AVX2 vector and some wider odd ones, so each tail length of the vector loops is hit
+	std::vector<int> widths;
+	for (int cols = 1; cols <= 70; cols++) {
+		widths.push_back(cols);
+	}
+
+	widths.push_back(127);
+	widths.push_back(641);
+	widths.push_back(1921);
+	for (int cols : widths) {
+		Mat region = CountRegion(cols, 2 * (cols + 1), generator);
+		failures += Compare("counts " + std::to_string(cols), region) > 0;
+		failures += CompareFused("counts " + std::to_string(cols), region) > 0;
+
+		// A view which starts at an odd column of a larger image, so the rows are neither aligned nor continuous
+		Mat parent(region.rows + 2, cols + 5, CV_8UC1, Scalar(255));
+		Mat view = parent(Rect(3, 1, cols, region.rows));
+		region.copyTo(view);
+		failures += Compare("view " + std::to_string(cols), view) > 0;
+
+		// The fused kernel reads the bright border of the parent like GaussianBlur does
+		failures += CompareFused("view " + std::to_string(cols), view) > 0;
+	}
+
+	// Uniform noise, most rows are near the boundary
+	for (int cols : { 17, 33, 100, 333 }) {
+		Mat region(257, cols, CV_8UC1);
+		for (int row = 0; row < region.rows; row++) {
+			for (int col = 0; col < cols; col++) {
+				region.at<uchar>(row, col) = (uchar)(generator() % 256);
+			}
+		}
+
+		failures += Compare("noise " + std::to_string(cols), region) > 0;
+		failures += CompareFused("noise " + std::to_string(cols), region) > 0;
+	}
+
+	// Edge cases of the fused kernel: single rows and columns, which the border reflects onto themselves, flat regions on either
+	// side of the threshold and a region of values around it, whose blur rounds right at the threshold
+	for (Size size : { Size(1, 1), Size(1, 9), Size(9, 1), Size(2, 2), Size(3, 5), Size(5, 3) }) {
+		Mat region(size, CV_8UC1);
+		for (int row = 0; row < region.rows; row++) {
+			for (int col = 0; col < region.cols; col++) {
+				region.at<uchar>(row, col) = (uchar)(generator() % 256);
+			}
+		}
+
+		failures += CompareFused("small " + std::to_string(size.width) + "x" + std::to_string(size.height), region) > 0;
+	}
+
+	for (int value : { 0, 149, 150, 151, 255 }) {
+		failures += CompareFused("flat " + std::to_string(value), Mat(33, 47, CV_8UC1, Scalar(value))) > 0;
+	}
+
+	for (int cols : { 20, 41 }) {
+		Mat region(200, cols, CV_8UC1);
+		for (int row = 0; row < region.rows; row++) {
+			for (int col = 0; col < cols; col++) {
+				region.at<uchar>(row, col) = (uchar)(148 + (generator() % 5));
+			}
+		}
+
+		failures += CompareFused("threshold " + std::to_string(cols), region) > 0;
+	}
+
+	// Views against each edge of the parent and against none, with a parent of noise around them
+	Mat parent(120, 90, CV_8UC1);
+	for (int row = 0; row < parent.rows; row++) {
+		for (int col = 0; col < parent.cols; col++) {
+			parent.at<uchar>(row, col) = (uchar)(generator() % 256);
+		}
+	}
+
+	for (Rect bounds : { Rect(0, 0, 30, 40), Rect(60, 80, 30, 40), Rect(1, 1, 88, 118), Rect(44, 0, 1, 120), Rect(0, 59, 90, 1) }) {
+		failures += CompareFused("edge view " + std::to_string(bounds.x) + "," + std::to_string(bounds.y), parent(bounds)) > 0;
+	}
+
+	// The blurred stripe region of generated poles, cut at odd widths
+	for (double rotation : { 0.0, 15.0 }) {
+		SyntheticPole pole(Size(1280, 720), rotation, 10.25);
+		Mat unblurred;
+		cvtColor(pole.GetFrame(), unblurred, COLOR_BGR2GRAY);
+		Mat gray;
+		GaussianBlur(unblurred, gray, Size(5, 5), 0);
+		for (int cols : { 31, 64, 95 }) {
+			Rect bounds((gray.cols - cols) / 2 + 1, 0, cols, gray.rows);
+			failures += Compare("pole " + std::to_string((int)rotation) + " " + std::to_string(cols), gray(bounds)) > 0;
+
+			// The fused kernel blurs itself, so it gets the unblurred region
+			failures += CompareFused("pole " + std::to_string((int)rotation) + " " + std::to_string(cols), unblurred(bounds)) > 0;
+		}
+	}
+
+	if (failures > 0) {
+		std::cerr << failures << " regions do not match the baseline segmentation" << std::endl;
+		return 1;
+	}
+
+	std::cout << "All regions match the baseline segmentation" << std::endl;
+	return 0;
+}
\ No newline at end of file
@@ -0,0 +1,119 @@
+// <copyright file="WaterLevelTrackerTest.cpp" company="Delft University of Technology">
+// Copyright (c) Delft University of Technology. All rights reserved.
+// </copyright>
+
+#include <cmath>
+#include <iostream>
+#include <string>
+#include <opencv2/opencv.hpp>
+#include "SyntheticPole.h"
+#include "TrackerStages.h"
+
+using namespace cv;
+using namespace waterleveltracking;
+
+/// <summary>
+/// Check that the bottom found in the column matches the expected row
+/// </summary>
+/// <param name="name">The name of the case in the report</param>
+/// <param name="image">The grayscale image</param>
+/// <param name="hint">The expected row handed to the search, -1 if unknown</param>
+/// <param name="expected">The row the search should return</param>
+/// <returns>1 if the search returned another row, otherwise 0</returns>
+static int CheckBottom(const std::string &name, const Mat &image, int hint, int expected) {
+	int bottom = TrackerStages::FindBottom(image, 2, hint);
+	if (bottom != expected) {
+		std::cerr << name << ": bottom " << bottom << " instead of " << expected << " with hint " << hint << std::endl;
+		return 1;
+	}
+
+	return 0;
+}
+
+/// <summary>
+/// Build a column which is bright down to the bottom row and black below it, like the border a warp leaves under the frame
+/// </summary>
+/// <param name="rows">The height of the image</param>
+/// <param name="bottom">The last bright row</param>
+/// <returns>The image</returns>
+static Mat BottomImage(int rows, int bottom) {
+	Mat image(rows, 5, CV_8UC1, Scalar(0));
+	image.rowRange(0, bottom + 1).setTo(Scalar(200));
+	return image;
+}
+
+/// <summary>
+/// Track a synthetic pole with a row profile mode and with the Region profile mode and check that both give the same status,
+/// stripe count and level
+/// </summary>
+/// <param name="regionMode">The region mode of both trackers</param>
+/// <param name="profileMode">The row profile mode to compare</param>
+/// <param name="rotation">Angle in degrees of the rotation of the pole</param>
+/// <param name="stripesAboveWater">The amount of stripes above the water</param>
+/// <returns>1 if the profile modes disagree, otherwise 0</returns>
+static int CheckAgreement(RegionMode regionMode, ProfileMode profileMode, double rotation, double stripesAboveWater) {
+	SyntheticPole pole(Size(1280, 720), rotation, stripesAboveWater);
+	TrackerOptions options;
+	options.regionMode = regionMode;
+	options.profileMode = ProfileMode::Region;
+	WaterLevelTracker reference(options);
+	options.profileMode = profileMode;
+	WaterLevelTracker tracker(options);
+	MarkerProperties marker = pole.CreateMarker();
+	StripeProperties stripes = pole.CreateStripes();
+	WltTrackingResult expected = reference.Measure(pole.GetFrame(), marker, stripes, pole.GetRotation());
+	marker = pole.CreateMarker();
+	stripes = pole.CreateStripes();
+	WltTrackingResult result = tracker.Measure(pole.GetFrame(), marker, stripes, pole.GetRotation());
+	if (result.status != expected.status || result.stripeCount != expected.stripeCount || std::abs(result.level - expected.level) > 1e-9) {
+		std::cerr << "profile mode " << (int)profileMode << " in region mode " << (int)regionMode << " at " << rotation << " degrees with " << stripesAboveWater
+			<< " stripes: " << result.stripeCount << " stripes and level " << result.level << " instead of " << expected.stripeCount << " and " << expected.level << std::endl;
+		return 1;
+	}
+
+	return 0;
+}
+
+int main() {
+	int failures = 0;
+	for (int hint : { -1, 79, 40, 99 }) {
+		failures += CheckBottom("clean", BottomImage(100, 79), hint, 79);
+	}
+
+	// A dark pixel right below the previous bottom, the region grew past it
+	Mat dark = BottomImage(100, 79);
+	dark.at<uchar>(60, 2) = 0;
+	failures += CheckBottom("dark pixel", dark, 59, 79);
+
+	// A noisy row of dark pixels below the previous bottom, shorter than the run of black rows a kept hint needs
+	Mat noisy = BottomImage(100, 79);
+	noisy.rowRange(60, 70).setTo(Scalar(0));
+	failures += CheckBottom("noisy rows", noisy, 59, 79);
+
+	// The region reaches the last row, which no run of black rows can follow
+	failures += CheckBottom("full height", BottomImage(100, 99), 59, 99);
+	failures += CheckBottom("full height hint", BottomImage(100, 99), 99, 99);
+
+	// The region shrank, the previous bottom is black now
+	failures += CheckBottom("shrunk", BottomImage(100, 50), 79, 50);
+	failures += CheckBottom("black", Mat(100, 5, CV_8UC1, Scalar(0)), 79, 100);
+
+	// The row profile modes have to count the same stripes as the Region profile mode on a clean pole
+	for (RegionMode regionMode : { RegionMode::FullFrame, RegionMode::OrientedRegion, RegionMode::FixedCamera }) {
+		for (ProfileMode profileMode : { ProfileMode::RowMean, ProfileMode::RowTrimmedMean }) {
+			for (double rotation : { 0.0, 15.0 }) {
+				for (double stripesAboveWater : { 4.0, 12.0 }) {
+					failures += CheckAgreement(regionMode, profileMode, rotation, stripesAboveWater);
+				}
+			}
+		}
+	}
+
+	if (failures > 0) {
+		std::cerr << failures << " checks of the region and its bottom failed" << std::endl;
+		return 1;
+	}
+
+	std::cout << "Every search found the bottom of the region and the profile modes agree" << std::endl;
+	return 0;
+}
\ No newline at end of file
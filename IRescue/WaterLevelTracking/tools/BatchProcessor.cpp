@@ -0,0 +1,312 @@
+// <copyright file="BatchProcessor.cpp" company="Delft University of Technology">
+// Copyright (c) Delft University of Technology. All rights reserved.
+// </copyright>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+#include "FrameSource.h"
+#include "MarkerRegistry.h"
+#include "TrackerOptions.h"
+#include "WaterLevelTracker.h"
+
+using namespace waterleveltracking;
+
+/// <summary>
+/// The marker, the stripes and the options every frame is processed with
+/// </summary>
+struct BatchConfig {
+	/// <summary>
+	/// The marker corners in the order bottom left, bottom right, top right, top left
+	/// </summary>
+	int corners[8];
+
+	/// <summary>
+	/// The size of the marker in meters
+	/// </summary>
+	double markerSize;
+
+	/// <summary>
+	/// The distance from the center of the marker to the highest stripe in meters
+	/// </summary>
+	double distanceToStripes;
+
+	/// <summary>
+	/// The height of the center of the marker in meters
+	/// </summary>
+	double markerHeight;
+
+	/// <summary>
+	/// The height of a stripe in meters
+	/// </summary>
+	double stripeHeight;
+
+	/// <summary>
+	/// The amount of stripes underneath the marker
+	/// </summary>
+	int stripeCount;
+
+	/// <summary>
+	/// Angle in degrees of the rotation of the marker
+	/// </summary>
+	double rotation;
+
+	/// <summary>
+	/// The options which select how frames are processed
+	/// </summary>
+	TrackerOptions options;
+};
+
+/// <summary>
+/// Read the configuration from a YAML or JSON file of OpenCV
+/// </summary>
+/// <param name="path">The path of the configuration</param>
+/// <param name="config">Receives the configuration</param>
+/// <returns>False if the configuration cannot be read or misses a value</returns>
+static bool ReadConfig(const std::string &path, BatchConfig &config) {
+	FileStorage storage(path, FileStorage::READ);
+	if (!storage.isOpened()) {
+		return false;
+	}
+
+	FileNode corners = storage["corners"];
+	if (!corners.isSeq() || corners.size() != 8 || storage["markerSize"].empty() || storage["distanceToStripes"].empty()
+		|| storage["markerHeight"].empty() || storage["stripeHeight"].empty() || storage["stripeCount"].empty()) {
+		return false;
+	}
+
+	for (int i = 0; i < 8; i++) {
+		config.corners[i] = (int)corners[i];
+	}
+
+	config.markerSize = (double)storage["markerSize"];
+	config.distanceToStripes = (double)storage["distanceToStripes"];
+	config.markerHeight = (double)storage["markerHeight"];
+	config.stripeHeight = (double)storage["stripeHeight"];
+	config.stripeCount = (int)storage["stripeCount"];
+	config.rotation = storage["rotation"].empty() ? 0 : (double)storage["rotation"];
+
+	// The frames of a fixed camera share one marker position, so the resampling table is calculated once per thread
+	config.options.regionMode = RegionMode::FixedCamera;
+	std::string regionMode = storage["regionMode"].empty() ? "" : (std::string)storage["regionMode"];
+	if (regionMode == "FullFrame") {
+		config.options.regionMode = RegionMode::FullFrame;
+	} else if (regionMode == "OrientedRegion") {
+		config.options.regionMode = RegionMode::OrientedRegion;
+	}
+
+	std::string profileMode = storage["profileMode"].empty() ? "" : (std::string)storage["profileMode"];
+	if (profileMode == "RowMean") {
+		config.options.profileMode = ProfileMode::RowMean;
+	} else if (profileMode == "RowTrimmedMean") {
+		config.options.profileMode = ProfileMode::RowTrimmedMean;
+	} else if (profileMode == "BandVote") {
+		config.options.profileMode = ProfileMode::BandVote;
+	}
+
+	if (!storage["minStripePixelHeight"].empty()) {
+		config.options.minStripePixelHeight = (int)storage["minStripePixelHeight"];
+	}
+
+	if (!storage["subPixel"].empty()) {
+		config.options.subPixel = (int)storage["subPixel"] != 0;
+	}
+
+	return true;
+}
+
+/// <summary>
+/// Gets the name of a status for the CSV
+/// </summary>
+/// <param name="status">The status, a WltStatus</param>
+/// <returns>The name of the status</returns>
+static const char *StatusName(int status) {
+	switch (status) {
+	case WLT_STATUS_OK:
+		return "ok";
+	case WLT_STATUS_OUTSIDE_FRAME:
+		return "outside_frame";
+	case WLT_STATUS_IRREGULAR_STRIPES:
+		return "irregular_stripes";
+	case WLT_STATUS_ALL_STRIPES_ABOVE_WATER:
+		return "all_stripes_above_water";
+	case WLT_STATUS_MARKER_NOT_FOUND:
+		return "marker_not_found";
+	default:
+		return "invalid_input";
+	}
+}
+
+/// <summary>
+/// Quote a field for the CSV, doubling the quotes inside it, so file names with commas, quotes or line breaks stay one field
+/// </summary>
+/// <param name="field">The text of the field</param>
+/// <returns>The quoted field</returns>
+static std::string QuoteField(const std::string &field) {
+	std::string quoted = "\"";
+	for (char c : field) {
+		if (c == '"') {
+			quoted += '"';
+		}
+
+		quoted += c;
+	}
+
+	return quoted + '"';
+}
+
+/// <summary>
+/// Print how the tool is used
+/// </summary>
+static void PrintUsage() {
+	std::cerr << "Usage: WaterLevelTrackingBatch <input> <config> [options]" << std::endl
+		<< "  <input>   a directory of images, a .y4m file or a file of raw frames (with --raw)" << std::endl
+		<< "  <config>  a YAML or JSON file with corners, markerSize, distanceToStripes, markerHeight, stripeHeight," << std::endl
+		<< "            stripeCount and optionally rotation, regionMode, profileMode and minStripePixelHeight" << std::endl
+		<< "Options:" << std::endl
+		<< "  --output <path>                   the CSV to write, standard output by default" << std::endl
+		<< "  --threads <count>                 the amount of threads, one per core by default" << std::endl
+		<< "  --raw <width>x<height>:<format>   read raw frames of gray8, rgb24, bgr24, rgba32, bgra32, nv12 or i420" << std::endl
+		<< "  --fps <rate>                      the frame rate of raw frames, to write times instead of indices" << std::endl;
+}
+
+/// <summary>
+/// Calculate the water level of every frame of an image directory or an uncompressed video on every core and write them as CSV
+/// </summary>
+/// <param name="argc">The amount of arguments</param>
+/// <param name="argv">The arguments</param>
+/// <returns>0 on success</returns>
+int main(int argc, char **argv) {
+	if (argc < 3) {
+		PrintUsage();
+		return 1;
+	}
+
+	std::string input = argv[1];
+	std::string output;
+	std::string raw;
+	double framesPerSecond = 0;
+	int threadCount = std::max((int)std::thread::hardware_concurrency(), 1);
+	for (int i = 3; i < argc; i += 2) {
+		std::string option = argv[i];
+		if (i + 1 == argc) {
+			std::cerr << "The option " << option << " needs a value" << std::endl;
+			PrintUsage();
+			return 1;
+		}
+
+		if (option == "--output") {
+			output = argv[i + 1];
+		} else if (option == "--threads") {
+			threadCount = std::max(atoi(argv[i + 1]), 1);
+		} else if (option == "--raw") {
+			raw = argv[i + 1];
+		} else if (option == "--fps") {
+			framesPerSecond = atof(argv[i + 1]);
+		} else {
+			PrintUsage();
+			return 1;
+		}
+	}
+
+	BatchConfig config;
+	if (!ReadConfig(argv[2], config)) {
+		std::cerr << "Cannot read the marker and stripe configuration " << argv[2] << std::endl;
+		return 1;
+	}
+
+	std::unique_ptr<FrameSource> source;
+	if (!raw.empty()) {
+		int width = 0;
+		int height = 0;
+		char format[16] = {};
+		if (sscanf(raw.c_str(), "%dx%d:%15s", &width, &height, format) != 3) {
+			PrintUsage();
+			return 1;
+		}
+
+		VideoFileSource *video = new VideoFileSource(input, Size(width, height), format, framesPerSecond);
+		source.reset(video);
+		if (!video->IsValid()) {
+			std::cerr << "Cannot read the raw frames of " << input << std::endl;
+			return 1;
+		}
+	} else if (input.size() > 4 && input.compare(input.size() - 4, 4, ".y4m") == 0) {
+		VideoFileSource *video = new VideoFileSource(input);
+		source.reset(video);
+		if (!video->IsValid()) {
+			std::cerr << "Cannot read the Y4M video " << input << std::endl;
+			return 1;
+		}
+	} else {
+		source.reset(new ImageDirectorySource(input));
+	}
+
+	// The marker is configured once, the threads only read the registry
+	MarkerRegistry registry;
+	int slot = registry.Register(0, config.markerSize, config.distanceToStripes, config.markerHeight, config.stripeHeight, config.stripeCount);
+	if (slot < 0 || !registry.UpdateCorners(slot, config.corners)) {
+		std::cerr << "The marker and stripe configuration " << argv[2] << " is wrong" << std::endl;
+		return 1;
+	}
+
+	// Every thread takes the next frame when it is done, so slow frames do not hold up the others
+	int frameCount = source->GetCount();
+	config.options.channelOrder = source->GetChannelOrder();
+	std::vector<WltTrackingResult> results(frameCount);
+	std::atomic<int> nextFrame(0);
+	std::atomic<int> failedCount(0);
+	auto start = std::chrono::steady_clock::now();
+	std::vector<std::thread> workers;
+	for (int t = 0; t < threadCount; t++) {
+		workers.push_back(std::thread([&] {
+			WaterLevelTracker tracker(config.options);
+			Mat frame;
+			for (int index = nextFrame++; index < frameCount; index = nextFrame++) {
+				if (!source->Read(index, frame)) {
+					WltTrackingResult unreadable = { WLT_STATUS_INVALID_INPUT, -1, 0, 0 };
+					results[index] = unreadable;
+					failedCount++;
+					continue;
+				}
+
+				MarkerProperties markerProperties = registry.GetMarkerProperties(slot);
+				StripeProperties stripeProperties = registry.GetStripeProperties(slot, markerProperties);
+				results[index] = tracker.Measure(frame, markerProperties, stripeProperties, config.rotation);
+			}
+		}));
+	}
+
+	for (size_t t = 0; t < workers.size(); t++) {
+		workers[t].join();
+	}
+
+	double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+	std::ofstream file;
+	if (!output.empty()) {
+		file.open(output.c_str());
+		if (!file.is_open()) {
+			std::cerr << "Cannot write " << output << std::endl;
+			return 1;
+		}
+	}
+
+	// The status tells why a frame gave no level, a level of -1 means the frame could not be read
+	std::ostream &csv = output.empty() ? std::cout : file;
+	csv << "frame,source,level,status,confidence,stripes" << std::endl;
+	for (int i = 0; i < frameCount; i++) {
+		csv << i << ',' << QuoteField(source->Describe(i)) << ',' << results[i].level << ',' << StatusName(results[i].status) << ',' << results[i].confidence << ',' << results[i].stripeCount << '\n';
+	}
+
+	csv.flush();
+	std::cerr << frameCount << " frames in " << seconds << " s (" << (seconds > 0 ? frameCount / seconds : 0) << " frames/s) on "
+		<< threadCount << " threads, " << failedCount << " frames could not be read" << std::endl;
+	return 0;
+}
\ No newline at end of file
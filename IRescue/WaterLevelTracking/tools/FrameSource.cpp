@@ -0,0 +1,239 @@
+// <copyright file="FrameSource.cpp" company="Delft University of Technology">
+// Copyright (c) Delft University of Technology. All rights reserved.
+// </copyright>
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <iomanip>
+#include <sstream>
+#include "FrameSource.h"
+
+namespace waterleveltracking {
+	/// <summary>
+	/// Initializes a new instance of the <see cref="ImageDirectorySource"/> class with the images in the directory.
+	/// </summary>
+	/// <param name="directory">The directory</param>
+	ImageDirectorySource::ImageDirectorySource(const std::string &directory) {
+		static const char *extensions[] = { ".png", ".jpg", ".jpeg", ".bmp", ".tif", ".tiff", ".pgm", ".ppm" };
+		std::vector<String> files;
+		cv::glob(directory, files, false);
+		for (size_t i = 0; i < files.size(); i++) {
+			std::string path = files[i];
+			std::transform(path.begin(), path.end(), path.begin(), ::tolower);
+			for (size_t e = 0; e < sizeof(extensions) / sizeof(extensions[0]); e++) {
+				size_t length = strlen(extensions[e]);
+				if (path.size() > length && path.compare(path.size() - length, length, extensions[e]) == 0) {
+					this->paths.push_back(files[i]);
+					break;
+				}
+			}
+		}
+
+		std::sort(this->paths.begin(), this->paths.end());
+	}
+
+	/// <summary>
+	/// Decode an image
+	/// </summary>
+	/// <param name="index">The index of the image</param>
+	/// <param name="frame">Receives the decoded image</param>
+	/// <returns>False if the image cannot be decoded</returns>
+	bool ImageDirectorySource::Read(int index, Mat &frame) {
+		if (index < 0 || index >= (int)this->paths.size()) {
+			return false;
+		}
+
+		frame = imread(this->paths[index], IMREAD_COLOR);
+		return !frame.empty();
+	}
+
+	/// <summary>
+	/// Describe an image by its file name
+	/// </summary>
+	/// <param name="index">The index of the image</param>
+	/// <returns>The file name</returns>
+	std::string ImageDirectorySource::Describe(int index) {
+		std::string path = this->paths[index];
+		size_t slash = path.find_last_of("/\\");
+		return slash == std::string::npos ? path : path.substr(slash + 1);
+	}
+
+	/// <summary>
+	/// Gets the amount of images
+	/// </summary>
+	int ImageDirectorySource::GetCount() {
+		return (int)this->paths.size();
+	}
+
+	/// <summary>
+	/// Gets the order of the color channels, decoded images are blue first
+	/// </summary>
+	ChannelOrder ImageDirectorySource::GetChannelOrder() {
+		return ChannelOrder::Bgr;
+	}
+
+	/// <summary>
+	/// Initializes a new instance of the <see cref="VideoFileSource"/> class for a Y4M file.
+	/// </summary>
+	/// <param name="path">The path of the file</param>
+	VideoFileSource::VideoFileSource(const std::string &path)
+		: type(CV_8UC1), channelOrder(ChannelOrder::Rgb), framesPerSecond(0) {
+		this->valid = this->file.Open(path) && this->ParseY4m();
+	}
+
+	/// <summary>
+	/// Initializes a new instance of the <see cref="VideoFileSource"/> class for a file of headerless frames.
+	/// </summary>
+	/// <param name="path">The path of the file</param>
+	/// <param name="frameSize">The size of the frames in pixels</param>
+	/// <param name="pixelFormat">The layout of the frames: gray8, rgb24, bgr24, rgba32, bgra32, nv12 or i420</param>
+	/// <param name="framesPerSecond">The frame rate to describe the frames with, 0 if unknown</param>
+	VideoFileSource::VideoFileSource(const std::string &path, Size frameSize, const std::string &pixelFormat, double framesPerSecond)
+		: frameSize(frameSize), type(CV_8UC1), channelOrder(ChannelOrder::Rgb), framesPerSecond(framesPerSecond) {
+		uint64_t pixels = (uint64_t)frameSize.width * frameSize.height;
+		uint64_t bytes = 0;
+		if (pixelFormat == "gray8") {
+			bytes = pixels;
+		} else if (pixelFormat == "nv12" || pixelFormat == "i420") {
+			bytes = pixels + 2 * (((uint64_t)frameSize.width + 1) / 2) * ((frameSize.height + 1) / 2);
+		} else if (pixelFormat == "rgb24" || pixelFormat == "bgr24") {
+			bytes = pixels * 3;
+			this->type = CV_8UC3;
+		} else if (pixelFormat == "rgba32" || pixelFormat == "bgra32") {
+			bytes = pixels * 4;
+			this->type = CV_8UC4;
+		}
+
+		if (pixelFormat[0] == 'b') {
+			this->channelOrder = ChannelOrder::Bgr;
+		}
+
+		this->valid = bytes > 0 && this->file.Open(path);
+		for (uint64_t offset = 0; this->valid && offset + bytes <= this->file.GetSize(); offset += bytes) {
+			this->offsets.push_back(offset);
+		}
+	}
+
+	/// <summary>
+	/// Wrap a frame of the mapped file
+	/// </summary>
+	/// <param name="index">The index of the frame</param>
+	/// <param name="frame">Receives the frame</param>
+	/// <returns>False if the index is out of range</returns>
+	bool VideoFileSource::Read(int index, Mat &frame) {
+		if (index < 0 || index >= (int)this->offsets.size()) {
+			return false;
+		}
+
+		// The mapping is read only, the tracker never writes to the frames it is handed
+		frame = Mat(this->frameSize, this->type, (void*)(this->file.GetData() + this->offsets[index]));
+		return true;
+	}
+
+	/// <summary>
+	/// Describe a frame by its time in seconds, or by its index if the frame rate is unknown
+	/// </summary>
+	/// <param name="index">The index of the frame</param>
+	/// <returns>The description</returns>
+	std::string VideoFileSource::Describe(int index) {
+		std::ostringstream description;
+		if (this->framesPerSecond > 0) {
+			description << std::fixed << std::setprecision(3) << index / this->framesPerSecond;
+		} else {
+			description << index;
+		}
+
+		return description.str();
+	}
+
+	/// <summary>
+	/// Gets the amount of frames
+	/// </summary>
+	int VideoFileSource::GetCount() {
+		return (int)this->offsets.size();
+	}
+
+	/// <summary>
+	/// Gets the order of the color channels
+	/// </summary>
+	ChannelOrder VideoFileSource::GetChannelOrder() {
+		return this->channelOrder;
+	}
+
+	/// <summary>
+	/// Gets whether the file could be mapped and its layout is understood
+	/// </summary>
+	bool VideoFileSource::IsValid() {
+		return this->valid;
+	}
+
+	/// <summary>
+	/// Find the frames of the mapped Y4M file
+	/// </summary>
+	/// <returns>False if the header is not understood</returns>
+	bool VideoFileSource::ParseY4m() {
+		const char *data = (const char*)this->file.GetData();
+		uint64_t size = this->file.GetSize();
+		const char *end = (const char*)memchr(data, '\n', (size_t)std::min<uint64_t>(size, 4096));
+		if (end == nullptr || size < 10 || memcmp(data, "YUV4MPEG2 ", 10) != 0) {
+			return false;
+		}
+
+		// The header is a list of tagged parameters, only the size, the frame rate and the chroma layout matter here
+		std::istringstream header(std::string(data + 10, end));
+		std::string parameter;
+		std::string chroma = "420";
+		while (header >> parameter) {
+			if (parameter[0] == 'W') {
+				this->frameSize.width = atoi(parameter.c_str() + 1);
+			} else if (parameter[0] == 'H') {
+				this->frameSize.height = atoi(parameter.c_str() + 1);
+			} else if (parameter[0] == 'F') {
+				int numerator = 0;
+				int denominator = 0;
+				if (sscanf(parameter.c_str() + 1, "%d:%d", &numerator, &denominator) == 2 && denominator > 0) {
+					this->framesPerSecond = (double)numerator / denominator;
+				}
+			} else if (parameter[0] == 'C') {
+				chroma = parameter.substr(1);
+			}
+		}
+
+		uint64_t pixels = (uint64_t)this->frameSize.width * this->frameSize.height;
+		uint64_t chromaWidth = ((uint64_t)this->frameSize.width + 1) / 2;
+		uint64_t chromaHeight = ((uint64_t)this->frameSize.height + 1) / 2;
+		// Only the 8 bit tags, high bit depth tags like 420p10 or mono16 store two bytes per sample
+		uint64_t bytes;
+		if (chroma == "mono") {
+			bytes = pixels;
+		} else if (chroma == "420" || chroma == "420jpeg" || chroma == "420paldv" || chroma == "420mpeg2") {
+			bytes = pixels + 2 * chromaWidth * chromaHeight;
+		} else if (chroma == "422") {
+			bytes = pixels + 2 * chromaWidth * this->frameSize.height;
+		} else if (chroma == "444") {
+			bytes = pixels * 3;
+		} else {
+			return false;
+		}
+
+		if (pixels == 0) {
+			return false;
+		}
+
+		// Every frame starts with a FRAME line which may carry parameters of its own
+		uint64_t offset = end - data + 1;
+		while (offset + 5 < size && memcmp(data + offset, "FRAME", 5) == 0) {
+			const char *line = (const char*)memchr(data + offset, '\n', (size_t)(size - offset));
+			if (line == nullptr || (uint64_t)(line - data) + 1 + bytes > size) {
+				break;
+			}
+
+			this->offsets.push_back(line - data + 1);
+			offset = line - data + 1 + bytes;
+		}
+
+		return true;
+	}
+}
\ No newline at end of file
@@ -0,0 +1,192 @@
+// <copyright file="FrameSource.h" company="Delft University of Technology">
+// Copyright (c) Delft University of Technology. All rights reserved.
+// </copyright>
+
+#ifndef __FRAMESOURCE_H__
+#define __FRAMESOURCE_H__
+
+#include <string>
+#include <vector>
+#include <opencv2/opencv.hpp>
+#include "MappedFile.h"
+#include "TrackerOptions.h"
+
+using namespace cv;
+
+namespace waterleveltracking {
+	/// <summary>
+	/// Frames which can be read in any order from any thread
+	/// </summary>
+	class FrameSource {
+	public:
+		/// <summary>
+		/// Releases the frames.
+		/// </summary>
+		virtual ~FrameSource() {
+		}
+
+		/// <summary>
+		/// Read a frame, may be called from several threads at once
+		/// </summary>
+		/// <param name="index">The index of the frame</param>
+		/// <param name="frame">Receives the frame, which may point straight into the source and must not be written to</param>
+		/// <returns>False if the frame cannot be read</returns>
+		virtual bool Read(int index, Mat &frame) = 0;
+
+		/// <summary>
+		/// Describe a frame for the output, its file name or its time in seconds
+		/// </summary>
+		/// <param name="index">The index of the frame</param>
+		/// <returns>The description</returns>
+		virtual std::string Describe(int index) = 0;
+
+		/// <summary>
+		/// Gets the amount of frames
+		/// </summary>
+		virtual int GetCount() = 0;
+
+		/// <summary>
+		/// Gets the order of the color channels of color frames
+		/// </summary>
+		virtual ChannelOrder GetChannelOrder() = 0;
+	};
+
+	/// <summary>
+	/// The images in a directory in the order of their file names, decoded when they are read
+	/// </summary>
+	class ImageDirectorySource : public FrameSource {
+	public:
+		/// <summary>
+		/// Initializes a new instance of the <see cref="ImageDirectorySource"/> class with the images in the directory.
+		/// </summary>
+		/// <param name="directory">The directory</param>
+		ImageDirectorySource(const std::string &directory);
+
+		/// <summary>
+		/// Decode an image
+		/// </summary>
+		/// <param name="index">The index of the image</param>
+		/// <param name="frame">Receives the decoded image</param>
+		/// <returns>False if the image cannot be decoded</returns>
+		bool Read(int index, Mat &frame) override;
+
+		/// <summary>
+		/// Describe an image by its file name
+		/// </summary>
+		/// <param name="index">The index of the image</param>
+		/// <returns>The file name</returns>
+		std::string Describe(int index) override;
+
+		/// <summary>
+		/// Gets the amount of images
+		/// </summary>
+		int GetCount() override;
+
+		/// <summary>
+		/// Gets the order of the color channels, decoded images are blue first
+		/// </summary>
+		ChannelOrder GetChannelOrder() override;
+
+	private:
+		/// <summary>
+		/// The paths of the images
+		/// </summary>
+		std::vector<String> paths;
+	};
+
+	/// <summary>
+	/// The frames of an uncompressed video file, a Y4M file or headerless raw frames, read through a memory mapping without copying them.
+	/// YUV frames are read through their Y plane only.
+	/// </summary>
+	class VideoFileSource : public FrameSource {
+	public:
+		/// <summary>
+		/// Initializes a new instance of the <see cref="VideoFileSource"/> class for a Y4M file.
+		/// </summary>
+		/// <param name="path">The path of the file</param>
+		VideoFileSource(const std::string &path);
+
+		/// <summary>
+		/// Initializes a new instance of the <see cref="VideoFileSource"/> class for a file of headerless frames.
+		/// </summary>
+		/// <param name="path">The path of the file</param>
+		/// <param name="frameSize">The size of the frames in pixels</param>
+		/// <param name="pixelFormat">The layout of the frames: gray8, rgb24, bgr24, rgba32, bgra32, nv12 or i420</param>
+		/// <param name="framesPerSecond">The frame rate to describe the frames with, 0 if unknown</param>
+		VideoFileSource(const std::string &path, Size frameSize, const std::string &pixelFormat, double framesPerSecond);
+
+		/// <summary>
+		/// Wrap a frame of the mapped file
+		/// </summary>
+		/// <param name="index">The index of the frame</param>
+		/// <param name="frame">Receives the frame</param>
+		/// <returns>False if the index is out of range</returns>
+		bool Read(int index, Mat &frame) override;
+
+		/// <summary>
+		/// Describe a frame by its time in seconds, or by its index if the frame rate is unknown
+		/// </summary>
+		/// <param name="index">The index of the frame</param>
+		/// <returns>The description</returns>
+		std::string Describe(int index) override;
+
+		/// <summary>
+		/// Gets the amount of frames
+		/// </summary>
+		int GetCount() override;
+
+		/// <summary>
+		/// Gets the order of the color channels
+		/// </summary>
+		ChannelOrder GetChannelOrder() override;
+
+		/// <summary>
+		/// Gets whether the file could be mapped and its layout is understood
+		/// </summary>
+		bool IsValid();
+
+	private:
+		/// <summary>
+		/// The mapped file
+		/// </summary>
+		MappedFile file;
+
+		/// <summary>
+		/// The offset of the first byte of every frame
+		/// </summary>
+		std::vector<uint64_t> offsets;
+
+		/// <summary>
+		/// The size of the frames in pixels
+		/// </summary>
+		Size frameSize;
+
+		/// <summary>
+		/// The OpenCV type of the frames as they are handed out
+		/// </summary>
+		int type;
+
+		/// <summary>
+		/// The order of the color channels
+		/// </summary>
+		ChannelOrder channelOrder;
+
+		/// <summary>
+		/// The frame rate, 0 if unknown
+		/// </summary>
+		double framesPerSecond;
+
+		/// <summary>
+		/// Gets whether the layout is understood
+		/// </summary>
+		bool valid;
+
+		/// <summary>
+		/// Find the frames of the mapped Y4M file
+		/// </summary>
+		/// <returns>False if the header is not understood</returns>
+		bool ParseY4m();
+	};
+}
+
+#endif
\ No newline at end of file